@@ -0,0 +1,628 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Implements the FrameworkBenchmark suite.
+ *
+ * Fixtures here mirror the production dispatch paths without touching hardware or the network,
+ * so results measure framework overhead only.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Benchmark.h"
+#include "Device.h"
+#include "Sensor.h"
+#include "Actuator.h"
+#include "StaticRouter.h"
+#include "EventBus.h"
+#include "GpsSensor.h"
+#include "RfidSensor.h"
+#include "CommunicationHandler.h"
+#include "Metrics.h"
+#include "DeflateEncoder.h"
+#include "SyntheticRoute.h"
+#include "SessionReplay.h"
+#include "Clock.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifndef ESP32
+#include "SocketTransport.h"
+#include "SocketClient.h"
+#include "MqttTransport.h"
+#include "CiaSteelFaucet.h"
+#include <algorithm>
+#endif
+
+static const uint32_t DISPATCH_ITERATIONS = 20000;
+static const uint32_t PAYLOAD_ITERATIONS = 2000;
+static const uint32_t COMPRESSION_TRACE_RECORDS = 512;
+static const int NMEA_ROUNDS_PER_UPDATE = 2; ///< Passes over BENCHMARK_NMEA fed per GpsSensor::update() (fits ReplayStream).
+
+static volatile uint32_t benchmarkSink; ///< Keeps results observable so loops are not optimized away.
+
+static const char *const BENCHMARK_NMEA[] = {
+    "$GPGGA,172914.049,2327.985,S,05150.410,W,1,12,1.0,0.0,M,0.0,M,,*60\r\n",
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
+    "$GPRMC,172914.049,A,2327.985,S,05150.410,W,009.7,025.9,060622,000.0,W*74\r\n",
+    "$GPGGA,172915.049,2327.982,S,05150.409,W,1,12,1.0,0.0,M,0.0,M,,*6E\r\n",
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
+    "$GPRMC,172915.049,A,2327.982,S,05150.409,W,009.7,025.9,060622,000.0,W*7A\r\n",
+};
+static const int BENCHMARK_NMEA_COUNT = sizeof(BENCHMARK_NMEA) / sizeof(BENCHMARK_NMEA[0]);
+
+/**
+ * @brief Device dispatching through an if/else chain, as before StaticRouter.
+ */
+class ChainDevice : public Device
+{
+public:
+    uint32_t handled = 0;
+
+    void on(Event event) override
+    {
+        if (event == GpsSensor::GPS_DATA_EVENT)
+        {
+            handled += event.payloadSize;
+        }
+        else if (event == RfidSensor::RFID_DETECTED_EVENT)
+        {
+            handled += 1;
+        }
+    }
+
+    void handle(Command command) override
+    {
+        if (command.id == CommunicationHandler::CONNECT_WIFI_COMMAND_ID)
+        {
+            handled += 2;
+        }
+        else if (command.id == 0 || command.id == 1 || command.id == 2)
+        {
+            handled += 1;
+        }
+    }
+};
+
+/**
+ * @brief Device dispatching through StaticRouter, as TrackingDevice does.
+ */
+class RoutedDevice : public Device
+{
+public:
+    uint32_t handled = 0;
+
+    void onGps(const Event &event) { handled += event.payloadSize; }
+    void onRfid(const Event &) { handled += 1; }
+    void onWifi(const Command &) { handled += 2; }
+    void onLed(const Command &) { handled += 1; }
+
+    using EventRoutes = StaticRouter<
+        Route<GpsSensor::GPS_DATA_EVENT_ID, &RoutedDevice::onGps>,
+        Route<RfidSensor::RFID_DETECTED_EVENT_ID, &RoutedDevice::onRfid>>;
+    using CommandRoutes = StaticRouter<
+        Route<CommunicationHandler::CONNECT_WIFI_COMMAND_ID, &RoutedDevice::onWifi>,
+        Route<0, &RoutedDevice::onLed>,
+        Route<1, &RoutedDevice::onLed>,
+        Route<2, &RoutedDevice::onLed>>;
+
+    void on(Event event) override
+    {
+        EventRoutes::dispatch(*this, event);
+    }
+
+    void handle(Command command) override
+    {
+        CommandRoutes::dispatch(*this, command);
+    }
+};
+
+/**
+ * @brief Subscriber that only counts deliveries.
+ */
+class CountingHandler : public EventHandler
+{
+public:
+    uint32_t received = 0;
+
+    void on(Event) override { received++; }
+};
+
+static Event makeGpsEvent()
+{
+    GpsData data;
+    data.latitude = -23.466417;
+    data.longitude = -51.840683;
+    data.isValid = true;
+    strncpy(data.timestamp, "2025-03-22T10:30:00Z", sizeof(data.timestamp));
+    return Event(GpsSensor::GPS_DATA_EVENT_ID, data, 0);
+}
+
+static RfidData makeRfidData()
+{
+    RfidData data;
+    strncpy(data.rfidCode, "XX01X", sizeof(data.rfidCode));
+    strncpy(data.scanType, "ENTRY", sizeof(data.scanType));
+    data.isValid = true;
+    data.allowed = true;
+    return data;
+}
+
+void FrameworkBenchmark::report(Print &out, const char *name, uint32_t iterations, uint32_t elapsedUs,
+                                uint32_t bytesPerOp)
+{
+    double elapsed = elapsedUs > 0 ? elapsedUs : 1;
+    double nsPerOp = elapsed * 1000.0 / iterations;
+    double opsPerSecond = iterations * 1000000.0 / elapsed;
+    char line[192];
+    int length = snprintf(line, sizeof(line), "{\"bench\":\"%s\",\"iter\":%lu,\"ns_per_op\":%.1f,\"ops_per_s\":%.0f",
+                          name, static_cast<unsigned long>(iterations), nsPerOp, opsPerSecond);
+    if (bytesPerOp > 0 && length > 0 && static_cast<size_t>(length) < sizeof(line))
+    {
+        snprintf(line + length, sizeof(line) - length, ",\"mb_per_s\":%.3f",
+                 static_cast<double>(bytesPerOp) * iterations / elapsed);
+    }
+    out.print(line);
+    out.println("}");
+}
+
+static void benchmarkEventDispatch(Print &out)
+{
+    Event event = makeGpsEvent();
+
+    ChainDevice chainDevice;
+    Sensor chainSensor(-1, &chainDevice);
+    unsigned long startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        chainSensor.on(event);
+    }
+    FrameworkBenchmark::report(out, "event.sensor_to_device.chain", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = chainDevice.handled;
+
+    RoutedDevice routedDevice;
+    Sensor routedSensor(-1, &routedDevice);
+    startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        routedSensor.on(event);
+    }
+    FrameworkBenchmark::report(out, "event.sensor_to_device.router", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = routedDevice.handled;
+
+    // Statically composed: the router called on the concrete device, with no virtual hop. The
+    // event is read through a volatile pointer so the loop cannot be folded into one addition
+    RoutedDevice staticDevice;
+    const Event *volatile staticEvent = &event;
+    startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        RoutedDevice::EventRoutes::dispatch(staticDevice, *staticEvent);
+    }
+    FrameworkBenchmark::report(out, "event.static_router", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = staticDevice.handled;
+
+    EventBus<4> bus;
+    CountingHandler uploader, geofence, logger;
+    bus.subscribe(&uploader, EventBus<4>::topic(GpsSensor::GPS_DATA_EVENT_ID));
+    bus.subscribe(&geofence, EventBus<4>::topic(GpsSensor::GPS_DATA_EVENT_ID));
+    bus.subscribe(&logger, EventBus<4>::topic(GpsSensor::GPS_DATA_EVENT_ID));
+    Sensor busSensor(-1, &bus);
+    startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        busSensor.on(event);
+    }
+    FrameworkBenchmark::report(out, "event.bus_3_subscribers", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = uploader.received + geofence.received + logger.received;
+}
+
+static void benchmarkCommandDispatch(Print &out)
+{
+    Command command(1);
+
+    ChainDevice chainDevice;
+    Actuator chainActuator(-1, &chainDevice);
+    unsigned long startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        chainActuator.handle(command);
+    }
+    FrameworkBenchmark::report(out, "command.actuator_to_device.chain", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = chainDevice.handled;
+
+    RoutedDevice routedDevice;
+    Actuator routedActuator(-1, &routedDevice);
+    startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        routedActuator.handle(command);
+    }
+    FrameworkBenchmark::report(out, "command.actuator_to_device.router", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = routedDevice.handled;
+
+    RoutedDevice staticDevice;
+    const Command *volatile staticCommand = &command;
+    startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        RoutedDevice::CommandRoutes::dispatch(staticDevice, *staticCommand);
+    }
+    FrameworkBenchmark::report(out, "command.static_router", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = staticDevice.handled;
+}
+
+static void benchmarkNmeaDecoding(Print &out)
+{
+    TinyGPSPlus gps;
+    uint32_t bytes = 0;
+    unsigned long startedAt = micros();
+    for (uint32_t i = 0; i < PAYLOAD_ITERATIONS; i++)
+    {
+        for (const char *c = BENCHMARK_NMEA[i % BENCHMARK_NMEA_COUNT]; *c != '\0'; c++)
+        {
+            gps.encode(*c);
+            bytes++;
+        }
+    }
+    unsigned long elapsed = micros() - startedAt;
+    FrameworkBenchmark::report(out, "nmea.decode_sentence", PAYLOAD_ITERATIONS, elapsed, bytes / PAYLOAD_ITERATIONS);
+    benchmarkSink = gps.passedChecksum();
+
+    // The path the device runs: GpsSensor::update() reading a Stream and publishing the fix.
+    // Only the update is timed; the stream is filled beforehand
+    VirtualClock clock;
+    CountingHandler fixes;
+    GpsSensor sensor(-1, -1, 0, &fixes, clock);
+    ReplayStream input;
+    sensor.setInput(&input);
+    uint32_t sentences = 0;
+    bytes = 0;
+    elapsed = 0;
+    while (sentences < PAYLOAD_ITERATIONS)
+    {
+        for (int round = 0; round < NMEA_ROUNDS_PER_UPDATE; round++)
+        {
+            for (int i = 0; i < BENCHMARK_NMEA_COUNT; i++)
+            {
+                bytes += input.print(BENCHMARK_NMEA[i]);
+                sentences++;
+            }
+        }
+        clock.advanceUs(1000000);
+        startedAt = micros();
+        sensor.update();
+        elapsed += micros() - startedAt;
+    }
+    FrameworkBenchmark::report(out, "nmea.gps_sensor_update", sentences, elapsed, bytes / sentences);
+    benchmarkSink = fixes.received;
+#ifndef ESP32
+    out.println("{\"bench\":\"nmea.note\",\"note\":\"host build: TinyGPSPlus is the stand-in from host/stubs, "
+                "not the parser the device runs\"}");
+#endif
+}
+
+static void benchmarkPayloads(Print &out)
+{
+    // Static: the handler's upload buffers are too large for the setup() stack
+    static CommunicationHandler handler("ssid", "password", "http://localhost/tracking",
+                                        "http://localhost/scans", "HC2956");
+    GpsData gpsData;
+    makeGpsEvent().getPayload(gpsData);
+    RfidData rfidData = makeRfidData();
+    char buffer[GPS_PAYLOAD_SIZE];
+
+    size_t length = 0;
+    unsigned long startedAt = micros();
+    for (uint32_t i = 0; i < PAYLOAD_ITERATIONS; i++)
+    {
+        length = handler.buildGpsPayload(gpsData, buffer, sizeof(buffer));
+    }
+    FrameworkBenchmark::report(out, "json.gps_payload", PAYLOAD_ITERATIONS, micros() - startedAt, length);
+
+    startedAt = micros();
+    for (uint32_t i = 0; i < PAYLOAD_ITERATIONS; i++)
+    {
+        length = handler.buildRfidPayload(rfidData, buffer, sizeof(buffer));
+    }
+    FrameworkBenchmark::report(out, "json.rfid_payload", PAYLOAD_ITERATIONS, micros() - startedAt, length);
+    benchmarkSink = length;
+}
+
+static void benchmarkRfidCodes(Print &out)
+{
+    CountingHandler sink;
+    RfidSensor rfid(-1, 0, &sink);
+    rfid.addRfidCode("XX01X");
+    rfid.addRfidCode("YY02Y");
+    rfid.addRfidCode("ZZ03Z");
+    unsigned long startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        rfid.simulateScan();
+    }
+    FrameworkBenchmark::report(out, "rfid.scan_to_event", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = sink.received;
+}
+
+static void benchmarkPrimitives(Print &out)
+{
+    Event event = makeGpsEvent();
+    BoundedQueue<Event, 8> queue;
+    unsigned long startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        queue.push(event);
+        queue.pop(event);
+    }
+    FrameworkBenchmark::report(out, "queue.event_push_pop", DISPATCH_ITERATIONS, micros() - startedAt);
+
+    Histogram histogram;
+    startedAt = micros();
+    for (uint32_t i = 0; i < DISPATCH_ITERATIONS; i++)
+    {
+        histogram.record(i);
+    }
+    FrameworkBenchmark::report(out, "metrics.histogram_record", DISPATCH_ITERATIONS, micros() - startedAt);
+    benchmarkSink = histogram.samples();
+}
+
+/**
+ * @brief Fills the next fix of a simulated trace, one second after the previous one.
+ */
+static void nextTraceFix(VirtualClock &clock, SyntheticRoute &route, GpsData &fix)
+{
+    clock.sleepMs(1000);
+    while (route.available() > 0)
+    {
+        route.read();
+    }
+    fix.latitude = route.getLatitude();
+    fix.longitude = route.getLongitude();
+    fix.isValid = true;
+    time_t now = clock.wallTime();
+    struct tm timeinfo;
+    gmtime_r(&now, &timeinfo);
+    strftime(fix.timestamp, sizeof(fix.timestamp), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
+}
+
+void FrameworkBenchmark::compareCompression(Print &out)
+{
+    // Static: the handler, encoder and buffers are too large for the setup() stack
+    static CommunicationHandler handler("ssid", "password", "http://localhost/tracking",
+                                        "http://localhost/scans", "HC2956");
+    static DeflateEncoder encoder;
+    static char body[UPLOAD_BODY_SIZE];
+    static uint8_t packed[UPLOAD_BODY_SIZE];
+    static const uint8_t BATCH_SIZES[] = {1, 2, 4, 8};
+
+    for (uint8_t batchSize : BATCH_SIZES)
+    {
+        // Every batch size compresses the same trace
+        VirtualClock clock;
+        SyntheticRoute route(clock, -12.046374, -77.042793, 10.0, 7);
+        GpsData batch[GPS_BATCH_MAX_RECORDS];
+        uint32_t bodies = 0;
+        uint32_t rawBytes = 0;
+        uint32_t packedBytes = 0;
+        uint32_t elapsedUs = 0;
+
+        for (uint32_t record = 0; record < COMPRESSION_TRACE_RECORDS; record += batchSize)
+        {
+            for (uint8_t i = 0; i < batchSize; i++)
+            {
+                nextTraceFix(clock, route, batch[i]);
+            }
+            size_t length = batchSize == 1 ? handler.buildGpsPayload(batch[0], body, sizeof(body))
+                                           : handler.buildGpsBatch(batch, batchSize, body, sizeof(body));
+
+            unsigned long startedAt = micros();
+            encoder.begin(packed, sizeof(packed));
+            encoder.write(body, length);
+            size_t packedLength = encoder.finish();
+            elapsedUs += micros() - startedAt;
+
+            bodies++;
+            rawBytes += length;
+            packedBytes += packedLength > 0 ? packedLength : length;
+        }
+
+        char line[192];
+        snprintf(line, sizeof(line),
+                 "{\"bench\":\"deflate.batch%u\",\"bodies\":%lu,\"raw_bytes\":%lu,\"compressed_bytes\":%lu,"
+                 "\"ratio\":%.2f,\"us_per_kb\":%.1f}",
+                 batchSize, static_cast<unsigned long>(bodies), static_cast<unsigned long>(rawBytes),
+                 static_cast<unsigned long>(packedBytes),
+                 packedBytes > 0 ? static_cast<double>(rawBytes) / packedBytes : 0.0,
+                 rawBytes > 0 ? elapsedUs * 1024.0 / rawBytes : 0.0);
+        out.println(line);
+    }
+}
+
+void FrameworkBenchmark::runAll(Print &out)
+{
+    benchmarkEventDispatch(out);
+    benchmarkCommandDispatch(out);
+    benchmarkNmeaDecoding(out);
+    benchmarkPayloads(out);
+    benchmarkRfidCodes(out);
+    benchmarkPrimitives(out);
+    compareCompression(out);
+}
+
+#ifndef ESP32
+/**
+ * @brief Posts `records` GPS payloads and prints throughput and wire bytes per record.
+ * `settle` waits for outstanding acknowledgements and returns the transport's wire byte count;
+ * it runs before the clock stops, so pipelined transports are timed until their last ack.
+ */
+static void benchmarkUplink(Print &out, const char *name, Transport &transport, const char *url,
+                            uint32_t records, uint32_t (*settle)(Transport &))
+{
+    static CommunicationHandler handler("ssid", "password", url, url, "HC2956");
+    GpsData gpsData;
+    makeGpsEvent().getPayload(gpsData);
+    char payload[GPS_PAYLOAD_SIZE];
+    char response[RESPONSE_BUFFER_SIZE];
+    uint32_t errors = 0;
+    uint32_t bytesBefore = settle(transport);
+
+    uint64_t startedAt = SystemClock::instance().nowUs();
+    for (uint32_t i = 0; i < records; i++)
+    {
+        size_t length = handler.buildGpsPayload(gpsData, payload, sizeof(payload));
+        TransportRequest request(url, "application/json", payload, length);
+        int status = transport.post(request, response, sizeof(response));
+        if (status < 200 || status >= 300)
+        {
+            errors++;
+        }
+    }
+    uint32_t bytes = settle(transport) - bytesBefore;
+    double elapsedUs = static_cast<double>(SystemClock::instance().nowUs() - startedAt);
+
+    char line[192];
+    snprintf(line, sizeof(line),
+             "{\"bench\":\"uplink.%s\",\"records\":%lu,\"msgs_per_s\":%.0f,\"bytes_per_record\":%.1f,\"errors\":%lu}",
+             name, static_cast<unsigned long>(records), records * 1000000.0 / (elapsedUs > 0 ? elapsedUs : 1),
+             records > 0 ? static_cast<double>(bytes) / records : 0.0,
+             static_cast<unsigned long>(errors));
+    out.println(line);
+}
+
+void FrameworkBenchmark::compareUplinks(Print &out, const char *httpUrl, const char *brokerHost,
+                                        uint16_t brokerPort, uint32_t records)
+{
+    SocketTransport http;
+    benchmarkUplink(out, "http", http, httpUrl, records,
+                    [](Transport &transport) { return static_cast<SocketTransport &>(transport).bytesOnWire(); });
+
+    for (uint8_t qos = 0; qos <= 1; qos++)
+    {
+        SocketClient client;
+        MqttTransport mqtt(client, brokerHost, brokerPort, "HC2956-bench", qos);
+        if (!mqtt.connect("", ""))
+        {
+            out.println("{\"bench\":\"uplink.mqtt\",\"error\":\"broker unreachable\"}");
+            return;
+        }
+        benchmarkUplink(out, qos == 0 ? "mqtt_qos0" : "mqtt_qos1", mqtt, httpUrl, records,
+                        [](Transport &transport) {
+                            static_cast<MqttTransport &>(transport).flush();
+                            return static_cast<MqttTransport &>(transport).bytesOnWire();
+                        });
+        mqtt.disconnect();
+    }
+}
+
+static const uint32_t FAUCET_MAX_TRIALS = 1000;
+static const float FAUCET_BASIN_CM = 60; ///< Echo of the empty basin.
+static const float FAUCET_HAND_CM = 8;   ///< Echo of a hand under the spout.
+
+/**
+ * @brief A CiaSteelFaucet on a virtual clock, its control loop run at every timer tick.
+ */
+struct FaucetSimulation
+{
+    VirtualClock clock;
+    CiaSteelFaucet faucet;
+    uint64_t nowUs = 0;
+    uint64_t nextTickUs = 0;
+
+    FaucetSimulation() : faucet(-1, -1, -1, false, clock) {}
+
+    void runUntil(uint64_t targetUs)
+    {
+        while (nextTickUs <= targetUs)
+        {
+            clock.advanceUs(nextTickUs - nowUs);
+            nowUs = nextTickUs;
+            faucet.step();
+            nextTickUs += FAUCET_CONTROL_PERIOD_MS * 1000ULL;
+        }
+        clock.advanceUs(targetUs - nowUs);
+        nowUs = targetUs;
+    }
+};
+
+bool FrameworkBenchmark::measureFaucetLatency(Print &out, uint32_t trials)
+{
+    static uint32_t latencies[FAUCET_MAX_TRIALS];
+    static FaucetSimulation simulation;
+    trials = std::min(std::max(trials, 1u), FAUCET_MAX_TRIALS);
+
+    UltrasoundSensor &hand = simulation.faucet.getHandSensor();
+    hand.setSimulatedDistance(FAUCET_BASIN_CM);
+    uint32_t phase = 12345; // xorshift state: arrivals must not line up with the pings
+
+    uint32_t quickMaximum = 0;
+    for (uint32_t trial = 0; trial < trials; trial++)
+    {
+        phase ^= phase << 13;
+        phase ^= phase >> 17;
+        phase ^= phase << 5;
+        bool quickReturn = trial % 2 == 1;
+        uint64_t arrivalUs;
+        if (quickReturn)
+        {
+            // The hand comes back within the valve's switching interval of it closing
+            while (simulation.faucet.isFlowing())
+            {
+                simulation.runUntil(simulation.nextTickUs);
+            }
+            arrivalUs = simulation.nowUs + phase % (FAUCET_VALVE_MIN_SWITCH_MS * 1000);
+        }
+        else
+        {
+            // Long enough for the valve to close and its switching interval to pass
+            simulation.runUntil(simulation.nowUs + 1000000);
+            arrivalUs = simulation.nowUs + phase % (FAUCET_SAMPLE_PERIOD_MS * 1000);
+        }
+        simulation.runUntil(arrivalUs);
+        hand.setSimulatedDistance(FAUCET_HAND_CM);
+
+        uint64_t giveUpUs = arrivalUs + 1000000;
+        while (!simulation.faucet.isFlowing() && simulation.nextTickUs <= giveUpUs)
+        {
+            simulation.runUntil(simulation.nextTickUs);
+        }
+        uint32_t openedUs = simulation.faucet.isFlowing() ? simulation.faucet.getValve().getLastSwitchUs()
+                                                          : static_cast<uint32_t>(giveUpUs);
+        latencies[trial] = openedUs - static_cast<uint32_t>(arrivalUs);
+        if (quickReturn)
+        {
+            quickMaximum = std::max(quickMaximum, latencies[trial]);
+        }
+
+        // Wash, then take the hand away
+        simulation.runUntil(arrivalUs + 500000);
+        hand.setSimulatedDistance(FAUCET_BASIN_CM);
+    }
+
+    std::sort(latencies, latencies + trials);
+    uint32_t maximum = latencies[trials - 1];
+    bool withinBudget = maximum < FAUCET_LATENCY_BUDGET_MS * 1000UL;
+    char line[224];
+    snprintf(line, sizeof(line),
+             "{\"bench\":\"faucet.open_latency\",\"trials\":%lu,\"p50_ms\":%.1f,\"p99_ms\":%.1f,\"max_ms\":%.1f,"
+             "\"quick_return_max_ms\":%.1f,\"budget_ms\":%d,\"within_budget\":%s}",
+             static_cast<unsigned long>(trials), latencies[trials / 2] / 1000.0, latencies[trials * 99 / 100] / 1000.0,
+             maximum / 1000.0, quickMaximum / 1000.0, FAUCET_LATENCY_BUDGET_MS, withinBudget ? "true" : "false");
+    out.println(line);
+    return withinBudget;
+}
+#endif
@@ -0,0 +1,109 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/**
+ * @file Benchmark.h
+ * @brief Declares the FrameworkBenchmark suite.
+ *
+ * Microbenchmarks and throughput benchmarks for the hot paths of the Modest IoT Nano-framework:
+ * event dispatch (virtual chain, StaticRouter behind Sensor::on and called directly on the
+ * concrete device, EventBus), command dispatch (through Actuator and direct), NMEA decoding
+ * (TinyGPSPlus alone and GpsSensor::update() fed from a ReplayStream; on the host TinyGPSPlus is
+ * the stub from host/stubs, which the output says), JSON payload construction, RFID code
+ * handling and the queue/metrics primitives. Each result is printed as one JSON object per line so serial logs from different
+ * releases can be diffed or fed to a regression script.
+ *
+ * Enable with `MODESTIOT_BENCHMARK` in ModestIoTConfig.h; the sketch then runs the suite in
+ * setup() before the device starts.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ModestIoTConfig.h"
+#include <stdint.h>
+
+class Print;
+
+class FrameworkBenchmark {
+public:
+    /**
+     * @brief Runs every benchmark and prints one JSON result per line.
+     *
+     * Line format: `{"bench":"<name>","iter":<n>,"ns_per_op":<x>,"ops_per_s":<y>[,"mb_per_s":<z>]}`.
+     *
+     * @param out Destination (e.g. Serial).
+     */
+    static void runAll(Print& out);
+
+    /**
+     * @brief Prints one benchmark result line.
+     * @param out Destination.
+     * @param name Benchmark name.
+     * @param iterations Operations performed.
+     * @param elapsedUs Total time for all operations in microseconds.
+     * @param bytesPerOp Bytes processed per operation (0 to omit throughput).
+     */
+    static void report(Print& out, const char* name, uint32_t iterations, uint32_t elapsedUs,
+                       uint32_t bytesPerOp = 0);
+
+    /**
+     * @brief Compresses a simulated GPS trace as single records and as batches of 2, 4 and 8.
+     *
+     * The trace comes from a SyntheticRoute on a VirtualClock, serialized as the uplink would.
+     * Line format: `{"bench":"deflate.batch<n>","bodies":<b>,"raw_bytes":<r>,
+     * "compressed_bytes":<c>,"ratio":<r/c>,"us_per_kb":<t>}`; the time covers compression only.
+     *
+     * @param out Destination.
+     */
+    static void compareCompression(Print& out);
+
+#ifndef ESP32
+    /**
+     * @brief Uploads the same GPS records over HTTP and over MQTT (QoS 0 and 1) and compares them.
+     *
+     * Host builds only (`host/bench <url> <broker> <port> [records]`): needs a reachable HTTP
+     * endpoint (e.g. tools/mock_server.py) and MQTT broker. Line format: `{"bench":"uplink.<transport>","records":<n>,"msgs_per_s":<x>,
+     * "bytes_per_record":<y>,"errors":<e>}`; bytes count everything on the wire, headers included.
+     *
+     * @param out Destination.
+     * @param httpUrl Tracking endpoint URL.
+     * @param brokerHost MQTT broker host.
+     * @param brokerPort MQTT broker port.
+     * @param records Records to send over each transport.
+     */
+    static void compareUplinks(Print& out, const char* httpUrl, const char* brokerHost,
+                               uint16_t brokerPort, uint32_t records);
+
+    /**
+     * @brief Simulates hands approaching a CiaSteelFaucet and measures the time to an open valve.
+     *
+     * Host builds only (`host/faucet [trials]`): the faucet runs on a VirtualClock with its control loop stepped at the
+     * timer period, and each hand arrives at a random phase of the ping schedule. Every other hand
+     * returns within FAUCET_VALVE_MIN_SWITCH_MS of the valve closing. Latency runs from the hand's
+     * arrival to the relay switching. Line format: `{"bench":"faucet.open_latency","trials":<n>,
+     * "p50_ms":<x>,"p99_ms":<y>,"max_ms":<z>,"quick_return_max_ms":<q>,"budget_ms":<b>,
+     * "within_budget":<bool>}`.
+     *
+     * @param out Destination.
+     * @param trials Approaches to simulate (at most 1000).
+     * @return True if every approach opened the valve within FAUCET_LATENCY_BUDGET_MS.
+     */
+    static bool measureFaucetLatency(Print& out, uint32_t trials);
+#endif
+};
+
+#endif // BENCHMARK_H
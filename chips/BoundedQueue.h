@@ -0,0 +1,133 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+/**
+ * @file BoundedQueue.h
+ * @brief Declares the BoundedQueue template.
+ *
+ * A fixed-capacity, lock-free ring buffer for passing events, commands or records between one
+ * producer and one consumer in the Modest IoT Nano-framework. Storage is part of the object, so
+ * a queue never touches the heap, and push/pop are safe to call from an ISR or another core as
+ * long as each side has a single caller.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Single-producer/single-consumer ring buffer of `Capacity` elements.
+ * @tparam T Element type; must be trivially copyable (it is copied in and out with memcpy).
+ * @tparam Capacity Number of slots; must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class BoundedQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "BoundedQueue capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "BoundedQueue elements must be trivially copyable");
+
+private:
+    alignas(T) uint8_t slots[Capacity][sizeof(T)]; ///< Raw element storage.
+    std::atomic<uint32_t> head; ///< Next slot to read (owned by the consumer).
+    std::atomic<uint32_t> tail; ///< Next slot to write (owned by the producer).
+    std::atomic<uint32_t> drops; ///< Pushes rejected because the queue was full.
+
+public:
+    BoundedQueue() : head(0), tail(0), drops(0) {}
+
+    /**
+     * @brief Appends an element.
+     * Always inlined, so an IRAM interrupt handler can call it without reaching into flash.
+     * @param item The element to copy into the queue.
+     * @return True if queued, false if the queue was full.
+     */
+    __attribute__((always_inline)) bool push(const T& item) {
+        uint32_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) >= Capacity) {
+            drops.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        memcpy(slots[currentTail & (Capacity - 1)], &item, sizeof(T));
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element.
+     * @param item Destination for the element.
+     * @return True if an element was removed, false if the queue was empty.
+     */
+    bool pop(T& item) {
+        uint32_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        memcpy(&item, slots[currentHead & (Capacity - 1)], sizeof(T));
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Puts an element back at the head, so it is the next one popped.
+     * Moves the consumer's index, so it is only safe when the producer and the consumer are the
+     * same task (as in OutboundQueue).
+     * @param item The element to copy into the queue.
+     * @return True if queued, false if the queue was full.
+     */
+    bool pushFront(const T& item) {
+        uint32_t currentHead = head.load(std::memory_order_relaxed);
+        if (tail.load(std::memory_order_acquire) - currentHead >= Capacity) {
+            drops.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        memcpy(slots[(currentHead - 1) & (Capacity - 1)], &item, sizeof(T));
+        head.store(currentHead - 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Gets a pointer to the oldest element without removing it.
+     * @return Pointer to the element, or nullptr if the queue is empty. Only the consumer may call this.
+     */
+    const T* peek() const {
+        uint32_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return reinterpret_cast<const T*>(slots[currentHead & (Capacity - 1)]);
+    }
+
+    /**
+     * @brief Gets the number of queued elements.
+     * @return Elements currently in the queue.
+     */
+    size_t size() const {
+        uint32_t currentHead = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - currentHead;
+    }
+
+    bool empty() const { return size() == 0; } ///< True if no elements are queued.
+    bool full() const { return size() >= Capacity; } ///< True if a push would be rejected.
+    uint32_t dropped() const { return drops.load(std::memory_order_relaxed); } ///< Rejected pushes so far.
+    static constexpr size_t capacity() { return Capacity; } ///< Maximum number of elements.
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -3,8 +3,10 @@
  * @brief Implements the Button class.
  *
  * Configures a button as an input device in the Modest IoT Nano-framework, setting up the pin
- * with an internal pull-up resistor. Event generation (e.g., BUTTON_PRESSED_EVENT) is typically
- * triggered externally via interrupt or polling in user code.
+ * with an internal pull-up resistor. begin() attaches a pin-change interrupt that only stamps and
+ * queues edges; settling and gesture recognition run in the esp_timer task, which is the single
+ * producer of the gesture queue. Without the timers (before begin(), or off the ESP32) update()
+ * and wait() do that work themselves.
  *
  * @author Angel Velasquez
  * @date March 22, 2025
@@ -26,9 +28,202 @@
 #include "Button.h"
 #include <Arduino.h>
 
+#ifdef ESP32
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#define BUTTON_DEBOUNCE_US (BUTTON_DEBOUNCE_MS * 1000UL)
+#define BUTTON_LONG_PRESS_US (BUTTON_LONG_PRESS_MS * 1000UL)
+#define BUTTON_DOUBLE_PRESS_US (BUTTON_DOUBLE_PRESS_MS * 1000UL)
+
 const Event Button::BUTTON_PRESSED_EVENT = Event(BUTTON_PRESSED_EVENT_ID);
+const Event Button::BUTTON_LONG_PRESS_EVENT = Event(BUTTON_LONG_PRESS_EVENT_ID);
+const Event Button::BUTTON_DOUBLE_PRESS_EVENT = Event(BUTTON_DOUBLE_PRESS_EVENT_ID);
 
-Button::Button(int pin, EventHandler* eventHandler)
-    : Sensor(pin, eventHandler) {
+Button::Button(int pin, EventHandler* eventHandler, Clock& clock)
+    : Sensor(pin, eventHandler), clock(&clock), rawPressed(false), lastEdgeUs(0), waiter(nullptr),
+      bouncing(false), burstStartUs(0), pressed(false), pressStartUs(0), longReported(false),
+      pairable(false), releasedAtUs(0), debounceTimer(nullptr), holdTimer(nullptr) {
     pinMode(pin, INPUT_PULLUP);
 }
+
+bool Button::begin() {
+#ifdef ESP32
+    if (debounceTimer != nullptr) {
+        return true;
+    }
+    esp_timer_create_args_t args = {};
+    args.callback = timerExpired;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "button";
+    esp_timer_handle_t debounce = nullptr;
+    esp_timer_handle_t hold = nullptr;
+    if (esp_timer_create(&args, &debounce) != ESP_OK) {
+        return false;
+    }
+    if (esp_timer_create(&args, &hold) != ESP_OK) {
+        esp_timer_delete(debounce);
+        return false;
+    }
+
+    bool level = digitalRead(pin) == LOW;
+    rawPressed.store(level, std::memory_order_relaxed);
+    pressed.store(level, std::memory_order_relaxed);
+    holdTimer = hold;
+    debounceTimer = debounce;
+    attachInterruptArg(digitalPinToInterrupt(pin), edgeInterrupt, this, CHANGE);
+    return true;
+#else
+    return false; // No pin interrupts: feed edges with injectEdge()
+#endif
+}
+
+void IRAM_ATTR Button::edgeInterrupt(void* button) {
+    Button* self = static_cast<Button*>(button);
+    // Clock::nowUs() is virtual and may live in flash: take the time from the IRAM-safe source
+    self->edge(digitalRead(self->pin) == LOW, static_cast<uint32_t>(SystemClock::isrNowUs()));
+}
+
+void Button::timerExpired(void* button) {
+    static_cast<Button*>(button)->settle();
+}
+
+void IRAM_ATTR Button::edge(bool isPressed, uint32_t atUs) {
+    rawPressed.store(isPressed, std::memory_order_relaxed);
+    lastEdgeUs.store(atUs, std::memory_order_release);
+    if (!edges.push(atUs)) {
+        lost.add();
+    }
+#ifdef ESP32
+    if (debounceTimer != nullptr) {
+        // Every edge restarts the window: the level settles once the contacts stop bouncing
+        esp_timer_handle_t timer = static_cast<esp_timer_handle_t>(debounceTimer);
+        esp_timer_stop(timer);
+        esp_timer_start_once(timer, BUTTON_DEBOUNCE_US);
+    }
+#endif
+}
+
+void Button::injectEdge(bool isPressed) {
+    edge(isPressed, static_cast<uint32_t>(clock->nowUs()));
+}
+
+void Button::settle() {
+    uint32_t edgeUs;
+    while (edges.pop(edgeUs)) {
+        if (!bouncing) {
+            bouncing = true;
+            burstStartUs = edgeUs;
+        }
+    }
+
+    uint32_t now = static_cast<uint32_t>(clock->nowUs());
+    bool wasPressed = pressed.load(std::memory_order_relaxed);
+    if (bouncing && now - lastEdgeUs.load(std::memory_order_acquire) >= BUTTON_DEBOUNCE_US) {
+        bouncing = false;
+        bool level = rawPressed.load(std::memory_order_relaxed);
+        if (level && !wasPressed) {
+            // The press happened at its first edge; a short press just before makes it a pair
+            bool pair = pairable && burstStartUs - releasedAtUs <= BUTTON_DOUBLE_PRESS_US;
+            pressStartUs = burstStartUs;
+            longReported = false;
+            pairable = !pair;
+            pressed.store(true, std::memory_order_relaxed);
+            emit(pair ? ButtonGesture::DOUBLE_PRESS : ButtonGesture::PRESS, pressStartUs, 0);
+#ifdef ESP32
+            if (holdTimer != nullptr) {
+                esp_timer_start_once(static_cast<esp_timer_handle_t>(holdTimer),
+                                     BUTTON_LONG_PRESS_US - (now - pressStartUs));
+            }
+#endif
+        } else if (!level && wasPressed) {
+            releasedAtUs = burstStartUs;
+            pairable = pairable && !longReported;
+            pressed.store(false, std::memory_order_relaxed);
+#ifdef ESP32
+            if (holdTimer != nullptr) {
+                esp_timer_stop(static_cast<esp_timer_handle_t>(holdTimer));
+            }
+#endif
+        }
+    }
+
+    if (pressed.load(std::memory_order_relaxed) && !longReported && now - pressStartUs >= BUTTON_LONG_PRESS_US) {
+        longReported = true;
+        pairable = false;
+        emit(ButtonGesture::LONG_PRESS, pressStartUs, (now - pressStartUs) / 1000);
+    }
+}
+
+void Button::emit(ButtonGesture gesture, uint32_t pressedAtUs, uint32_t heldMs) {
+    ButtonPress press = {gesture, pressedAtUs, heldMs};
+    if (!gestures.push(press)) {
+        lost.add();
+        return;
+    }
+#ifdef ESP32
+    void* task = waiter.load(std::memory_order_acquire);
+    if (task != nullptr) {
+        xTaskNotifyGive(static_cast<TaskHandle_t>(task));
+    }
+#endif
+}
+
+size_t Button::update() {
+    if (debounceTimer == nullptr) {
+        settle();
+    }
+
+    size_t published = 0;
+    ButtonPress press;
+    while (gestures.pop(press)) {
+        uint32_t nowUs = static_cast<uint32_t>(clock->nowUs());
+        uint32_t ageUs = nowUs - press.pressedAtUs;
+        int id = BUTTON_PRESSED_EVENT_ID;
+        if (press.gesture == ButtonGesture::LONG_PRESS) {
+            id = BUTTON_LONG_PRESS_EVENT_ID;
+        } else {
+            latency.record(ageUs);
+            if (press.gesture == ButtonGesture::DOUBLE_PRESS) {
+                id = BUTTON_DOUBLE_PRESS_EVENT_ID;
+            }
+        }
+        on(Event(id, press, clock->nowMs() - ageUs / 1000));
+        published++;
+    }
+    return published;
+}
+
+bool Button::wait(unsigned long timeoutMs) {
+#ifdef ESP32
+    if (debounceTimer != nullptr) {
+        if (gestures.empty()) {
+            waiter.store(xTaskGetCurrentTaskHandle(), std::memory_order_release);
+            if (gestures.empty()) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+            }
+            waiter.store(nullptr, std::memory_order_release);
+        }
+        return !gestures.empty();
+    }
+#endif
+    unsigned long start = clock->nowMs();
+    for (;;) {
+        settle();
+        if (!gestures.empty()) {
+            return true;
+        }
+        if (clock->nowMs() - start >= timeoutMs) {
+            return false;
+        }
+        clock->sleepMs(1);
+    }
+}
+
+void Button::registerMetrics(MetricsRegistry& registry) {
+    registry.add("button.latency_us", latency);
+    registry.add("button.dropped", lost);
+}
@@ -4,10 +4,18 @@
 /**
  * @file Button.h
  * @brief Declares the Button class.
- * 
+ *
  * A concrete sensor class in the Modest IoT Nano-framework for detecting button presses and
  * generating events. It serves as an example of extending the `Sensor` base class for input devices.
- * 
+ *
+ * After begin(), a pin-change interrupt timestamps every edge in microseconds (with
+ * SystemClock::isrNowUs(), so the button's clock must follow micros()) and queues it; a
+ * one-shot timer settles the level once it has been stable for BUTTON_DEBOUNCE_MS, so nothing
+ * blocks and a press is recognized one debounce window after its first edge. A second timer
+ * turns a press held for BUTTON_LONG_PRESS_MS into a long press. Recognized gestures wait in an
+ * ISR-safe queue until update() publishes them to the handler; wait() wakes its caller as soon
+ * as one is queued.
+ *
  * @author Angel Velasquez
  * @date March 22, 2025
  * @version 0.1
@@ -21,23 +29,122 @@
  * You may use, copy, and distribute this software in its original, unmodified form, provided
  * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
  * Modifications, adaptations, or derivative works are not permitted.
- * 
+ *
  * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
  */
 
 #include "Sensor.h"
+#include "BoundedQueue.h"
+#include "Clock.h"
+#include "Metrics.h"
+#include <atomic>
+
+#define BUTTON_DEBOUNCE_MS 20        ///< Time the level must stay unchanged to count as settled.
+#define BUTTON_LONG_PRESS_MS 800     ///< Hold time that makes a press a long press.
+#define BUTTON_DOUBLE_PRESS_MS 300   ///< Largest gap between a short press's release and the next press.
+#define BUTTON_EDGE_QUEUE_DEPTH 16   ///< Raw edges waiting to be settled (power of two).
+#define BUTTON_GESTURE_QUEUE_DEPTH 8 ///< Gestures waiting for update() (power of two).
+
+/**
+ * @brief Kinds of gesture a Button recognizes.
+ */
+enum class ButtonGesture : uint8_t {
+    PRESS,       ///< A press settled (the first of a possible pair).
+    LONG_PRESS,  ///< A press has been held for BUTTON_LONG_PRESS_MS.
+    DOUBLE_PRESS ///< A press settled shortly after a short press ended (raised instead of PRESS).
+};
+
+/**
+ * @brief Gesture carried as the payload of the button events.
+ */
+struct ButtonPress {
+    ButtonGesture gesture;
+    uint32_t pressedAtUs; ///< Time of the press's first edge, in Clock::nowUs() units.
+    uint32_t heldMs;      ///< Time held when a long press was recognized (0 otherwise).
+};
 
 class Button : public Sensor {
+private:
+    Clock* clock;
+    BoundedQueue<uint32_t, BUTTON_EDGE_QUEUE_DEPTH> edges;            ///< Edge times (ISR to settler).
+    BoundedQueue<ButtonPress, BUTTON_GESTURE_QUEUE_DEPTH> gestures;   ///< Recognized gestures (settler to update()).
+    std::atomic<bool> rawPressed;      ///< Level at the latest edge.
+    std::atomic<uint32_t> lastEdgeUs;  ///< Time of the latest edge.
+    std::atomic<void*> waiter;         ///< Task blocked in wait(), if any.
+
+    // Settler state (timer task on the ESP32, update() on the host)
+    bool bouncing;          ///< True while edges have not settled yet.
+    uint32_t burstStartUs;  ///< First edge of the unsettled burst.
+    std::atomic<bool> pressed; ///< Settled level.
+    uint32_t pressStartUs;  ///< First edge of the current press.
+    bool longReported;      ///< True once the current press was reported as a long press.
+    bool pairable;          ///< True if the last press was short and may start a double press.
+    uint32_t releasedAtUs;  ///< Settled time of the last release.
+
+    void* debounceTimer;    ///< One-shot timer settling the level (nullptr until begin() on the ESP32).
+    void* holdTimer;        ///< One-shot timer recognizing long presses (nullptr until begin() on the ESP32).
+
+    Histogram latency;      ///< First edge to publication, in microseconds.
+    Counter lost;           ///< Edges and gestures dropped because a queue was full.
+
+    static void edgeInterrupt(void* button); ///< Pin-change interrupt handler.
+    static void timerExpired(void* button);  ///< Debounce and hold timer callback.
+
+    void edge(bool isPressed, uint32_t atUs);
+    void settle();
+    void emit(ButtonGesture gesture, uint32_t pressedAtUs, uint32_t heldMs);
+
 public:
-    static const int BUTTON_PRESSED_EVENT_ID = 0; ///< Unique ID for button press event.
+    static const int BUTTON_PRESSED_EVENT_ID = 12; ///< Unique ID for button press event.
+    static const int BUTTON_LONG_PRESS_EVENT_ID = 14; ///< Unique ID for long press event.
+    static const int BUTTON_DOUBLE_PRESS_EVENT_ID = 15; ///< Unique ID for double press event.
     static const Event BUTTON_PRESSED_EVENT; ///< Predefined event for button presses.
+    static const Event BUTTON_LONG_PRESS_EVENT; ///< Predefined event for long presses.
+    static const Event BUTTON_DOUBLE_PRESS_EVENT; ///< Predefined event for double presses.
 
     /**
      * @brief Constructs a Button sensor.
      * @param pin The GPIO pin for the button (configured as INPUT_PULLUP).
      * @param eventHandler Optional handler to receive button events (default: nullptr).
+     * @param clock Time source for edge timestamps (default: the system clock).
+     */
+    Button(int pin, EventHandler* eventHandler = nullptr, Clock& clock = SystemClock::instance());
+
+    /**
+     * @brief Attaches the pin-change interrupt and creates the debounce timers.
+     * The interrupt stamps edges in micros() time, so use it with the system clock.
+     * @return True if edges are being captured.
+     */
+    bool begin();
+
+    /**
+     * @brief Feeds an edge from another source (a test, a recorded session or a polled pin).
+     * @param isPressed True if the pin went to the pressed (low) level.
+     */
+    void injectEdge(bool isPressed);
+
+    /**
+     * @brief Publishes the queued gestures to the handler, each as an event carrying a ButtonPress.
+     * Call it from a single task. Without begin()'s timers it also settles edges and recognizes long presses.
+     * @return Number of events published.
+     */
+    size_t update();
+
+    /**
+     * @brief Blocks until a gesture is queued or the timeout passes. Only one task may wait.
+     * @param timeoutMs Longest wait in milliseconds.
+     * @return True if a gesture is waiting for update().
+     */
+    bool wait(unsigned long timeoutMs);
+
+    bool isPressed() const { return pressed.load(std::memory_order_relaxed); } ///< Settled level.
+    uint32_t dropped() const { return lost.get(); } ///< Edges and gestures lost to a full queue.
+
+    /**
+     * @brief Registers `button.latency_us` and `button.dropped`.
+     * @param registry The registry to add them to.
      */
-    Button(int pin, EventHandler* eventHandler = nullptr);
+    void registerMetrics(MetricsRegistry& registry);
 };
 
-#endif // BUTTON_H
\ No newline at end of file
+#endif // BUTTON_H
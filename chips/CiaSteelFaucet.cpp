@@ -0,0 +1,179 @@
+/**
+ * @file CiaSteelFaucet.cpp
+ * @brief Implements the CiaSteelFaucet class.
+ *
+ * Everything that touches the sensor or the valve runs in step(), on the esp_timer task, so the
+ * control state needs no locking; commands from other tasks reach it through one atomic slot.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "CiaSteelFaucet.h"
+
+#ifdef ESP32
+#include <esp_timer.h>
+#endif
+
+const Command CiaSteelFaucet::START_WATER_FLOW_COMMAND = Command(START_WATER_FLOW_COMMAND_ID);
+const Command CiaSteelFaucet::STOP_WATER_FLOW_COMMAND = Command(STOP_WATER_FLOW_COMMAND_ID);
+
+CiaSteelFaucet::CiaSteelFaucet(int triggerPin, int echoPin, int valvePin, bool valveActiveLow, Clock &clock)
+    : clock(clock), handSensor(triggerPin, echoPin, FAUCET_SAMPLE_PERIOD_MS, this, clock),
+      valve(valvePin, valveActiveLow, FAUCET_VALVE_MIN_SWITCH_MS, nullptr, clock), requestedCommand(0),
+      flowing(false), manual(false), handPresent(false), timingOpen(false), openedAtMs(0), handLeftAtMs(0),
+      controlTimer(nullptr)
+{
+    handSensor.setThreshold(FAUCET_HAND_DISTANCE_CM, FAUCET_HYSTERESIS_CM);
+
+    // A returning hand must not wait out the switching interval; the close delay and the
+    // hysteresis already keep the valve from chattering open and shut
+    valve.setImmediateActivation(true);
+}
+
+bool CiaSteelFaucet::begin()
+{
+    handSensor.begin();
+#ifdef ESP32
+    if (controlTimer != nullptr)
+    {
+        return true;
+    }
+    esp_timer_create_args_t args = {};
+    args.callback = controlTimerExpired;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "faucet";
+    esp_timer_handle_t timer = nullptr;
+    if (esp_timer_create(&args, &timer) != ESP_OK)
+    {
+        return false;
+    }
+    if (esp_timer_start_periodic(timer, FAUCET_CONTROL_PERIOD_MS * 1000ULL) != ESP_OK)
+    {
+        esp_timer_delete(timer);
+        return false;
+    }
+    controlTimer = timer;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void CiaSteelFaucet::controlTimerExpired(void *faucet)
+{
+    static_cast<CiaSteelFaucet *>(faucet)->step();
+}
+
+void CiaSteelFaucet::open(bool byHand)
+{
+    if (!flowing)
+    {
+        openings.add();
+    }
+    flowing = true;
+    openedAtMs = clock.nowMs();
+    timingOpen = byHand;
+    valve.set(true);
+    timeOpening();
+}
+
+void CiaSteelFaucet::close()
+{
+    flowing = false;
+    manual = false;
+    timingOpen = false;
+    valve.set(false);
+}
+
+void CiaSteelFaucet::timeOpening()
+{
+    if (timingOpen && valve.isActive())
+    {
+        timingOpen = false;
+        openLatency.record(valve.getLastSwitchUs() - handSensor.approachStartUs());
+    }
+}
+
+void CiaSteelFaucet::step()
+{
+    int request = requestedCommand.exchange(0, std::memory_order_acquire);
+    if (request == START_WATER_FLOW_COMMAND_ID)
+    {
+        manual = true;
+        open(false);
+    }
+    else if (request == STOP_WATER_FLOW_COMMAND_ID)
+    {
+        close();
+    }
+
+    // Crossings arrive in on() during this call
+    handSensor.update();
+
+    unsigned long now = clock.nowMs();
+    if (flowing)
+    {
+        if (!manual && !handPresent && now - handLeftAtMs >= FAUCET_CLOSE_DELAY_MS)
+        {
+            close();
+        }
+        else if (now - openedAtMs >= FAUCET_MAX_FLOW_MS)
+        {
+            close(); // Something left under the spout, or a forgotten manual start
+        }
+    }
+
+    valve.update();
+    timeOpening();
+}
+
+void CiaSteelFaucet::on(Event event)
+{
+    if (event.id == UltrasoundSensor::OBJECT_NEAR_EVENT_ID)
+    {
+        handPresent = true;
+        if (!flowing)
+        {
+            open(true);
+        }
+        else
+        {
+            openedAtMs = clock.nowMs(); // A new approach extends the flow
+        }
+    }
+    else if (event.id == UltrasoundSensor::OBJECT_FAR_EVENT_ID)
+    {
+        handPresent = false;
+        handLeftAtMs = clock.nowMs();
+    }
+}
+
+void CiaSteelFaucet::handle(Command command)
+{
+    if (command == START_WATER_FLOW_COMMAND || command == STOP_WATER_FLOW_COMMAND)
+    {
+        requestedCommand.store(command.id, std::memory_order_release);
+    }
+}
+
+void CiaSteelFaucet::registerMetrics(MetricsRegistry &registry)
+{
+    registry.add("faucet.open_latency_us", openLatency);
+    registry.add("faucet.openings", openings);
+    valve.registerMetrics(registry);
+}
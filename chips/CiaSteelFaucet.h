@@ -0,0 +1,134 @@
+#ifndef CIA_STEEL_FAUCET_H
+#define CIA_STEEL_FAUCET_H
+
+/**
+ * @file CiaSteelFaucet.h
+ * @brief Declares the CiaSteelFaucet class.
+ *
+ * Touchless faucet built on the Modest IoT Nano-framework: an UltrasoundSensor under the spout
+ * watches for hands and a RelayModule drives the solenoid valve. The control loop runs from a
+ * periodic hardware timer (esp_timer) every FAUCET_CONTROL_PERIOD_MS, independent of loop() and of
+ * the network, and pings at FAUCET_SAMPLE_PERIOD_MS. A hand within FAUCET_HAND_DISTANCE_CM opens
+ * the valve in the same pass the sensor reports it; the valve closes once the hand has been more
+ * than FAUCET_HAND_DISTANCE_CM + FAUCET_HYSTERESIS_CM away for FAUCET_CLOSE_DELAY_MS, so a hand
+ * hovering at the edge does not make it chatter.
+ *
+ * Worst case from a hand arriving to the valve opening: up to one sample period until the next
+ * ping, one more until its echo is collected, and one more for the median filter to agree (about
+ * 3 * FAUCET_SAMPLE_PERIOD_MS plus one control period), within FAUCET_LATENCY_BUDGET_MS as long as
+ * the valve has been closed for at least its minimum switching interval.
+ * FrameworkBenchmark::measureFaucetLatency() checks that bound in simulation.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Device.h"
+#include "UltrasoundSensor.h"
+#include "RelayModule.h"
+#include "Metrics.h"
+#include "Clock.h"
+#include <atomic>
+
+#define FAUCET_CONTROL_PERIOD_MS 5     ///< Period of the control loop timer.
+#define FAUCET_SAMPLE_PERIOD_MS 10     ///< Time between pings (100 Hz, about 1.7 m of range).
+#define FAUCET_HAND_DISTANCE_CM 15     ///< Distance at or below which a hand opens the valve.
+#define FAUCET_HYSTERESIS_CM 5         ///< Extra distance a hand must move away to count as gone.
+#define FAUCET_CLOSE_DELAY_MS 300      ///< Time without a hand before the valve closes.
+#define FAUCET_MAX_FLOW_MS 60000       ///< Longest the valve stays open without a new approach.
+#define FAUCET_VALVE_MIN_SWITCH_MS 100 ///< Shortest time from a valve switch to a close (opening never waits).
+#define FAUCET_LATENCY_BUDGET_MS 50    ///< Promised hand-to-valve latency.
+
+class CiaSteelFaucet : public Device
+{
+private:
+    Clock &clock;
+    UltrasoundSensor handSensor;
+    RelayModule valve;
+
+    std::atomic<int> requestedCommand; ///< Command waiting for the control loop (0 if none).
+    bool flowing;                      ///< True while the valve is (or is about to be) open.
+    bool manual;                       ///< True if the flow was started by START_WATER_FLOW_COMMAND.
+    bool handPresent;                  ///< True between OBJECT_NEAR and OBJECT_FAR.
+    bool timingOpen;                   ///< True until a hand-triggered opening has been timed.
+    unsigned long openedAtMs;          ///< When the current flow started.
+    unsigned long handLeftAtMs;        ///< When the hand was last seen leaving.
+    void *controlTimer;                ///< Periodic timer running step() (ESP32 only).
+
+    Histogram openLatency; ///< First near echo's ping to valve open, in microseconds.
+    Counter openings;      ///< Flows started.
+
+    static void controlTimerExpired(void *faucet);
+
+    void open(bool byHand);
+    void close();
+    void timeOpening();
+
+public:
+    static const int START_WATER_FLOW_COMMAND_ID = 50; ///< Unique ID for the start command.
+    static const int STOP_WATER_FLOW_COMMAND_ID = 51;  ///< Unique ID for the stop command.
+    static const Command START_WATER_FLOW_COMMAND;     ///< Opens the valve until stopped.
+    static const Command STOP_WATER_FLOW_COMMAND;      ///< Closes the valve.
+
+    /**
+     * @brief Constructs a faucet (valve closed).
+     * @param triggerPin TRIG pin of the ultrasonic sensor.
+     * @param echoPin ECHO pin of the ultrasonic sensor.
+     * @param valvePin Pin driving the valve's relay module.
+     * @param valveActiveLow True for relay modules that energize on a low input.
+     * @param clock Time source (default: the system clock).
+     */
+    CiaSteelFaucet(int triggerPin, int echoPin, int valvePin, bool valveActiveLow = false,
+                   Clock &clock = SystemClock::instance());
+
+    /**
+     * @brief Attaches the echo interrupt and starts the control loop timer.
+     * @return True if the timer is running; false off the ESP32, where step() drives the loop.
+     */
+    bool begin();
+
+    /**
+     * @brief Runs one pass of the control loop: commands, sensor, hysteresis, valve.
+     * Called by the timer; call it directly only when begin() returned false.
+     */
+    void step();
+
+    /**
+     * @brief Handles the hand sensor's crossing events (delivered during step()).
+     * @param event The event to process.
+     */
+    void on(Event event) override;
+
+    /**
+     * @brief Handles START_WATER_FLOW_COMMAND and STOP_WATER_FLOW_COMMAND from any task.
+     * The command is applied on the next control loop pass.
+     * @param command The command to execute.
+     */
+    void handle(Command command) override;
+
+    bool isFlowing() const { return valve.isActive(); } ///< True while the valve is open.
+    UltrasoundSensor &getHandSensor() { return handSensor; } ///< Sensor watching for hands.
+    RelayModule &getValve() { return valve; } ///< Relay driving the valve.
+    const Histogram &getOpenLatency() const { return openLatency; } ///< Hand-to-valve latencies in microseconds.
+
+    /**
+     * @brief Registers `faucet.open_latency_us`, `faucet.openings` and the valve's metrics.
+     * @param registry The registry to add them to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
+};
+
+#endif // CIA_STEEL_FAUCET_H
@@ -0,0 +1,100 @@
+/**
+ * @file Clock.cpp
+ * @brief Implements the SystemClock and VirtualClock classes.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Clock.h"
+#include <Arduino.h>
+
+#ifdef ESP32
+#include <esp_timer.h>
+#endif
+
+unsigned long SystemClock::nowMs()
+{
+    return millis();
+}
+
+unsigned long SystemClock::nowUs()
+{
+    return micros();
+}
+
+unsigned long IRAM_ATTR SystemClock::isrNowUs()
+{
+#ifdef ESP32
+    return static_cast<unsigned long>(esp_timer_get_time());
+#else
+    return micros();
+#endif
+}
+
+void SystemClock::sleepMs(unsigned long durationMs)
+{
+    delay(durationMs);
+}
+
+time_t SystemClock::wallTime()
+{
+    return time(nullptr);
+}
+
+SystemClock &SystemClock::instance()
+{
+    static SystemClock clock;
+    return clock;
+}
+
+VirtualClock::VirtualClock(time_t wallTimeAtStart) : elapsedUs(0), epoch(wallTimeAtStart)
+{
+}
+
+unsigned long VirtualClock::nowMs()
+{
+    return static_cast<unsigned long>(elapsedUs / 1000);
+}
+
+unsigned long VirtualClock::nowUs()
+{
+    return static_cast<unsigned long>(elapsedUs);
+}
+
+void VirtualClock::sleepMs(unsigned long durationMs)
+{
+    elapsedUs += static_cast<uint64_t>(durationMs) * 1000;
+}
+
+time_t VirtualClock::wallTime()
+{
+    return epoch + static_cast<time_t>(elapsedUs / 1000000);
+}
+
+void VirtualClock::advanceUs(uint64_t durationUs)
+{
+    elapsedUs += durationUs;
+}
+
+void VirtualClock::advanceToMs(uint64_t elapsedMs)
+{
+    uint64_t target = elapsedMs * 1000;
+    if (target > elapsedUs)
+    {
+        elapsedUs = target;
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+/**
+ * @file Clock.h
+ * @brief Declares the Clock interface and the SystemClock and VirtualClock classes.
+ *
+ * Time source for the Modest IoT Nano-framework. Components read monotonic time, sleep and
+ * timestamp their data through an injected Clock instead of calling millis(), delay() and
+ * time() directly. SystemClock maps onto the Arduino core; VirtualClock only moves when told
+ * to, so simulations and replays can run hours of device time in milliseconds and timing logic
+ * can be exercised deterministically.
+ *
+ * Processing-cost measurements (phase durations, traces) keep using the CPU's own timers: they
+ * measure the work itself, not device time.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#define VIRTUAL_CLOCK_EPOCH 1742601600 ///< Default wall time of a VirtualClock: 2025-03-22T00:00:00Z.
+
+/**
+ * @brief Abstract time source.
+ */
+class Clock {
+public:
+    virtual unsigned long nowMs() = 0; ///< Monotonic time in milliseconds (wraps like millis()).
+    virtual unsigned long nowUs() = 0; ///< Monotonic time in microseconds (wraps like micros()).
+
+    /**
+     * @brief Blocks for a duration.
+     * @param durationMs Time to sleep in milliseconds.
+     */
+    virtual void sleepMs(unsigned long durationMs) = 0;
+
+    /**
+     * @brief Blocks until the monotonic time reaches a deadline (returns at once if it passed).
+     * @param deadlineMs Deadline in nowMs() units.
+     */
+    void sleepUntilMs(unsigned long deadlineMs) {
+        long remaining = static_cast<long>(deadlineMs - nowMs());
+        if (remaining > 0) {
+            sleepMs(static_cast<unsigned long>(remaining));
+        }
+    }
+
+    virtual time_t wallTime() = 0; ///< Calendar time in seconds since the Unix epoch (UTC).
+
+    virtual ~Clock() = default; ///< Virtual destructor for safe inheritance.
+};
+
+/**
+ * @brief Clock backed by the Arduino core (millis, micros, delay, time).
+ */
+class SystemClock : public Clock {
+public:
+    unsigned long nowMs() override;
+    unsigned long nowUs() override;
+    void sleepMs(unsigned long durationMs) override;
+    time_t wallTime() override;
+
+    /**
+     * @brief Reads the nowUs() time from an interrupt handler.
+     * Not virtual and kept in IRAM, so it is safe in a handler that runs while the flash cache is
+     * disabled; use it instead of a Clock reference there.
+     * @return Monotonic time in microseconds (same timebase as nowUs()).
+     */
+    static unsigned long isrNowUs();
+
+    /**
+     * @brief Gets the shared system clock, the default for every component.
+     * @return The system clock.
+     */
+    static SystemClock& instance();
+};
+
+/**
+ * @brief Clock that advances only when slept on or explicitly advanced.
+ * Intended for single-threaded simulation: drive the device with runOnce(), not its tasks.
+ */
+class VirtualClock : public Clock {
+private:
+    uint64_t elapsedUs; ///< Time since the clock was created.
+    time_t epoch; ///< Wall time at elapsedUs == 0.
+
+public:
+    /**
+     * @brief Constructs a virtual clock.
+     * @param wallTimeAtStart Calendar time reported before any time has passed.
+     */
+    explicit VirtualClock(time_t wallTimeAtStart = VIRTUAL_CLOCK_EPOCH);
+
+    unsigned long nowMs() override;
+    unsigned long nowUs() override;
+    void sleepMs(unsigned long durationMs) override; ///< Advances the clock; returns immediately.
+    time_t wallTime() override;
+
+    /**
+     * @brief Moves the clock forward.
+     * @param durationUs Time to advance in microseconds.
+     */
+    void advanceUs(uint64_t durationUs);
+
+    /**
+     * @brief Moves the clock forward to an absolute time (never backwards).
+     * @param elapsedMs Target time in milliseconds since the clock was created.
+     */
+    void advanceToMs(uint64_t elapsedMs);
+
+    uint64_t elapsedMs() const { return elapsedUs / 1000; } ///< Simulated time so far.
+};
+
+#endif // CLOCK_H
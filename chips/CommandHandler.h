@@ -26,17 +26,36 @@
  * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
  */
 
+#include <string.h>
+
+#define COMMAND_TEXT_SIZE 16 ///< Bytes of inline text argument carried by every Command.
+
 /**
- * @brief Represents a command with a unique identifier.
+ * @brief Represents a command with a unique identifier and an optional argument.
  * 
  * Commands are lightweight structs used to instruct devices or actuators to perform actions.
- * Define custom commands by assigning unique IDs in your application.
+ * Define custom commands by assigning unique IDs in your application. A command can carry a
+ * numeric argument (e.g. an interval) and a short text argument (e.g. an RFID code), both by
+ * value, so commands decoded from a server response never need the heap.
  */
 struct Command {
     int id; ///< Unique identifier for the command type.
+    long value; ///< Numeric argument (0 if none).
+    char text[COMMAND_TEXT_SIZE]; ///< Text argument, null-terminated ("" if none).
+
+    explicit Command(int commandId = 0, long argument = 0) : id(commandId), value(argument) { text[0] = '\0'; }
+
+    /**
+     * @brief Constructs a command carrying a text argument (truncated to COMMAND_TEXT_SIZE - 1).
+     * @param commandId The command type identifier.
+     * @param argument The text argument.
+     */
+    Command(int commandId, const char* argument) : id(commandId), value(0) {
+        strncpy(text, argument, COMMAND_TEXT_SIZE - 1);
+        text[COMMAND_TEXT_SIZE - 1] = '\0';
+    }
 
-    explicit Command(int commandId) : id(commandId) {}
-    bool operator==(const Command& other) const { return id == other.id; }
+    bool operator==(const Command& other) const { return id == other.id; } ///< Compares command types only.
 };
 
 /**
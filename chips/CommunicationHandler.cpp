@@ -23,21 +23,28 @@
  */
 
 #include "CommunicationHandler.h"
-#include <WiFi.h>
-#include <HTTPClient.h>
+#include "Trace.h"
+#include "Log.h"
 #include <ArduinoJson.h>
 #include <time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 #include <Arduino.h>
 
 const Command CommunicationHandler::SEND_GPS_DATA_COMMAND = Command(SEND_GPS_DATA_COMMAND_ID);
 const Command CommunicationHandler::SEND_RFID_DATA_COMMAND = Command(SEND_RFID_DATA_COMMAND_ID);
 const Command CommunicationHandler::CONNECT_WIFI_COMMAND = Command(CONNECT_WIFI_COMMAND_ID);
 
-CommunicationHandler::CommunicationHandler(const String &ssid, const String &password,
-                                           const String &trackingUrl, const String &rfidUrl,
-                                           const String &deviceId)
+CommunicationHandler::CommunicationHandler(const char *ssid, const char *password,
+                                           const char *trackingUrl, const char *rfidUrl,
+                                           const char *deviceId, Clock &clock, Transport *uplink)
     : wifiSSID(ssid), wifiPassword(password), trackingEndpoint(trackingUrl),
-      rfidEndpoint(rfidUrl), deviceId(deviceId), recordId(1), isConnected(false)
+      rfidEndpoint(rfidUrl), deviceId(deviceId), recordId(1), isConnected(false),
+      clock(&clock), httpTransport(clock),
+      transport(uplink != nullptr ? uplink : &httpTransport),
+      smoothedRoundTripUs(0), gpsBatchSize(1), compressUploads(false),
+      piggybackMetrics(nullptr), piggybackInterval(0), lastPiggyback(0), piggybackNext(0)
 {
 }
 
@@ -52,18 +59,10 @@ void CommunicationHandler::handle(Command command)
 
 bool CommunicationHandler::connectToWiFi()
 {
+    TRACE_SCOPE("wifi.connect");
     Serial.print("Conectando a WiFi");
-    WiFi.begin(wifiSSID.c_str(), wifiPassword.c_str());
 
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20)
-    {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-    }
-
-    if (WiFi.status() == WL_CONNECTED)
+    if (transport->connect(wifiSSID.c_str(), wifiPassword.c_str()))
     {
         Serial.println("\nConectado!");
         isConnected = true;
@@ -79,89 +78,261 @@ bool CommunicationHandler::connectToWiFi()
 
 bool CommunicationHandler::sendGpsData(const GpsData &gpsData)
 {
+    TRACE_SCOPE("http.gps");
     if (!isConnected || !gpsData.isValid)
     {
         return false;
     }
 
-    HTTPClient httpClient;
-    httpClient.begin(trackingEndpoint);
-    httpClient.addHeader("Content-Type", "application/json");
+    char jsonData[GPS_PAYLOAD_SIZE];
+    int firstId = recordId;
+    size_t jsonLength = buildGpsPayload(gpsData, jsonData, sizeof(jsonData));
+    if (upload(trackingEndpoint.c_str(), jsonData, jsonLength, gpsRoundTrip, "GPS"))
+    {
+        return true;
+    }
+    // The fix is retried first, so it gets the same id again
+    recordId = firstId;
+    return false;
+}
 
-    StaticJsonDocument<256> dataRecord;
-    dataRecord["id"] = recordId++;
-    dataRecord["device_id"] = deviceId;
-    dataRecord["created_at"] = gpsData.timestamp;
-    dataRecord["latitude"] = gpsData.latitude;
-    dataRecord["longitude"] = gpsData.longitude;
+bool CommunicationHandler::sendRfidData(const RfidData &rfidData)
+{
+    TRACE_SCOPE("http.rfid");
+    if (!isConnected || !rfidData.isValid)
+    {
+        return false;
+    }
+
+    char jsonData[RFID_PAYLOAD_SIZE];
+    size_t jsonLength = buildRfidPayload(rfidData, jsonData, sizeof(jsonData));
+    return upload(rfidEndpoint.c_str(), jsonData, jsonLength, rfidRoundTrip, "RFID");
+}
+
+bool CommunicationHandler::sendGpsBatch(const GpsData &first)
+{
+    TRACE_SCOPE("http.gps_batch");
+    OutboundRecord taken[GPS_BATCH_MAX_RECORDS];
+    size_t count = 1;
+    int firstId = recordId;
+
+    // The batch must fit one message of the transport (an MQTT packet is far smaller than a POST)
+    size_t size = std::min(sizeof(batchBody) - 1, transport->maxPayload()) + 1;
+    size_t length = 0;
+    batchBody[length++] = '[';
+    if (!appendGpsRecord(first, batchBody, length, size))
+    {
+        return sendGpsData(first);
+    }
+
+    // Grow the batch only while nothing more urgent is waiting behind it, and only by fixes that
+    // fit: the rest stay queued for the next upload
+    OutboundRecord discarded;
+    while (count < gpsBatchSize && outbound.size(OutboundClass::ACCESS) == 0)
+    {
+        const OutboundRecord *next = outbound.peek(OutboundClass::ROUTINE);
+        if (next == nullptr || next->event.id != GpsSensor::GPS_DATA_EVENT_ID)
+        {
+            break;
+        }
+        GpsData gpsData;
+        if (!next->event.getPayload(gpsData) || !gpsData.isValid)
+        {
+            outbound.pop(OutboundClass::ROUTINE, discarded, clock->nowMs());
+            continue;
+        }
+        if (!appendGpsRecord(gpsData, batchBody, length, size))
+        {
+            break;
+        }
+        outbound.pop(OutboundClass::ROUTINE, taken[count], clock->nowMs());
+        count++;
+    }
+    batchBody[length++] = ']';
+    batchBody[length] = '\0';
+
+    if (upload(trackingEndpoint.c_str(), batchBody, length, gpsRoundTrip, "GPS"))
+    {
+        return true;
+    }
+
+    // Newest first, so the fixes go back in their original order and keep their ids on the
+    // retry; the caller requeues `first`
+    recordId = firstId;
+    for (size_t i = count - 1; i > 0; i--)
+    {
+        outbound.requeue(OutboundClass::ROUTINE, taken[i]);
+    }
+    return false;
+}
+
+bool CommunicationHandler::upload(const char *url, const char *payload, size_t length,
+                                  Histogram &roundTrip, const char *label)
+{
+    const void *body = payload;
+    size_t bodyLength = length;
+    if (compressUploads && length >= COMPRESS_MIN_BYTES)
+    {
+        TRACE_SCOPE("http.deflate");
+        deflate.begin(compressedBody, sizeof(compressedBody));
+        deflate.write(payload, length);
+        size_t packed = deflate.finish();
+        if (packed > 0 && packed < length)
+        {
+            body = compressedBody;
+            bodyLength = packed;
+        }
+    }
 
-    String jsonData;
-    serializeJson(dataRecord, jsonData);
+    TransportRequest request(url, "application/json", body, bodyLength);
+    if (body == compressedBody)
+    {
+        request.addHeader("Content-Encoding", "deflate");
+    }
+    char snapshot[METRICS_HEADER_SIZE];
+    attachMetrics(request, snapshot);
 
-    int httpCode = httpClient.POST(jsonData);
+    char response[RESPONSE_BUFFER_SIZE];
+    unsigned long startedAt = clock->nowUs();
+    int httpCode = transport->post(request, response, sizeof(response));
+    uint32_t elapsedUs = clock->nowUs() - startedAt;
+    roundTrip.record(elapsedUs);
+    smoothedRoundTripUs = smoothedRoundTripUs == 0
+                              ? elapsedUs
+                              : smoothedRoundTripUs - smoothedRoundTripUs / 4 + elapsedUs / 4;
+    bytesSent.add(bodyLength);
+    rawBytes.add(length);
 
-    if (httpCode > 0)
+    // Only 2xx means the server kept the record; a 4xx/5xx reply is retried like a lost request
+    if (httpCode >= 200 && httpCode < 300)
     {
-        Serial.print("GPS HTTP Code: ");
-        Serial.println(httpCode);
-        String response = httpClient.getString();
-        Serial.println("GPS Response: " + response);
-        httpClient.end();
+        LOG_INFO("%s HTTP Code: %d", label, httpCode);
+        LOG_DEBUG("%s Response: %s", label, response);
+        collectDownlink(response);
         return true;
     }
     else
     {
-        Serial.print("Error en GPS HTTP: ");
-        Serial.println(httpCode);
-        httpClient.end();
+        httpErrors.add();
+        LOG_WARN("Error en %s HTTP: %d", label, httpCode);
         return false;
     }
 }
 
-bool CommunicationHandler::sendRfidData(const RfidData &rfidData)
+size_t CommunicationHandler::buildGpsPayload(const GpsData &gpsData, char *buffer, size_t size)
 {
-    if (!isConnected || !rfidData.isValid)
+    StaticJsonDocument<GPS_PAYLOAD_SIZE> dataRecord;
+    dataRecord["id"] = recordId++;
+    dataRecord["device_id"] = deviceId.c_str();
+    dataRecord["created_at"] = gpsData.timestamp;
+    dataRecord["latitude"] = gpsData.latitude;
+    dataRecord["longitude"] = gpsData.longitude;
+
+    return serializeJson(dataRecord, buffer, size);
+}
+
+size_t CommunicationHandler::buildGpsBatch(const GpsData *records, size_t count, char *buffer, size_t size)
+{
+    if (size < 3)
     {
-        return false;
+        return 0;
     }
+    size_t length = 0;
+    buffer[length++] = '[';
+    for (size_t i = 0; i < count && appendGpsRecord(records[i], buffer, length, size); i++)
+    {
+    }
+    buffer[length++] = ']';
+    buffer[length] = '\0';
+    return length;
+}
+
+bool CommunicationHandler::appendGpsRecord(const GpsData &gpsData, char *buffer, size_t &length, size_t size)
+{
+    char record[GPS_PAYLOAD_SIZE];
+    size_t recordLength = buildGpsPayload(gpsData, record, sizeof(record));
+    size_t separator = length > 1 ? 1 : 0;
 
-    HTTPClient http;
-    http.begin(rfidEndpoint);
-    http.addHeader("Content-Type", "application/json");
+    // Room for the separator, the record, the closing bracket and the terminator
+    if (length + separator + recordLength + 2 > size)
+    {
+        recordId--; // Left out, so it keeps its id for the next upload
+        return false;
+    }
+    if (separator > 0)
+    {
+        buffer[length++] = ',';
+    }
+    memcpy(buffer + length, record, recordLength);
+    length += recordLength;
+    return true;
+}
 
-    StaticJsonDocument<200> payload;
+size_t CommunicationHandler::buildRfidPayload(const RfidData &rfidData, char *buffer, size_t size) const
+{
+    StaticJsonDocument<RFID_PAYLOAD_SIZE> payload;
     payload["rfidCode"] = rfidData.rfidCode;
     payload["scanType"] = rfidData.scanType;
+    if (!rfidData.allowed)
+    {
+        payload["access"] = "DENIED";
+    }
 
-    String jsonData;
-    serializeJson(payload, jsonData);
+    return serializeJson(payload, buffer, size);
+}
 
-    int httpCode = http.POST(jsonData);
+bool CommunicationHandler::enqueue(const Event &event, OutboundClass cls)
+{
+    return outbound.push(cls, event, clock->nowMs());
+}
 
-    if (httpCode > 0)
+bool CommunicationHandler::sendNext(OutboundClass *sentClass, OutboundClass lowest)
+{
+    OutboundRecord record;
+    OutboundClass cls;
+    if (!isWiFiConnected() || !outbound.pop(record, cls, clock->nowMs(), lowest))
     {
-        Serial.print("RFID HTTP Code: ");
-        Serial.println(httpCode);
-        String response = http.getString();
-        Serial.println("RFID Response: " + response);
-        http.end();
-        return true;
+        return false;
+    }
+    if (sentClass != nullptr)
+    {
+        *sentClass = cls;
+    }
+
+    GpsData gpsData;
+    RfidData rfidData;
+    bool delivered;
+    if (record.event.id == GpsSensor::GPS_DATA_EVENT_ID && record.event.getPayload(gpsData))
+    {
+        delivered = gpsBatchSize > 1 ? sendGpsBatch(gpsData) : sendGpsData(gpsData);
+    }
+    else if (record.event.id == RfidSensor::RFID_DETECTED_EVENT_ID && record.event.getPayload(rfidData))
+    {
+        delivered = sendRfidData(rfidData);
     }
     else
     {
-        Serial.print("Error en RFID HTTP: ");
-        Serial.println(httpCode);
-        http.end();
+        LOG_WARN("Sin endpoint para el evento %d", record.event.id);
         return false;
     }
+
+    // A failed upload keeps its place at the head of its class until it runs out of attempts
+    if (!delivered && !outbound.requeue(cls, record))
+    {
+        LOG_WARN("Registro descartado tras %d intentos", OUTBOUND_MAX_ATTEMPTS);
+    }
+    return delivered;
 }
 
 void CommunicationHandler::checkConnection()
 {
-    if (WiFi.status() != WL_CONNECTED)
+    TRACE_SCOPE("wifi.check");
+    transport->poll();
+    if (!transport->isConnected())
     {
-        Serial.println("Reconectando WiFi...");
-        WiFi.disconnect();
+        LOG_WARN("Reconectando WiFi...");
+        reconnects.add();
+        transport->disconnect();
         isConnected = false;
         connectToWiFi();
     }
@@ -169,16 +340,162 @@ void CommunicationHandler::checkConnection()
 
 bool CommunicationHandler::isWiFiConnected() const
 {
-    return isConnected && (WiFi.status() == WL_CONNECTED);
+    return isConnected && transport->isConnected();
+}
+
+void CommunicationHandler::registerMetrics(MetricsRegistry &registry)
+{
+    registry.add("http.gps.rtt_us", gpsRoundTrip);
+    registry.add("http.rfid.rtt_us", rfidRoundTrip);
+    registry.add("http.bytes", bytesSent);
+    registry.add("http.raw_bytes", rawBytes);
+    registry.add("http.errors", httpErrors);
+    registry.add("wifi.reconnects", reconnects);
+    registry.add("downlink.commands", downlinkCommands);
+    registry.add("downlink.rejected", downlinkRejected);
+    outbound.registerMetrics(registry);
+}
+
+void CommunicationHandler::setMetricsPiggyback(const MetricsRegistry *registry, unsigned long intervalMs)
+{
+    piggybackMetrics = registry;
+    piggybackInterval = intervalMs;
+    piggybackNext = 0;
+    lastPiggyback = clock->nowMs();
 }
 
-String CommunicationHandler::getISO8601Time() const
+void CommunicationHandler::setGpsBatchSize(uint8_t records)
 {
-    time_t now;
+    gpsBatchSize = records < 1 ? 1 : (records > GPS_BATCH_MAX_RECORDS ? GPS_BATCH_MAX_RECORDS : records);
+}
+
+void CommunicationHandler::setCompression(bool enabled)
+{
+    compressUploads = enabled;
+}
+
+void CommunicationHandler::setTransport(Transport *newTransport)
+{
+    transport = newTransport != nullptr ? newTransport : &httpTransport;
+}
+
+void CommunicationHandler::attachMetrics(TransportRequest &request, char *snapshot)
+{
+    if (piggybackMetrics == nullptr || clock->nowMs() - lastPiggyback < piggybackInterval)
+    {
+        return;
+    }
+    // The registry does not fit in one header: each snapshot carries the whole entries that
+    // follow the previous one, so successive uploads cycle through every metric
+    piggybackMetrics->writeCompact(snapshot, METRICS_HEADER_SIZE, piggybackNext, &piggybackNext);
+    request.addHeader("X-Device-Metrics", snapshot);
+    lastPiggyback = clock->nowMs();
+}
+
+void CommunicationHandler::formatISO8601Time(char *buffer, size_t size) const
+{
+    time_t now = clock->wallTime();
     struct tm timeinfo;
-    char buf[30];
-    time(&now);
     gmtime_r(&now, &timeinfo);
-    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
-    return String(buf);
+    strftime(buffer, size, "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
+}
+
+void CommunicationHandler::collectDownlink(const char *response)
+{
+    Command commands[DOWNLINK_QUEUE_DEPTH];
+    size_t rejected = 0;
+    size_t count = decodeCommands(response, commands, DOWNLINK_QUEUE_DEPTH, &rejected);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (downlink.push(commands[i]))
+        {
+            downlinkCommands.add();
+        }
+        else
+        {
+            rejected++;
+        }
+    }
+    if (rejected > 0)
+    {
+        downlinkRejected.add(rejected);
+    }
+}
+
+bool CommunicationHandler::nextDownlinkCommand(Command &command)
+{
+    return downlink.pop(command);
+}
+
+size_t CommunicationHandler::decodeCommands(const char *response, Command *commands, size_t maxCommands,
+                                            size_t *rejected)
+{
+    size_t count = 0;
+    size_t malformed = 0;
+    const char *cursor = response != nullptr ? strstr(response, DOWNLINK_KEY) : nullptr;
+    if (cursor != nullptr)
+    {
+        // Skip to the opening quote of the value: "cmd" : "..."
+        cursor += strlen(DOWNLINK_KEY);
+        while (*cursor == ' ' || *cursor == ':')
+        {
+            cursor++;
+        }
+        cursor = *cursor == '"' ? cursor + 1 : nullptr;
+    }
+
+    while (cursor != nullptr && *cursor != '"' && *cursor != '\0')
+    {
+        // One command: digits, then an optional "=argument", up to ';' or the closing quote
+        const char *end = cursor;
+        while (*end != ';' && *end != '"' && *end != '\0')
+        {
+            end++;
+        }
+
+        long id = 0;
+        const char *digit = cursor;
+        while (digit < end && *digit >= '0' && *digit <= '9')
+        {
+            id = id * 10 + (*digit - '0');
+            digit++;
+        }
+
+        bool wellFormed = digit > cursor && digit - cursor <= 6 && (digit == end || *digit == '=');
+        if (wellFormed && count < maxCommands)
+        {
+            Command command(static_cast<int>(id));
+            if (digit < end)
+            {
+                const char *argument = digit + 1;
+                size_t length = end - argument;
+                if (length > COMMAND_TEXT_SIZE - 1)
+                {
+                    length = COMMAND_TEXT_SIZE - 1;
+                }
+                memcpy(command.text, argument, length);
+                command.text[length] = '\0';
+
+                char *numberEnd = nullptr;
+                long number = strtol(command.text, &numberEnd, 10);
+                if (length > 0 && numberEnd != nullptr && *numberEnd == '\0')
+                {
+                    command.value = number;
+                }
+            }
+            commands[count++] = command;
+        }
+        else if (end > cursor)
+        {
+            malformed++;
+        }
+
+        cursor = *end == ';' ? end + 1 : end;
+    }
+
+    if (rejected != nullptr)
+    {
+        *rejected = malformed;
+    }
+    return count;
 }
@@ -28,17 +28,66 @@
 #include "CommandHandler.h"
 #include "GpsSensor.h"
 #include "RfidSensor.h"
+#include "FixedString.h"
+#include "Metrics.h"
+#include "Transport.h"
+#include "HttpTransport.h"
+#include "Clock.h"
+#include "OutboundQueue.h"
+#include "BoundedQueue.h"
+#include "DeflateEncoder.h"
+
+#define WIFI_SSID_SIZE 33     ///< 32-character SSID plus terminator.
+#define WIFI_PASSWORD_SIZE 65 ///< 64-character WPA2 passphrase plus terminator.
+#define ENDPOINT_URL_SIZE 128 ///< Maximum endpoint URL length, including terminator.
+#define DEVICE_ID_SIZE 32     ///< Maximum device identifier length, including terminator.
+#define RESPONSE_BUFFER_SIZE 128 ///< Bytes of each HTTP response body that are read back.
+#define METRICS_HEADER_SIZE 256  ///< Maximum size of the piggybacked metrics header value.
+#define GPS_PAYLOAD_SIZE 256     ///< Buffer size for one serialized GPS record.
+#define RFID_PAYLOAD_SIZE 200    ///< Buffer size for one serialized RFID record.
+#define GPS_BATCH_MAX_RECORDS 8  ///< Most GPS records one batched upload can carry.
+#define UPLOAD_BODY_SIZE (GPS_BATCH_MAX_RECORDS * GPS_PAYLOAD_SIZE) ///< Largest upload body (a full batch).
+#define COMPRESS_MIN_BYTES 256   ///< Bodies shorter than this are never worth compressing.
+#define DOWNLINK_QUEUE_DEPTH 8   ///< Decoded server commands waiting for the device (power of two).
+#define DOWNLINK_KEY "\"cmd\"" ///< Response member holding downlink commands.
 
 class CommunicationHandler : public CommandHandler
 {
 private:
-    String wifiSSID;
-    String wifiPassword;
-    String trackingEndpoint;
-    String rfidEndpoint;
-    String deviceId;
+    FixedString<WIFI_SSID_SIZE> wifiSSID;
+    FixedString<WIFI_PASSWORD_SIZE> wifiPassword;
+    FixedString<ENDPOINT_URL_SIZE> trackingEndpoint;
+    FixedString<ENDPOINT_URL_SIZE> rfidEndpoint;
+    FixedString<DEVICE_ID_SIZE> deviceId;
     int recordId;
     bool isConnected;
+    Clock *clock;                ///< Time source for round trips and snapshot intervals.
+    HttpTransport httpTransport; ///< Default uplink.
+    Transport *transport;        ///< Uplink in use (httpTransport unless replaced).
+    OutboundQueue outbound;      ///< Records waiting for the uplink, by priority class.
+
+    Histogram gpsRoundTrip;  ///< GPS endpoint HTTP round-trip time in microseconds.
+    Histogram rfidRoundTrip; ///< RFID endpoint HTTP round-trip time in microseconds.
+    Counter bytesSent;       ///< Body bytes posted to either endpoint (after compression).
+    Counter httpErrors;      ///< Requests that failed or got a non-2xx status.
+    Counter reconnects;      ///< WiFi reconnections triggered by checkConnection().
+    Counter rawBytes;        ///< Payload bytes before compression.
+    Counter downlinkCommands; ///< Commands decoded from upload responses.
+    Counter downlinkRejected; ///< Malformed or overflowing downlink commands.
+    uint32_t smoothedRoundTripUs; ///< Moving average of upload round trips (1/4 weight per upload).
+
+    BoundedQueue<Command, DOWNLINK_QUEUE_DEPTH> downlink; ///< Decoded commands not yet taken.
+
+    uint8_t gpsBatchSize;                     ///< GPS records per upload (1: one object per POST).
+    bool compressUploads;                     ///< Deflate bodies of COMPRESS_MIN_BYTES or more.
+    DeflateEncoder deflate;                   ///< Compressor state, reused by every upload.
+    char batchBody[UPLOAD_BODY_SIZE];         ///< JSON array of the batch being sent.
+    uint8_t compressedBody[UPLOAD_BODY_SIZE]; ///< Deflated body of the upload being sent.
+
+    const MetricsRegistry *piggybackMetrics; ///< Registry attached to uploads, if any.
+    unsigned long piggybackInterval;         ///< Minimum time between attached snapshots.
+    unsigned long lastPiggyback;             ///< Time the last snapshot was attached.
+    uint8_t piggybackNext;                   ///< First metric of the next snapshot.
 
 public:
     static const int SEND_GPS_DATA_COMMAND_ID = 20;  ///< Command to send GPS data.
@@ -55,10 +104,13 @@ public:
      * @param trackingUrl URL for GPS tracking endpoint.
      * @param rfidUrl URL for RFID scan endpoint.
      * @param deviceId Device identifier for tracking.
+     * @param clock Time source (default: the system clock).
+     * @param uplink Transport to upload through (default: HTTP POST; e.g. an MqttTransport).
      */
-    CommunicationHandler(const String &ssid, const String &password,
-                         const String &trackingUrl, const String &rfidUrl,
-                         const String &deviceId);
+    CommunicationHandler(const char *ssid, const char *password,
+                         const char *trackingUrl, const char *rfidUrl,
+                         const char *deviceId, Clock &clock = SystemClock::instance(),
+                         Transport *uplink = nullptr);
 
     /**
      * @brief Handles communication commands.
@@ -86,6 +138,109 @@ public:
      */
     bool sendRfidData(const RfidData &rfidData);
 
+    /**
+     * @brief Queues a GPS or RFID event for upload in the given priority class.
+     * Records stay queued while WiFi is down; a full class evicts its oldest record.
+     * @param event Event carrying GpsData or RfidData.
+     * @param cls Priority class (RFID scans are ACCESS, GPS fixes ROUTINE).
+     * @return True if nothing was evicted.
+     */
+    bool enqueue(const Event &event, OutboundClass cls);
+
+    /**
+     * @brief Uploads the next queued record, highest priority (or most overdue) first.
+     * A record leaves the queue only once uploaded; if the upload fails it goes back to the head
+     * of its class (see OutboundQueue::requeue), and so do the fixes a failed batch took with it.
+     * @param sentClass Receives the class of the record taken (optional).
+     * @param lowest Lowest class to upload; lower classes are deferred (default: all classes).
+     * @return True if a record was uploaded, false if the queue is empty, WiFi is down or the
+     * upload failed.
+     */
+    bool sendNext(OutboundClass *sentClass = nullptr, OutboundClass lowest = OutboundClass::ROUTINE);
+
+    size_t pendingRecords() const { return outbound.size(); } ///< Records waiting for the uplink.
+    uint32_t roundTripMs() const { return smoothedRoundTripUs / 1000; } ///< Smoothed upload round trip.
+    uint32_t uploadErrors() const { return httpErrors.get(); } ///< Uploads that failed so far.
+
+    /**
+     * @brief Uploads GPS fixes in batches: one JSON array of up to `records` objects per POST.
+     * A batch only grows while no access record is waiting, so it never delays one.
+     * @param records Records per batch, 1 (one object per POST, the default) to GPS_BATCH_MAX_RECORDS.
+     */
+    void setGpsBatchSize(uint8_t records);
+
+    /**
+     * @brief Enables deflate compression of upload bodies (`Content-Encoding: deflate`).
+     * Bodies shorter than COMPRESS_MIN_BYTES, or that would not shrink, are sent as they are.
+     * @param enabled True to compress.
+     */
+    void setCompression(bool enabled);
+
+    /**
+     * @brief Takes the next command the server returned in an upload response.
+     * Commands are queued rather than dispatched from inside the upload, so a command that
+     * triggers more uploads (e.g. a flush) never re-enters the transport.
+     * @param command Destination for the command.
+     * @return True if a command was waiting.
+     */
+    bool nextDownlinkCommand(Command &command);
+
+    /**
+     * @brief Counts a decoded command the device could not apply in `downlink.rejected`.
+     * Safe to call from the ingest task.
+     */
+    void rejectDownlinkCommand() { downlinkRejected.add(); }
+
+    /**
+     * @brief Decodes the downlink commands in a response body, without allocating.
+     *
+     * The server adds a `"cmd"` string member to its JSON reply holding `;`-separated commands,
+     * each a command id with an optional `=argument`, e.g. `{"status":"created","cmd":"30=5000;31"}`.
+     * A numeric argument fills Command::value; every argument is also kept in Command::text.
+     *
+     * @param response Null-terminated response body.
+     * @param commands Destination array.
+     * @param maxCommands Capacity of the destination array.
+     * @param rejected Receives the number of malformed commands skipped (optional).
+     * @return Number of commands decoded.
+     */
+    static size_t decodeCommands(const char *response, Command *commands, size_t maxCommands,
+                                 size_t *rejected = nullptr);
+
+    /**
+     * @brief Gets the outbound queue (e.g. to tune its aging limits).
+     * @return Reference to the queue.
+     */
+    OutboundQueue &getOutboundQueue() { return outbound; }
+
+    /**
+     * @brief Serializes a GPS record as JSON, consuming the next record id.
+     * @param gpsData The GPS fix to serialize.
+     * @param buffer Destination for the JSON text.
+     * @param size Size of the destination.
+     * @return Length of the JSON text.
+     */
+    size_t buildGpsPayload(const GpsData &gpsData, char *buffer, size_t size);
+
+    /**
+     * @brief Serializes GPS records as a JSON array, consuming one record id per fix.
+     * @param records The fixes to serialize.
+     * @param count Number of fixes.
+     * @param buffer Destination for the JSON text.
+     * @param size Size of the destination.
+     * @return Length of the JSON text (fixes that did not fit are left out).
+     */
+    size_t buildGpsBatch(const GpsData *records, size_t count, char *buffer, size_t size);
+
+    /**
+     * @brief Serializes an RFID scan as JSON.
+     * @param rfidData The detection to serialize.
+     * @param buffer Destination for the JSON text.
+     * @param size Size of the destination.
+     * @return Length of the JSON text.
+     */
+    size_t buildRfidPayload(const RfidData &rfidData, char *buffer, size_t size) const;
+
     /**
      * @brief Checks WiFi connection status and reconnects if needed.
      */
@@ -97,12 +252,78 @@ public:
      */
     bool isWiFiConnected() const;
 
+    /**
+     * @brief Registers round-trip, byte and reconnect metrics.
+     * @param registry The registry to add the metrics to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
+
+    /**
+     * @brief Attaches a compact metrics snapshot to uploads as an `X-Device-Metrics` header.
+     * A header holds METRICS_HEADER_SIZE bytes of whole entries; successive snapshots rotate
+     * through the registry, so every metric is reported every few uploads.
+     * @param registry The registry to snapshot (nullptr disables piggybacking).
+     * @param intervalMs Minimum time between attached snapshots in milliseconds.
+     */
+    void setMetricsPiggyback(const MetricsRegistry *registry, unsigned long intervalMs);
+
+    /**
+     * @brief Replaces the uplink (e.g. a RecordingTransport for replay).
+     * Call before initialize(); nullptr restores the default HTTP transport.
+     * @param newTransport The transport to upload through.
+     */
+    void setTransport(Transport *newTransport);
+
 private:
+    /**
+     * @brief Appends one fix to a JSON array being built, if it fits whole.
+     * @param gpsData The fix.
+     * @param buffer The array, opened with '['.
+     * @param length Length of the array so far; advanced past the fix if it was added.
+     * @param size Size of the buffer; room is kept for the closing bracket and terminator.
+     * @return True if added, false if it did not fit (its record id is given back).
+     */
+    bool appendGpsRecord(const GpsData &gpsData, char *buffer, size_t &length, size_t size);
+
     /**
      * @brief Generates ISO8601 timestamp.
-     * @return Formatted timestamp string.
+     * @param buffer Destination for the formatted timestamp.
+     * @param size Size of the destination buffer.
+     */
+    void formatISO8601Time(char *buffer, size_t size) const;
+
+    /**
+     * @brief Uploads one JSON payload and logs the outcome.
+     * @param url Destination endpoint.
+     * @param payload JSON text.
+     * @param length Length of the JSON text.
+     * @param roundTrip Histogram receiving the round-trip time.
+     * @param label Log prefix ("GPS" or "RFID").
+     * @return True if the server answered with a 2xx status.
+     */
+    bool upload(const char *url, const char *payload, size_t length, Histogram &roundTrip,
+                const char *label);
+
+    /**
+     * @brief Pops the GPS fixes that can join a batch started by `first` and uploads them.
+     * If the upload fails, the fixes it popped are requeued (`first` is left to the caller).
+     * @param first The fix already taken from the queue.
+     * @return True if the server answered with a 2xx status.
+     */
+    bool sendGpsBatch(const GpsData &first);
+
+    /**
+     * @brief Adds the metrics header to a request when a snapshot is due.
+     * @param request The request being built.
+     * @param snapshot Buffer of METRICS_HEADER_SIZE bytes that holds the header value.
+     */
+    void attachMetrics(TransportRequest &request, char *snapshot);
+
+    /**
+     * @brief Queues the commands carried by a response for nextDownlinkCommand().
+     * @param response Null-terminated response body.
      */
-    String getISO8601Time() const;
+    void collectDownlink(const char *response);
 };
 
 #endif // COMMUNICATION_HANDLER_H
@@ -0,0 +1,347 @@
+/**
+ * @file DeadlineMonitor.cpp
+ * @brief Implements the DeadlineMonitor class.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "DeadlineMonitor.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ESP32
+#include <esp_attr.h>
+#include <esp_system.h>
+#else
+#define RTC_NOINIT_ATTR
+#endif
+
+static const uint32_t POSTMORTEM_MAGIC = 0x444C4D31; // "DLM1"
+
+/**
+ * @brief Post-mortem state kept in RTC memory that is not cleared by a reset.
+ * Shared by every monitor in the firmware; activity ids index the in-flight markers.
+ */
+struct PostMortemStore
+{
+    uint32_t magic;                                  ///< POSTMORTEM_MAGIC once initialized.
+    uint32_t boots;                                  ///< Boots since the store was initialized.
+    uint32_t written;                                ///< Records ever written.
+    DeadlineMiss records[DEADLINE_POSTMORTEM_DEPTH]; ///< Ring of the newest records.
+    bool running[DEADLINE_MAX_ACTIVITIES];           ///< True while a pass is in flight.
+    uint8_t runningPhase[DEADLINE_MAX_ACTIVITIES];   ///< Phase of the pass in flight.
+    uint32_t runningSince[DEADLINE_MAX_ACTIVITIES];  ///< Start of the pass in flight.
+};
+
+static RTC_NOINIT_ATTR PostMortemStore postMortem;
+static std::atomic_flag postMortemLock = ATOMIC_FLAG_INIT;
+static bool postMortemRecovered = false;
+
+/**
+ * @brief Checks whether the last reset interrupted a pass (watchdog or panic).
+ */
+static bool resetInterruptedPass()
+{
+#ifdef ESP32
+    switch (esp_reset_reason())
+    {
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_WDT:
+    case ESP_RST_PANIC:
+        return true;
+    default:
+        return false;
+    }
+#else
+    return false;
+#endif
+}
+
+static void appendPostMortem(const DeadlineMiss &miss)
+{
+    // Violations are rare, and two cores may report one at the same time
+    while (postMortemLock.test_and_set(std::memory_order_acquire))
+    {
+    }
+    postMortem.records[postMortem.written % DEADLINE_POSTMORTEM_DEPTH] = miss;
+    postMortem.written++;
+    postMortemLock.clear(std::memory_order_release);
+}
+
+void DeadlineMonitor::recover()
+{
+    if (postMortemRecovered)
+    {
+        return;
+    }
+    postMortemRecovered = true;
+
+    if (postMortem.magic != POSTMORTEM_MAGIC)
+    {
+        // Power-on: the RTC memory holds garbage
+        memset(&postMortem, 0, sizeof(postMortem));
+        postMortem.magic = POSTMORTEM_MAGIC;
+    }
+    else if (resetInterruptedPass())
+    {
+        for (uint8_t i = 0; i < DEADLINE_MAX_ACTIVITIES; i++)
+        {
+            if (!postMortem.running[i])
+            {
+                continue;
+            }
+            DeadlineMiss miss;
+            miss.activity = i;
+            miss.phase = postMortem.runningPhase[i];
+            miss.reset = true;
+            miss.slipMs = 0;
+            miss.phaseMs = 0;
+            miss.atMs = postMortem.runningSince[i];
+            miss.boot = postMortem.boots;
+            appendPostMortem(miss);
+        }
+    }
+
+    memset(postMortem.running, 0, sizeof(postMortem.running));
+    postMortem.boots++;
+}
+
+uint8_t DeadlineMonitor::postMortemCount()
+{
+    recover();
+    return postMortem.written < DEADLINE_POSTMORTEM_DEPTH ? postMortem.written : DEADLINE_POSTMORTEM_DEPTH;
+}
+
+bool DeadlineMonitor::postMortemRecord(uint8_t index, DeadlineMiss &record)
+{
+    uint8_t count = postMortemCount();
+    if (index >= count)
+    {
+        return false;
+    }
+    record = postMortem.records[(postMortem.written - count + index) % DEADLINE_POSTMORTEM_DEPTH];
+    return true;
+}
+
+void DeadlineMonitor::clearPostMortem()
+{
+    recover();
+    postMortem.written = 0;
+}
+
+uint32_t DeadlineMonitor::bootCount()
+{
+    recover();
+    return postMortem.boots;
+}
+
+DeadlineMonitor::DeadlineMonitor(EventHandler *eventHandler, Clock &clock)
+    : handler(eventHandler), clock(clock), activityCount(0), phaseCount(0),
+      sheddingEnabled(false), lateActivities(0)
+{
+    recover();
+}
+
+int DeadlineMonitor::addActivity(const char *name, unsigned long periodMs, unsigned long sloMs)
+{
+    if (activityCount >= DEADLINE_MAX_ACTIVITIES)
+    {
+        return -1;
+    }
+    Activity &activity = activities[activityCount];
+    activity.name = name;
+    activity.periodMs = periodMs;
+    activity.sloMs = sloMs;
+    activity.startedAt = 0;
+    activity.phaseSince = 0;
+    activity.phase = DEADLINE_NO_PHASE;
+    activity.longestPhase = DEADLINE_NO_PHASE;
+    activity.longestMs = 0;
+    activity.started = false;
+    activity.onTimePasses = 0;
+    return activityCount++;
+}
+
+int DeadlineMonitor::addPhase(const char *name)
+{
+    if (phaseCount >= DEADLINE_MAX_PHASES)
+    {
+        return -1;
+    }
+    phaseNames[phaseCount] = name;
+    return phaseCount++;
+}
+
+void DeadlineMonitor::setPeriod(uint8_t activity, unsigned long periodMs)
+{
+    if (activity < activityCount)
+    {
+        activities[activity].periodMs = periodMs;
+    }
+}
+
+bool DeadlineMonitor::beginPass(uint8_t activity)
+{
+    if (activity >= activityCount)
+    {
+        return true;
+    }
+    Activity &current = activities[activity];
+    unsigned long now = clock.nowMs();
+    uint32_t bit = 1u << activity;
+    bool onTime = true;
+
+    if (current.started)
+    {
+        long slip = static_cast<long>(now - current.startedAt - current.periodMs);
+        uint32_t late = slip > 0 ? static_cast<uint32_t>(slip) : 0;
+        slipMs.record(late);
+
+        if (late > current.sloMs)
+        {
+            onTime = false;
+            current.onTimePasses = 0;
+            lateActivities.fetch_or(bit, std::memory_order_relaxed);
+            violations[activity].add();
+
+            // The pass before this one is what made it late
+            DeadlineMiss miss;
+            miss.activity = activity;
+            miss.phase = current.longestPhase;
+            miss.reset = false;
+            miss.slipMs = late;
+            miss.phaseMs = current.longestMs;
+            miss.atMs = now;
+            miss.boot = postMortem.boots;
+            appendPostMortem(miss);
+            if (handler != nullptr)
+            {
+                handler->on(Event(DEADLINE_MISSED_EVENT_ID, miss, now));
+            }
+        }
+        else if ((lateActivities.load(std::memory_order_relaxed) & bit) &&
+                 ++current.onTimePasses >= DEADLINE_RECOVERY_PASSES)
+        {
+            lateActivities.fetch_and(~bit, std::memory_order_relaxed);
+        }
+    }
+
+    current.started = true;
+    current.startedAt = now;
+    current.phaseSince = now;
+    current.phase = DEADLINE_NO_PHASE;
+    current.longestPhase = DEADLINE_NO_PHASE;
+    current.longestMs = 0;
+    postMortem.runningPhase[activity] = DEADLINE_NO_PHASE;
+    postMortem.runningSince[activity] = now;
+    postMortem.running[activity] = true;
+
+    shedding.set(isShedding() ? 1 : 0);
+    return onTime;
+}
+
+void DeadlineMonitor::closePhase(Activity &activity, unsigned long nowMs)
+{
+    unsigned long spent = nowMs - activity.phaseSince;
+    if (activity.phase != DEADLINE_NO_PHASE && spent >= activity.longestMs)
+    {
+        activity.longestPhase = activity.phase;
+        activity.longestMs = spent;
+    }
+    activity.phaseSince = nowMs;
+}
+
+void DeadlineMonitor::enterPhase(uint8_t activity, uint8_t phase)
+{
+    if (activity >= activityCount)
+    {
+        return;
+    }
+    Activity &current = activities[activity];
+    closePhase(current, clock.nowMs());
+    current.phase = phase;
+    postMortem.runningPhase[activity] = phase;
+}
+
+void DeadlineMonitor::endPass(uint8_t activity)
+{
+    if (activity >= activityCount)
+    {
+        return;
+    }
+    Activity &current = activities[activity];
+    closePhase(current, clock.nowMs());
+    current.phase = DEADLINE_NO_PHASE;
+    postMortem.running[activity] = false;
+}
+
+void DeadlineMonitor::setLoadShedding(bool enabled)
+{
+    sheddingEnabled = enabled;
+}
+
+bool DeadlineMonitor::isShedding() const
+{
+    return sheddingEnabled && lateActivities.load(std::memory_order_relaxed) != 0;
+}
+
+const char *DeadlineMonitor::activityName(uint8_t activity) const
+{
+    return activity < activityCount ? activities[activity].name : "?";
+}
+
+const char *DeadlineMonitor::phaseName(uint8_t phase) const
+{
+    return phase < phaseCount ? phaseNames[phase] : "-";
+}
+
+void DeadlineMonitor::registerMetrics(MetricsRegistry &registry)
+{
+    registry.add("deadline.violations", violations, DEADLINE_MAX_ACTIVITIES);
+    registry.add("deadline.slip_ms", slipMs);
+    registry.add("deadline.shedding", shedding);
+}
+
+void DeadlineMonitor::printPostMortem(Print &out) const
+{
+    char line[96];
+    uint8_t count = postMortemCount();
+    for (uint8_t i = 0; i < count; i++)
+    {
+        DeadlineMiss miss = {};
+        if (!postMortemRecord(i, miss))
+        {
+            continue; // Cleared or overwritten since postMortemCount() was read
+        }
+        if (miss.reset)
+        {
+            snprintf(line, sizeof(line), "Post-mortem boot %lu: %s reset during %s (pass started at %lu ms)",
+                     static_cast<unsigned long>(miss.boot), activityName(miss.activity),
+                     phaseName(miss.phase), static_cast<unsigned long>(miss.atMs));
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "Post-mortem boot %lu: %s %lu ms late at %lu ms (%s %lu ms)",
+                     static_cast<unsigned long>(miss.boot), activityName(miss.activity),
+                     static_cast<unsigned long>(miss.slipMs), static_cast<unsigned long>(miss.atMs),
+                     phaseName(miss.phase), static_cast<unsigned long>(miss.phaseMs));
+        }
+        out.println(line);
+    }
+}
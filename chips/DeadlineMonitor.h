@@ -0,0 +1,203 @@
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+/**
+ * @file DeadlineMonitor.h
+ * @brief Declares the DeadlineMonitor class.
+ *
+ * Watches the cadence of periodic activities (the device's update pass, its ingest and network
+ * tasks). Every pass reports its start; the monitor compares it with the previous start plus the
+ * activity's period, and the difference is the deadline slip. A slip over the activity's SLO is a
+ * violation: it is counted, published as DEADLINE_MISSED_EVENT, blamed on the phase that ran
+ * longest in the pass before it, and appended to a small post-mortem ring. While any activity is
+ * in violation the monitor reports that non-critical work should be shed, until the activity has
+ * run on time for DEADLINE_RECOVERY_PASSES passes.
+ *
+ * On the ESP32 the post-mortem ring lives in RTC memory that is not initialized at boot, so it
+ * survives a watchdog reset. A pass still running when a watchdog or panic reset hit is recorded
+ * at the next boot, with the phase it was in.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "EventHandler.h"
+#include "Metrics.h"
+#include "Clock.h"
+#include <atomic>
+
+class Print;
+
+#define DEADLINE_MAX_ACTIVITIES 4   ///< Periodic activities a monitor can watch.
+#define DEADLINE_MAX_PHASES 8       ///< Named phases a monitor can blame.
+#define DEADLINE_POSTMORTEM_DEPTH 8 ///< Violations kept across resets (oldest are overwritten).
+#define DEADLINE_RECOVERY_PASSES 3  ///< On-time passes that end an activity's violation.
+#define DEADLINE_NO_PHASE 0xFF      ///< Phase of a record when no phase was marked.
+
+/**
+ * @brief One SLO violation: the payload of DEADLINE_MISSED_EVENT and a post-mortem record.
+ */
+struct DeadlineMiss
+{
+    uint8_t activity; ///< Activity that started late.
+    uint8_t phase;    ///< Longest phase of the pass before (or the phase running at a reset).
+    bool reset;       ///< True if the pass never finished because the chip was reset.
+    uint32_t slipMs;  ///< Start delay beyond the period, in milliseconds (0 for a reset).
+    uint32_t phaseMs; ///< Time spent in the blamed phase, in milliseconds.
+    uint32_t atMs;    ///< Clock time the violation was detected (or the reset pass started).
+    uint32_t boot;    ///< Boot the violation happened in.
+};
+
+/**
+ * @brief Deadline slip monitor for periodic activities.
+ * Each activity must be driven by a single task; different activities may run on different cores.
+ */
+class DeadlineMonitor
+{
+private:
+    struct Activity
+    {
+        const char *name;
+        unsigned long periodMs;
+        unsigned long sloMs;
+        unsigned long startedAt;  ///< Start of the current (or last) pass.
+        unsigned long phaseSince; ///< Start of the current phase.
+        uint8_t phase;            ///< Current phase.
+        uint8_t longestPhase;     ///< Longest phase of the pass so far.
+        unsigned long longestMs;  ///< Duration of the longest phase.
+        bool started;             ///< True once the first pass has begun.
+        uint8_t onTimePasses;     ///< On-time passes since the last violation.
+    };
+
+    EventHandler *handler;
+    Clock &clock;
+    Activity activities[DEADLINE_MAX_ACTIVITIES];
+    uint8_t activityCount;
+    const char *phaseNames[DEADLINE_MAX_PHASES];
+    uint8_t phaseCount;
+    bool sheddingEnabled;
+    std::atomic<uint32_t> lateActivities; ///< One bit per activity still in violation.
+
+    Counter violations[DEADLINE_MAX_ACTIVITIES]; ///< SLO violations per activity.
+    Histogram slipMs;                            ///< Start delay of every pass, in milliseconds.
+    Gauge shedding;                              ///< 1 while work is being shed.
+
+    void closePhase(Activity &activity, unsigned long nowMs);
+
+public:
+    static const int DEADLINE_MISSED_EVENT_ID = 13; ///< Published on every SLO violation.
+
+    /**
+     * @brief Constructs a monitor.
+     * @param eventHandler Receives DEADLINE_MISSED_EVENT, from the task running the late activity
+     *                     (default: nullptr).
+     * @param clock Time source (default: the system clock).
+     */
+    explicit DeadlineMonitor(EventHandler *eventHandler = nullptr,
+                             Clock &clock = SystemClock::instance());
+
+    /**
+     * @brief Registers a periodic activity.
+     * @param name Static activity name.
+     * @param periodMs Expected time between pass starts.
+     * @param sloMs Largest acceptable slip in milliseconds.
+     * @return Activity id, or -1 if the monitor is full.
+     */
+    int addActivity(const char *name, unsigned long periodMs, unsigned long sloMs);
+
+    /**
+     * @brief Registers a phase that a late pass can be blamed on.
+     * @param name Static phase name.
+     * @return Phase id, or -1 if the monitor is full.
+     */
+    int addPhase(const char *name);
+
+    /**
+     * @brief Changes an activity's period (e.g. when its interval is reconfigured).
+     * @param activity Activity id.
+     * @param periodMs Expected time between pass starts.
+     */
+    void setPeriod(uint8_t activity, unsigned long periodMs);
+
+    /**
+     * @brief Marks the start of a pass and checks how late it is.
+     * @param activity Activity id.
+     * @return True if the pass started within the activity's SLO.
+     */
+    bool beginPass(uint8_t activity);
+
+    /**
+     * @brief Marks the phase the pass is entering; time until the next mark is charged to it.
+     * @param activity Activity id.
+     * @param phase Phase id.
+     */
+    void enterPhase(uint8_t activity, uint8_t phase);
+
+    /**
+     * @brief Marks the end of a pass.
+     * @param activity Activity id.
+     */
+    void endPass(uint8_t activity);
+
+    /**
+     * @brief Enables load shedding; isShedding() stays false while it is disabled.
+     * @param enabled True to shed non-critical work during violations.
+     */
+    void setLoadShedding(bool enabled);
+
+    /**
+     * @brief Checks whether non-critical work should be skipped or deferred.
+     * @return True if shedding is enabled and an activity is in violation.
+     */
+    bool isShedding() const;
+
+    const char *activityName(uint8_t activity) const; ///< Name of an activity ("?" if unknown).
+    const char *phaseName(uint8_t phase) const;       ///< Name of a phase ("-" if unknown).
+
+    /**
+     * @brief Registers the monitor's metrics (`deadline.violations` per activity,
+     * `deadline.slip_ms` and `deadline.shedding`).
+     * @param registry The registry to add them to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
+
+    /**
+     * @brief Prints the post-mortem ring, oldest first, naming activities and phases.
+     * @param out Destination (e.g. Serial).
+     */
+    void printPostMortem(Print &out) const;
+
+    /**
+     * @brief Validates the post-mortem ring after a reset and starts a new boot.
+     * Records the pass a watchdog or panic reset interrupted. Runs once; later calls do nothing.
+     */
+    static void recover();
+
+    static uint8_t postMortemCount(); ///< Records in the post-mortem ring.
+
+    /**
+     * @brief Copies a post-mortem record.
+     * @param index 0 for the oldest record.
+     * @param record Destination.
+     * @return True if the record exists.
+     */
+    static bool postMortemRecord(uint8_t index, DeadlineMiss &record);
+
+    static void clearPostMortem(); ///< Empties the post-mortem ring.
+    static uint32_t bootCount();   ///< Boots recorded since the ring was created.
+};
+
+#endif // DEADLINE_MONITOR_H
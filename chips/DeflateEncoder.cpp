@@ -0,0 +1,318 @@
+/**
+ * @file DeflateEncoder.cpp
+ * @brief Implements the DeflateEncoder class.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "DeflateEncoder.h"
+#include <string.h>
+
+static_assert(DEFLATE_WINDOW_BITS >= 9 && DEFLATE_WINDOW_BITS <= 14,
+              "DEFLATE_WINDOW_BITS must be 9..14 (a full lookahead must fit, positions are 16-bit)");
+
+// RFC 1951 section 3.2.5: base values and extra bits of the length and distance codes
+static const uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+                                         31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                         2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+                                           193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+                                           6145, 8193, 12289, 16385, 24577};
+static const uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                           6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static const uint16_t END_OF_BLOCK = 256;
+static const uint32_t ADLER_MODULUS = 65521;
+static const size_t ADLER_CHUNK = 5552; ///< Longest run before the Adler-32 sums can overflow.
+
+static inline uint16_t hashAt(const uint8_t *bytes)
+{
+    return ((bytes[0] << 6) ^ (bytes[1] << 3) ^ bytes[2]) & ((1 << DEFLATE_HASH_BITS) - 1);
+}
+
+DeflateEncoder::DeflateEncoder()
+    : position(0), end(0), output(nullptr), capacity(0), written(0), overflowed(false),
+      bitBuffer(0), bitCount(0), adlerA(1), adlerB(0)
+{
+}
+
+void DeflateEncoder::begin(uint8_t *destination, size_t destinationSize)
+{
+    output = destination;
+    capacity = destinationSize;
+    written = 0;
+    overflowed = false;
+    bitBuffer = 0;
+    bitCount = 0;
+    adlerA = 1;
+    adlerB = 0;
+    position = 0;
+    end = 0;
+    for (size_t i = 0; i < sizeof(head) / sizeof(head[0]); i++)
+    {
+        head[i] = NO_POSITION;
+    }
+
+    // zlib header: deflate with the window we actually use, and a check value for the pair
+    uint8_t cmf = 0x08 | ((DEFLATE_WINDOW_BITS - 8) << 4);
+    uint8_t flg = (31 - (cmf * 256) % 31) % 31;
+    putByte(cmf);
+    putByte(flg);
+
+    // One fixed-Huffman block: BFINAL = 0, BTYPE = 01
+    putBits(0, 1);
+    putBits(1, 2);
+}
+
+void DeflateEncoder::write(const void *data, size_t length)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    while (length > 0 && !overflowed)
+    {
+        size_t chunk = 2 * DEFLATE_WINDOW_SIZE - end;
+        if (chunk > length)
+        {
+            chunk = length;
+        }
+        if (chunk > ADLER_CHUNK)
+        {
+            chunk = ADLER_CHUNK;
+        }
+        memcpy(window + end, bytes, chunk);
+        for (size_t i = 0; i < chunk; i++)
+        {
+            adlerA += bytes[i];
+            adlerB += adlerA;
+        }
+        adlerA %= ADLER_MODULUS;
+        adlerB %= ADLER_MODULUS;
+
+        end += chunk;
+        bytes += chunk;
+        length -= chunk;
+
+        encode(false);
+        if (end == 2 * DEFLATE_WINDOW_SIZE && !overflowed)
+        {
+            slide();
+        }
+    }
+}
+
+size_t DeflateEncoder::finish()
+{
+    encode(true);
+    putCode(0, 7); // END_OF_BLOCK has the 7-bit fixed code 0000000
+
+    // An empty final block closes the stream
+    putBits(1, 1);
+    putBits(1, 2);
+    putCode(0, 7);
+    if (bitCount > 0)
+    {
+        putByte(static_cast<uint8_t>(bitBuffer));
+        bitBuffer = 0;
+        bitCount = 0;
+    }
+
+    uint32_t adler = (adlerB << 16) | adlerA;
+    putByte(adler >> 24);
+    putByte(adler >> 16);
+    putByte(adler >> 8);
+    putByte(adler);
+    return overflowed ? 0 : written;
+}
+
+void DeflateEncoder::putByte(uint8_t byte)
+{
+    if (written < capacity)
+    {
+        output[written++] = byte;
+    }
+    else
+    {
+        overflowed = true;
+    }
+}
+
+void DeflateEncoder::putBits(uint32_t value, uint8_t count)
+{
+    bitBuffer |= value << bitCount;
+    bitCount += count;
+    while (bitCount >= 8)
+    {
+        putByte(static_cast<uint8_t>(bitBuffer));
+        bitBuffer >>= 8;
+        bitCount -= 8;
+    }
+}
+
+void DeflateEncoder::putCode(uint32_t code, uint8_t length)
+{
+    // Huffman codes are sent most significant bit first, unlike every other field
+    uint32_t reversed = 0;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    putBits(reversed, length);
+}
+
+void DeflateEncoder::putLiteral(uint8_t literal)
+{
+    if (literal < 144)
+    {
+        putCode(0x30 + literal, 8);
+    }
+    else
+    {
+        putCode(0x190 + literal - 144, 9);
+    }
+}
+
+void DeflateEncoder::putMatch(uint16_t length, uint16_t distance)
+{
+    uint8_t lengthIndex = 0;
+    while (lengthIndex < 28 && LENGTH_BASE[lengthIndex + 1] <= length)
+    {
+        lengthIndex++;
+    }
+    uint16_t symbol = END_OF_BLOCK + 1 + lengthIndex;
+    if (symbol < 280)
+    {
+        putCode(symbol - 256, 7);
+    }
+    else
+    {
+        putCode(0xC0 + symbol - 280, 8);
+    }
+    putBits(length - LENGTH_BASE[lengthIndex], LENGTH_EXTRA[lengthIndex]);
+
+    uint8_t distanceIndex = 0;
+    while (distanceIndex < 29 && DISTANCE_BASE[distanceIndex + 1] <= distance)
+    {
+        distanceIndex++;
+    }
+    putCode(distanceIndex, 5);
+    putBits(distance - DISTANCE_BASE[distanceIndex], DISTANCE_EXTRA[distanceIndex]);
+}
+
+void DeflateEncoder::insertHash(uint16_t at)
+{
+    if (at + DEFLATE_MIN_MATCH > end)
+    {
+        return;
+    }
+    uint16_t hash = hashAt(window + at);
+    previous[at & (DEFLATE_WINDOW_SIZE - 1)] = head[hash];
+    head[hash] = at;
+}
+
+uint16_t DeflateEncoder::longestMatch(uint16_t &distance) const
+{
+    uint16_t available = end - position;
+    if (available < DEFLATE_MIN_MATCH)
+    {
+        return 0;
+    }
+    uint16_t limit = available < DEFLATE_MAX_MATCH ? available : DEFLATE_MAX_MATCH;
+    const uint8_t *current = window + position;
+
+    uint16_t best = 0;
+    uint16_t candidate = head[hashAt(current)];
+    for (uint8_t tries = 0; tries < DEFLATE_MAX_CHAIN && candidate != NO_POSITION; tries++)
+    {
+        if (candidate >= position || position - candidate >= DEFLATE_WINDOW_SIZE)
+        {
+            break;
+        }
+        const uint8_t *earlier = window + candidate;
+        if (earlier[best] == current[best] && earlier[0] == current[0])
+        {
+            uint16_t length = 0;
+            while (length < limit && earlier[length] == current[length])
+            {
+                length++;
+            }
+            if (length > best)
+            {
+                best = length;
+                distance = position - candidate;
+                if (best == limit)
+                {
+                    break;
+                }
+            }
+        }
+
+        // A slot reused by a newer position ends the chain
+        uint16_t next = previous[candidate & (DEFLATE_WINDOW_SIZE - 1)];
+        if (next != NO_POSITION && next >= candidate)
+        {
+            break;
+        }
+        candidate = next;
+    }
+    return best >= DEFLATE_MIN_MATCH ? best : 0;
+}
+
+void DeflateEncoder::encode(bool flush)
+{
+    // Without flush, keep a full match of lookahead so no match is cut short by a write boundary
+    uint16_t lookahead = flush ? 1 : DEFLATE_MAX_MATCH;
+    while (end - position >= lookahead && !overflowed)
+    {
+        uint16_t distance = 0;
+        uint16_t length = longestMatch(distance);
+        if (length > 0)
+        {
+            putMatch(length, distance);
+            for (uint16_t i = 0; i < length; i++)
+            {
+                insertHash(position + i);
+            }
+            position += length;
+        }
+        else
+        {
+            putLiteral(window[position]);
+            insertHash(position);
+            position++;
+        }
+    }
+}
+
+void DeflateEncoder::slide()
+{
+    // Keep the newest window of history; every stored position moves down by the same amount
+    memmove(window, window + DEFLATE_WINDOW_SIZE, DEFLATE_WINDOW_SIZE);
+    position -= DEFLATE_WINDOW_SIZE;
+    end -= DEFLATE_WINDOW_SIZE;
+    for (size_t i = 0; i < sizeof(head) / sizeof(head[0]); i++)
+    {
+        head[i] = head[i] != NO_POSITION && head[i] >= DEFLATE_WINDOW_SIZE
+                      ? head[i] - DEFLATE_WINDOW_SIZE
+                      : NO_POSITION;
+    }
+    for (size_t i = 0; i < DEFLATE_WINDOW_SIZE; i++)
+    {
+        previous[i] = previous[i] != NO_POSITION && previous[i] >= DEFLATE_WINDOW_SIZE
+                          ? previous[i] - DEFLATE_WINDOW_SIZE
+                          : NO_POSITION;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef DEFLATE_ENCODER_H
+#define DEFLATE_ENCODER_H
+
+/**
+ * @file DeflateEncoder.h
+ * @brief Declares the DeflateEncoder class.
+ *
+ * A streaming zlib (RFC 1950) / deflate (RFC 1951) compressor sized for the ESP32. It keeps a
+ * small sliding window (DEFLATE_WINDOW_SIZE bytes of history, twice that of buffer), finds
+ * matches through bounded hash chains and emits a single fixed-Huffman block, so there are no
+ * dynamic tables to build or store. Output is the `Content-Encoding: deflate` format any zlib
+ * can inflate. All state is inline (about 5 KB); nothing touches the heap.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DEFLATE_WINDOW_BITS 10                        ///< log2 of the history window (9..14).
+#define DEFLATE_WINDOW_SIZE (1 << DEFLATE_WINDOW_BITS) ///< Longest match distance plus one.
+#define DEFLATE_HASH_BITS 9                           ///< log2 of the hash table size.
+#define DEFLATE_MAX_CHAIN 8                           ///< Candidates tried per position.
+#define DEFLATE_MIN_MATCH 3                           ///< Shortest match deflate can encode.
+#define DEFLATE_MAX_MATCH 258                         ///< Longest match deflate can encode.
+
+class DeflateEncoder
+{
+private:
+    static const uint16_t NO_POSITION = 0xFFFF;
+
+    uint8_t window[2 * DEFLATE_WINDOW_SIZE];        ///< History followed by unprocessed input.
+    uint16_t head[1 << DEFLATE_HASH_BITS];          ///< Latest position of each 3-byte hash.
+    uint16_t previous[DEFLATE_WINDOW_SIZE];         ///< Older positions with the same hash.
+    uint16_t position;                              ///< Next byte to encode.
+    uint16_t end;                                   ///< End of the input in the window.
+
+    uint8_t *output;
+    size_t capacity;
+    size_t written;
+    bool overflowed;
+    uint32_t bitBuffer;
+    uint8_t bitCount;
+    uint32_t adlerA;
+    uint32_t adlerB;
+
+    void putByte(uint8_t byte);
+    void putBits(uint32_t value, uint8_t count);
+    void putCode(uint32_t code, uint8_t length);
+    void putLiteral(uint8_t literal);
+    void putMatch(uint16_t length, uint16_t distance);
+    void insertHash(uint16_t at);
+    uint16_t longestMatch(uint16_t &distance) const;
+    void encode(bool flush);
+    void slide();
+
+public:
+    DeflateEncoder();
+
+    /**
+     * @brief Starts a new zlib stream.
+     * @param destination Buffer receiving the compressed stream.
+     * @param destinationSize Size of the buffer.
+     */
+    void begin(uint8_t *destination, size_t destinationSize);
+
+    /**
+     * @brief Compresses more input; may be called any number of times.
+     * @param data Input bytes.
+     * @param length Number of input bytes.
+     */
+    void write(const void *data, size_t length);
+
+    /**
+     * @brief Encodes the remaining input and closes the stream.
+     * @return Length of the compressed stream, or 0 if it did not fit the buffer.
+     */
+    size_t finish();
+};
+
+#endif // DEFLATE_ENCODER_H
@@ -0,0 +1,173 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+/**
+ * @file EventBus.h
+ * @brief Declares the EventBus template.
+ *
+ * A statically sized publish/subscribe hub for the Modest IoT Nano-framework. A sensor is given
+ * the bus as its single EventHandler and the bus fans each event out to every subscriber whose
+ * topic mask includes the event id, either directly or through a per-subscriber queue that the
+ * subscriber drains in its own context. All storage is fixed at compile time.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "EventHandler.h"
+#include "BoundedQueue.h"
+#include "Metrics.h"
+
+#define EVENT_BUS_TOPICS 32 ///< Event ids 0..31 can be published on the bus, one mask bit each.
+
+/**
+ * @brief Fans events out to up to `MaxSubscribers` handlers.
+ * @tparam MaxSubscribers Maximum number of subscriptions.
+ * @tparam QueueDepth Depth of each optional per-subscriber queue (power of two).
+ */
+template <size_t MaxSubscribers, size_t QueueDepth = 8>
+class EventBus : public EventHandler {
+public:
+    using SubscriberQueue = BoundedQueue<Event, QueueDepth>; ///< Queue type for deferred delivery.
+
+private:
+    struct Subscription {
+        EventHandler* handler;
+        uint32_t topicMask;
+        SubscriberQueue* queue;
+    };
+
+    Subscription subscriptions[MaxSubscribers]; ///< Registered subscribers.
+    uint8_t subscriptionCount; ///< Number of entries in use.
+    uint8_t topicSubscribers[EVENT_BUS_TOPICS][MaxSubscribers]; ///< Per-topic subscriber indices.
+    uint8_t topicCounts[EVENT_BUS_TOPICS]; ///< Number of subscribers per topic.
+    uint32_t unrouted; ///< Events published with an id outside the topic range.
+    Counter published[EVENT_BUS_TOPICS]; ///< Events published per topic.
+
+    void indexSubscription(uint8_t index) {
+        uint32_t mask = subscriptions[index].topicMask;
+        for (int topic = 0; topic < EVENT_BUS_TOPICS; topic++) {
+            if (mask & (1u << topic)) {
+                topicSubscribers[topic][topicCounts[topic]++] = index;
+            }
+        }
+    }
+
+    void rebuildIndex() {
+        memset(topicCounts, 0, sizeof(topicCounts));
+        for (uint8_t i = 0; i < subscriptionCount; i++) {
+            indexSubscription(i);
+        }
+    }
+
+public:
+    static_assert(MaxSubscribers > 0 && MaxSubscribers < 256, "EventBus supports 1..255 subscribers");
+
+    EventBus() : subscriptionCount(0), unrouted(0) {
+        memset(topicCounts, 0, sizeof(topicCounts));
+    }
+
+    /**
+     * @brief Gets the mask bit for an event id.
+     * @param eventId Event id in the range 0..EVENT_BUS_TOPICS-1.
+     * @return The topic mask with only that event's bit set.
+     */
+    static constexpr uint32_t topic(int eventId) {
+        return 1u << eventId;
+    }
+
+    /**
+     * @brief Subscribes a handler to every topic in a mask.
+     * @param handler The handler to call on publish.
+     * @param topicMask Bitwise OR of `topic(eventId)` values.
+     * @param queue Optional queue; if set, events are queued instead of delivered immediately.
+     * @return True if subscribed, false if the bus is full.
+     */
+    bool subscribe(EventHandler* handler, uint32_t topicMask, SubscriberQueue* queue = nullptr) {
+        if (handler == nullptr || subscriptionCount >= MaxSubscribers) {
+            return false;
+        }
+        subscriptions[subscriptionCount] = Subscription{handler, topicMask, queue};
+        indexSubscription(subscriptionCount);
+        subscriptionCount++;
+        return true;
+    }
+
+    /**
+     * @brief Removes every subscription of a handler.
+     * @param handler The handler to remove.
+     */
+    void unsubscribe(EventHandler* handler) {
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < subscriptionCount; i++) {
+            if (subscriptions[i].handler != handler) {
+                subscriptions[kept++] = subscriptions[i];
+            }
+        }
+        subscriptionCount = kept;
+        rebuildIndex();
+    }
+
+    /**
+     * @brief Publishes an event to the subscribers of its topic.
+     * Cost is proportional to the number of subscribers on that topic.
+     * @param event The event to publish.
+     */
+    void on(Event event) override {
+        if (event.id < 0 || event.id >= EVENT_BUS_TOPICS) {
+            unrouted++;
+            return;
+        }
+        published[event.id].add();
+        const uint8_t* indices = topicSubscribers[event.id];
+        for (uint8_t i = 0; i < topicCounts[event.id]; i++) {
+            Subscription& subscription = subscriptions[indices[i]];
+            if (subscription.queue != nullptr) {
+                subscription.queue->push(event);
+            } else {
+                subscription.handler->on(event);
+            }
+        }
+    }
+
+    /**
+     * @brief Delivers the events queued for a handler.
+     * Call from the subscriber's own context (task or loop).
+     * @param handler The queued subscriber to drain.
+     * @return Number of events delivered.
+     */
+    size_t drain(EventHandler* handler) {
+        size_t delivered = 0;
+        for (uint8_t i = 0; i < subscriptionCount; i++) {
+            Subscription& subscription = subscriptions[i];
+            if (subscription.handler != handler || subscription.queue == nullptr) {
+                continue;
+            }
+            Event event(0);
+            while (subscription.queue->pop(event)) {
+                handler->on(event);
+                delivered++;
+            }
+        }
+        return delivered;
+    }
+
+    size_t subscriberCount() const { return subscriptionCount; } ///< Number of subscriptions.
+    uint32_t unroutedCount() const { return unrouted; } ///< Events dropped for an out-of-range id.
+    const Counter* publishedCounters() const { return published; } ///< Per-topic publish counts, indexed by event id.
+};
+
+#endif // EVENT_BUS_H
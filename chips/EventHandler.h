@@ -26,16 +26,71 @@
  * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
  */
 
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#ifndef EVENT_PAYLOAD_SIZE
+#define EVENT_PAYLOAD_SIZE 48 ///< Bytes of inline payload carried by every Event.
+#endif
+
 /**
- * @brief Represents an event with a unique identifier.
+ * @brief Represents an event with a unique identifier and an optional inline payload.
  * 
  * Events are lightweight structs used to signal occurrences (e.g., sensor triggers) within
  * the framework. Define custom events by assigning unique IDs in your application.
+ * 
+ * Sensor data travels with the event by value in a fixed-size buffer, stamped with the time it
+ * was captured, so handlers never need to call back into the sensor for the "latest" reading.
+ * Payload types must be trivially copyable and fit in `EVENT_PAYLOAD_SIZE` bytes.
  */
 struct Event {
     int id; ///< Unique identifier for the event type.
+    unsigned long timestamp; ///< Capture time in milliseconds (0 if the event carries no data).
+    uint8_t payloadSize; ///< Number of payload bytes in use (0 if none).
+    alignas(8) uint8_t payload[EVENT_PAYLOAD_SIZE]; ///< Inline payload storage.
+
+    explicit Event(int eventId) : id(eventId), timestamp(0), payloadSize(0) {}
+
+    /**
+     * @brief Constructs an event carrying a copy of the given data.
+     * @param eventId The event type identifier.
+     * @param data The payload to copy into the event.
+     * @param capturedAt Time the data was captured, in milliseconds.
+     */
+    template <typename T>
+    Event(int eventId, const T& data, unsigned long capturedAt)
+        : id(eventId), timestamp(capturedAt), payloadSize(0) {
+        setPayload(data);
+    }
+
+    /**
+     * @brief Copies a value into the inline payload.
+     * @param data The value to store.
+     */
+    template <typename T>
+    void setPayload(const T& data) {
+        static_assert(std::is_trivially_copyable<T>::value, "Event payloads must be trivially copyable");
+        static_assert(sizeof(T) <= EVENT_PAYLOAD_SIZE, "Event payload exceeds EVENT_PAYLOAD_SIZE");
+        memcpy(payload, &data, sizeof(T));
+        payloadSize = sizeof(T);
+    }
+
+    /**
+     * @brief Copies the inline payload out of the event.
+     * @param out Destination for the payload.
+     * @return True if the event carries a payload of type T's size, false otherwise.
+     */
+    template <typename T>
+    bool getPayload(T& out) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Event payloads must be trivially copyable");
+        if (payloadSize != sizeof(T)) {
+            return false;
+        }
+        memcpy(&out, payload, sizeof(T));
+        return true;
+    }
 
-    explicit Event(int eventId) : id(eventId) {}
     bool operator==(const Event& other) const { return id == other.id; }
 };
 
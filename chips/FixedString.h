@@ -0,0 +1,80 @@
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+/**
+ * @file FixedString.h
+ * @brief Declares the FixedString template.
+ *
+ * A fixed-capacity, null-terminated string for configuration values (credentials, URLs, ids)
+ * in the Modest IoT Nano-framework. Unlike Arduino `String` it never allocates, so long-running
+ * devices do not fragment the heap; values longer than the capacity are truncated.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Null-terminated string stored inline with room for `Capacity - 1` characters.
+ */
+template <size_t Capacity>
+class FixedString {
+    static_assert(Capacity > 1, "FixedString needs room for at least one character");
+
+private:
+    char buffer[Capacity]; ///< Character storage, always null-terminated.
+
+public:
+    FixedString() { buffer[0] = '\0'; }
+
+    FixedString(const char* value) { assign(value); }
+
+    /**
+     * @brief Replaces the contents, truncating to the capacity.
+     * @param value Null-terminated source string (nullptr clears the string).
+     * @return True if the whole value fit, false if it was truncated.
+     */
+    bool assign(const char* value) {
+        if (value == nullptr) {
+            buffer[0] = '\0';
+            return true;
+        }
+        size_t length = strnlen(value, Capacity);
+        bool fits = length < Capacity;
+        if (!fits) {
+            length = Capacity - 1;
+        }
+        memcpy(buffer, value, length);
+        buffer[length] = '\0';
+        return fits;
+    }
+
+    FixedString& operator=(const char* value) {
+        assign(value);
+        return *this;
+    }
+
+    const char* c_str() const { return buffer; } ///< Null-terminated contents.
+    size_t length() const { return strlen(buffer); } ///< Number of characters stored.
+    bool isEmpty() const { return buffer[0] == '\0'; } ///< True if no characters are stored.
+    static constexpr size_t capacity() { return Capacity - 1; } ///< Maximum number of characters.
+
+    bool operator==(const char* other) const { return other != nullptr && strcmp(buffer, other) == 0; }
+};
+
+#endif // FIXED_STRING_H
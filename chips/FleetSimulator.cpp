@@ -0,0 +1,275 @@
+/**
+ * @file FleetSimulator.cpp
+ * @brief Implements the SimulatedDevice and FleetRunner classes.
+ *
+ * Lockstep stepping of a simulated fleet. Off the ESP32, persistent worker threads claim chunks
+ * of devices from a shared cursor at every step, so a thread that drew cheap devices simply
+ * claims more; a barrier closes each step before simulated time moves on.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "FleetSimulator.h"
+#include <Arduino.h>
+#include <stdio.h>
+
+#ifndef ESP32
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+// Same pins as the sketch; only the inputs that replace them are ever read
+#define FLEET_GPS_RX_PIN 16
+#define FLEET_GPS_TX_PIN 17
+#define FLEET_RFID_PIN 21
+#define FLEET_LED_PIN 2
+
+/**
+ * @brief Mixes a fleet seed and a device index into a non-zero per-device seed.
+ */
+static uint32_t deviceSeed(uint32_t seed, uint32_t index, uint32_t stream)
+{
+    uint32_t x = seed * 0x9E3779B1u ^ (index + 1) * 0x85EBCA77u ^ stream * 0xC2B2AE3Du;
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    return x != 0 ? x : 1;
+}
+
+/**
+ * @brief Maps a seed onto [-0.5, 0.5).
+ */
+static double centredFraction(uint32_t seed)
+{
+    return (seed % 1000000) / 1000000.0 - 0.5;
+}
+
+const char *SimulatedDevice::formatId(char *buffer, uint32_t index)
+{
+    snprintf(buffer, FLEET_DEVICE_ID_SIZE, "SIM%05lu", static_cast<unsigned long>(index));
+    return buffer;
+}
+
+SimulatedDevice::SimulatedDevice(uint32_t index, const FleetConfig &config, TransportMetrics &metrics)
+    : clock(),
+      route(clock,
+            config.originLatitude + centredFraction(deviceSeed(config.seed, index, 1)) * config.spreadDegrees,
+            config.originLongitude + centredFraction(deviceSeed(config.seed, index, 2)) * config.spreadDegrees,
+            config.speedMps, deviceSeed(config.seed, index, 3), config.fixIntervalMs),
+      recorder(clock),
+#ifndef ESP32
+      // Socket uploads take real time, so their latency is measured on the system clock
+      metered(config.useSockets ? static_cast<Transport &>(socket) : static_cast<Transport &>(recorder), metrics,
+              config.useSockets ? static_cast<Clock &>(SystemClock::instance()) : static_cast<Clock &>(clock)),
+#else
+      metered(recorder, metrics, clock),
+#endif
+      device(FLEET_GPS_RX_PIN, FLEET_GPS_TX_PIN, FLEET_RFID_PIN, FLEET_LED_PIN, "fleet", "",
+             config.trackingUrl, config.rfidUrl, formatId(deviceId, index), clock),
+      scans(*device.getRfidSensor(), clock, config.scanMeanIntervalMs, deviceSeed(config.seed, index, 4))
+{
+    recorder.setLatencyModel(config.uplinkLatencyMs, config.uplinkJitterMs, deviceSeed(config.seed, index, 5));
+    device.getGpsSensor()->setInput(&route);
+    device.getRfidSensor()->setSimulation(false);
+    device.getCommunicationHandler()->setTransport(&metered);
+}
+
+void SimulatedDevice::initialize()
+{
+    device.initialize();
+}
+
+void SimulatedDevice::stepTo(unsigned long elapsedMs)
+{
+    clock.advanceToMs(elapsedMs);
+    scans.update();
+    device.update();
+}
+
+#ifndef ESP32
+namespace
+{
+    /**
+     * @brief State shared by the stepping thread and the workers.
+     */
+    struct FleetStep
+    {
+        SimulatedDevice *devices;
+        size_t count;
+        std::atomic<size_t> cursor;
+        unsigned long target; ///< Simulated time of the current step.
+        uint32_t generation;  ///< Incremented once per step.
+        unsigned busy;        ///< Workers still inside the current step.
+        bool stopping;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+    };
+
+    void stepChunks(FleetStep &step)
+    {
+        for (;;)
+        {
+            size_t first = step.cursor.fetch_add(FLEET_CHUNK_DEVICES, std::memory_order_relaxed);
+            if (first >= step.count)
+            {
+                return;
+            }
+            size_t last = first + FLEET_CHUNK_DEVICES < step.count ? first + FLEET_CHUNK_DEVICES : step.count;
+            for (size_t i = first; i < last; i++)
+            {
+                step.devices[i].stepTo(step.target);
+            }
+        }
+    }
+
+    void workerLoop(FleetStep *step)
+    {
+        uint32_t seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(step->mutex);
+                step->wake.wait(lock, [&] { return step->stopping || step->generation != seen; });
+                if (step->stopping)
+                {
+                    return;
+                }
+                seen = step->generation;
+            }
+            stepChunks(*step);
+            {
+                std::lock_guard<std::mutex> lock(step->mutex);
+                if (--step->busy == 0)
+                {
+                    step->done.notify_one();
+                }
+            }
+        }
+    }
+}
+#endif
+
+void FleetRunner::run(SimulatedDevice *devices, size_t count, TransportMetrics &metrics,
+                      unsigned long durationMs, unsigned long stepMs, unsigned workers, Print &report)
+{
+    if (stepMs == 0)
+    {
+        stepMs = 1;
+    }
+    uint32_t requestsBefore = metrics.requests.get();
+    uint32_t scansBefore = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        scansBefore += devices[i].scanCount();
+    }
+    uint64_t startedUs = SystemClock::instance().nowUs();
+
+#ifndef ESP32
+    if (workers == 0)
+    {
+        workers = std::thread::hardware_concurrency();
+    }
+    if (workers > FLEET_MAX_WORKERS)
+    {
+        workers = FLEET_MAX_WORKERS;
+    }
+    if (workers == 0)
+    {
+        workers = 1;
+    }
+
+    // The calling thread is worker 0; the others wait for each step on the condition variable
+    FleetStep step;
+    step.devices = devices;
+    step.count = count;
+    step.cursor.store(0, std::memory_order_relaxed);
+    step.target = 0;
+    step.generation = 0;
+    step.busy = 0;
+    step.stopping = false;
+    std::thread helpers[FLEET_MAX_WORKERS];
+    for (unsigned i = 1; i < workers; i++)
+    {
+        helpers[i] = std::thread(workerLoop, &step);
+    }
+
+    for (unsigned long elapsed = stepMs; elapsed <= durationMs; elapsed += stepMs)
+    {
+        {
+            std::lock_guard<std::mutex> lock(step.mutex);
+            step.target = elapsed;
+            step.cursor.store(0, std::memory_order_relaxed);
+            step.busy = workers - 1;
+            step.generation++;
+        }
+        step.wake.notify_all();
+        stepChunks(step);
+        std::unique_lock<std::mutex> lock(step.mutex);
+        step.done.wait(lock, [&] { return step.busy == 0; });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(step.mutex);
+        step.stopping = true;
+    }
+    step.wake.notify_all();
+    for (unsigned i = 1; i < workers; i++)
+    {
+        helpers[i].join();
+    }
+#else
+    workers = 1;
+    for (unsigned long elapsed = stepMs; elapsed <= durationMs; elapsed += stepMs)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            devices[i].stepTo(elapsed);
+        }
+    }
+#endif
+
+    uint64_t wallUs = SystemClock::instance().nowUs() - startedUs;
+    uint32_t requests = metrics.requests.get() - requestsBefore;
+    uint32_t scans = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        scans += devices[i].scanCount();
+    }
+    scans -= scansBefore;
+    double simulatedSeconds = durationMs / 1000.0;
+    double wallSeconds = wallUs / 1000000.0;
+
+    char line[400];
+    snprintf(line, sizeof(line),
+             "{\"fleet\":{\"devices\":%lu,\"workers\":%u,\"simulated_s\":%.1f,\"wall_ms\":%.1f,"
+             "\"requests\":%lu,\"scans\":%lu,\"bytes\":%lu,\"errors\":%lu,"
+             "\"requests_per_sim_s\":%.1f,\"requests_per_wall_s\":%.1f,"
+             "\"latency_us\":{\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu}}}",
+             static_cast<unsigned long>(count), workers, simulatedSeconds, wallUs / 1000.0,
+             static_cast<unsigned long>(requests), static_cast<unsigned long>(scans),
+             static_cast<unsigned long>(metrics.bytes.get()), static_cast<unsigned long>(metrics.errors.get()),
+             simulatedSeconds > 0 ? requests / simulatedSeconds : 0.0,
+             wallSeconds > 0 ? requests / wallSeconds : 0.0,
+             static_cast<unsigned long>(metrics.latency.percentile(50)),
+             static_cast<unsigned long>(metrics.latency.percentile(90)),
+             static_cast<unsigned long>(metrics.latency.percentile(99)),
+             static_cast<unsigned long>(metrics.latency.max()));
+    report.println(line);
+}
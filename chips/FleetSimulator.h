@@ -0,0 +1,184 @@
+#ifndef FLEET_SIMULATOR_H
+#define FLEET_SIMULATOR_H
+
+/**
+ * @file FleetSimulator.h
+ * @brief Declares the SimulatedDevice class and the FleetSimulator template.
+ *
+ * Runs many TrackingDevices side by side for the Modest IoT Nano-framework. Each device gets its
+ * own VirtualClock, a SyntheticRoute on its GPS input and a ScanPattern on its RFID sensor, and
+ * uploads through a MeteredTransport that records into one fleet-wide TransportMetrics. Devices
+ * are stepped in lockstep on virtual time, so an hour of fleet traffic takes as long as the CPU
+ * needs for it rather than an hour. Off the ESP32 the steps are spread over worker threads.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "TrackingDevice.h"
+#include "SyntheticRoute.h"
+#include "ScanPattern.h"
+#include "RecordingTransport.h"
+#include "SocketTransport.h"
+#include "MeteredTransport.h"
+#include "Clock.h"
+#include <new>
+
+class Print;
+
+#define FLEET_MAX_WORKERS 32  ///< Upper bound on worker threads.
+#define FLEET_CHUNK_DEVICES 8 ///< Devices a worker claims at a time.
+#define FLEET_DEVICE_ID_SIZE 14 ///< "SIM", up to 10 digits of a 32-bit index and the terminator.
+
+/**
+ * @brief What every device in a fleet has in common.
+ */
+struct FleetConfig {
+    const char *trackingUrl = "http://localhost:5000/api/v1/tracking";         ///< GPS upload endpoint.
+    const char *rfidUrl = "http://localhost:5000/api/v1/sensor-scans/create"; ///< RFID upload endpoint.
+    double originLatitude = -12.0464;  ///< Centre of the area the routes start in.
+    double originLongitude = -77.0428;
+    double spreadDegrees = 0.1;        ///< Side of the square the route origins are spread over.
+    double speedMps = 10.0;            ///< Vehicle speed.
+    unsigned long fixIntervalMs = 1000;       ///< GPS fix rate of every route.
+    unsigned long scanMeanIntervalMs = 30000; ///< Mean time between RFID scans per device.
+    uint32_t seed = 1;                 ///< Fleet seed; device i derives its own seeds from it.
+    bool useSockets = false;           ///< Host only: POST to the URLs instead of recording offline.
+    uint32_t uplinkLatencyMs = 80;     ///< Offline: latency of every recorded upload.
+    uint32_t uplinkJitterMs = 120;     ///< Offline: largest extra latency drawn per upload.
+};
+
+/**
+ * @brief One device of a fleet together with its simulated inputs and uplink.
+ */
+class SimulatedDevice
+{
+private:
+    VirtualClock clock;
+    SyntheticRoute route;
+    RecordingTransport recorder;
+#ifndef ESP32
+    SocketTransport socket;
+#endif
+    MeteredTransport metered;
+    char deviceId[FLEET_DEVICE_ID_SIZE];
+    TrackingDevice device;
+    ScanPattern scans;
+
+    static const char *formatId(char *buffer, uint32_t index);
+
+public:
+    /**
+     * @brief Builds device `index` of a fleet.
+     * @param index Position in the fleet (names the device SIM00000, SIM00001, ...).
+     * @param config Fleet configuration.
+     * @param metrics Fleet-wide upload metrics.
+     */
+    SimulatedDevice(uint32_t index, const FleetConfig &config, TransportMetrics &metrics);
+
+    void initialize(); ///< Initializes the device (connects its transport).
+
+    /**
+     * @brief Advances the device to a point in simulated time and runs what fell due.
+     * @param elapsedMs Simulated milliseconds since the fleet started.
+     */
+    void stepTo(unsigned long elapsedMs);
+
+    TrackingDevice &getDevice() { return device; } ///< The simulated device.
+    uint32_t scanCount() const { return scans.scanCount(); } ///< RFID scans injected so far.
+};
+
+/**
+ * @brief Non-template part of FleetSimulator: stepping and reporting.
+ */
+class FleetRunner
+{
+public:
+    /**
+     * @brief Steps devices in lockstep and prints a JSON summary.
+     * @param devices Contiguous array of devices.
+     * @param count Number of devices.
+     * @param metrics Fleet-wide upload metrics.
+     * @param durationMs Simulated time to run.
+     * @param stepMs Simulated time between lockstep points.
+     * @param workers Worker threads (0: one per hardware thread; always 1 on the ESP32).
+     * @param report Destination of the summary line.
+     */
+    static void run(SimulatedDevice *devices, size_t count, TransportMetrics &metrics,
+                    unsigned long durationMs, unsigned long stepMs, unsigned workers, Print &report);
+};
+
+/**
+ * @brief A fleet of up to `MaxDevices` simulated devices in static storage.
+ * @tparam MaxDevices Capacity of the fleet.
+ */
+template <size_t MaxDevices>
+class FleetSimulator {
+private:
+    alignas(SimulatedDevice) unsigned char storage[MaxDevices * sizeof(SimulatedDevice)];
+    size_t deviceCount;
+    TransportMetrics metrics;
+
+    SimulatedDevice *devices() { return reinterpret_cast<SimulatedDevice*>(storage); }
+
+public:
+    FleetSimulator() : deviceCount(0) {}
+    ~FleetSimulator() { clear(); }
+
+    FleetSimulator(const FleetSimulator&) = delete;
+    FleetSimulator& operator=(const FleetSimulator&) = delete;
+
+    /**
+     * @brief Replaces the fleet with `count` freshly initialized devices.
+     * @param count Number of devices (capped at MaxDevices).
+     * @param config Fleet configuration.
+     * @return Number of devices created.
+     */
+    size_t populate(size_t count, const FleetConfig& config) {
+        clear();
+        if (count > MaxDevices) {
+            count = MaxDevices;
+        }
+        for (size_t i = 0; i < count; i++) {
+            SimulatedDevice* device = new (&devices()[i]) SimulatedDevice(i, config, metrics);
+            deviceCount++;
+            device->initialize();
+        }
+        return deviceCount;
+    }
+
+    /**
+     * @brief Destroys every device.
+     */
+    void clear() {
+        while (deviceCount > 0) {
+            devices()[--deviceCount].~SimulatedDevice();
+        }
+    }
+
+    /**
+     * @brief Runs the fleet and prints a JSON summary (see FleetRunner::run).
+     */
+    void run(unsigned long durationMs, unsigned long stepMs, unsigned workers, Print& report) {
+        FleetRunner::run(devices(), deviceCount, metrics, durationMs, stepMs, workers, report);
+    }
+
+    size_t size() const { return deviceCount; } ///< Devices in the fleet.
+    SimulatedDevice& operator[](size_t index) { return devices()[index]; } ///< Device by position.
+    const TransportMetrics& getMetrics() const { return metrics; } ///< Fleet-wide upload metrics.
+};
+
+#endif // FLEET_SIMULATOR_H
@@ -23,58 +23,75 @@
  */
 
 #include "GpsSensor.h"
+#include "Trace.h"
 #include <Arduino.h>
 
 const Event GpsSensor::GPS_DATA_EVENT = Event(GPS_DATA_EVENT_ID);
 
-GpsSensor::GpsSensor(int rxPin, int txPin, unsigned long updateInterval, EventHandler *eventHandler)
-    : Sensor(-1, eventHandler), updateInterval(updateInterval), lastUpdate(0)
+GpsSensor::GpsSensor(int rxPin, int txPin, unsigned long updateInterval, EventHandler *eventHandler,
+                     Clock &clock)
+    : Sensor(-1, eventHandler), clock(&clock), fixAcquired(false), lastUpdate(0), updateInterval(updateInterval)
 {
+    Serial2.setRxBufferSize(GPS_RX_BUFFER_SIZE);
+    Serial2.begin(GPS_BAUD_RATE, SERIAL_8N1, rxPin, txPin);
     gpsSerial = &Serial2;
-    gpsSerial->begin(9600, SERIAL_8N1, rxPin, txPin);
-    lastValidData.isValid = false;
 }
 
 void GpsSensor::update()
 {
+    TRACE_SCOPE("gps.update");
+
     // Read available GPS data
     while (gpsSerial->available() > 0)
     {
         char c = gpsSerial->read();
         gps.encode(c);
     }
+    sentencesPassed.set(gps.passedChecksum());
+    checksumFailures.set(gps.failedChecksum());
 
     // Check if we have new location data and enough time has passed
-    if (gps.location.isUpdated() && (millis() - lastUpdate > updateInterval))
+    if (gps.location.isUpdated() && (clock->nowMs() - lastUpdate > updateInterval))
     {
         if (gps.location.isValid())
         {
-            lastValidData.latitude = gps.location.lat();
-            lastValidData.longitude = gps.location.lng();
-            lastValidData.isValid = true;
+            GpsData data;
+            data.latitude = gps.location.lat();
+            data.longitude = gps.location.lng();
+            data.isValid = true;
 
             // Generate timestamp
-            time_t now = time(nullptr);
+            time_t now = clock->wallTime();
             struct tm timeinfo;
-            char buf[30];
             gmtime_r(&now, &timeinfo);
-            strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
-            lastValidData.timestamp = String(buf);
+            strftime(data.timestamp, sizeof(data.timestamp), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
 
-            lastUpdate = millis();
+            fixAcquired = true;
+            lastUpdate = clock->nowMs();
 
-            // Trigger GPS data event
-            on(GPS_DATA_EVENT);
+            // Trigger GPS data event carrying the fix
+            on(Event(GPS_DATA_EVENT_ID, data, lastUpdate));
         }
     }
 }
 
-GpsData GpsSensor::getLastData() const
+bool GpsSensor::hasValidFix() const
 {
-    return lastValidData;
+    return fixAcquired && gps.location.isValid();
 }
 
-bool GpsSensor::hasValidFix() const
+void GpsSensor::setUpdateInterval(unsigned long intervalMs)
+{
+    updateInterval = intervalMs;
+}
+
+void GpsSensor::setInput(Stream *input)
+{
+    gpsSerial = input;
+}
+
+void GpsSensor::registerMetrics(MetricsRegistry &registry)
 {
-    return lastValidData.isValid && gps.location.isValid();
+    registry.add("gps.sentences", sentencesPassed);
+    registry.add("gps.checksum_failures", checksumFailures);
 }
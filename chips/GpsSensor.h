@@ -26,24 +26,36 @@
  */
 
 #include "Sensor.h"
+#include "Metrics.h"
+#include "Clock.h"
 #include <TinyGPSPlus.h>
 
+#define GPS_TIMESTAMP_SIZE 21   ///< Room for an ISO8601 "YYYY-MM-DDTHH:MM:SSZ" timestamp.
+#define GPS_BAUD_RATE 9600      ///< Must match the receiver (the simulator's `baud` attribute).
+#define GPS_RX_BUFFER_SIZE 1024 ///< UART receive buffer; absorbs bursts between update() calls.
+
+/**
+ * @brief GPS fix carried as the payload of GPS_DATA_EVENT.
+ */
 struct GpsData
 {
     double latitude;
     double longitude;
     bool isValid;
-    String timestamp;
+    char timestamp[GPS_TIMESTAMP_SIZE];
 };
 
 class GpsSensor : public Sensor
 {
 private:
     TinyGPSPlus gps;
-    HardwareSerial *gpsSerial;
-    GpsData lastValidData;
+    Stream *gpsSerial; ///< NMEA source: the receiver's UART unless replaced by setInput().
+    Clock *clock;      ///< Time source for throttling and timestamps.
+    bool fixAcquired;
     unsigned long lastUpdate;
     unsigned long updateInterval;
+    Gauge sentencesPassed;   ///< NMEA sentences with a valid checksum.
+    Gauge checksumFailures;  ///< NMEA sentences rejected for a bad checksum.
 
 public:
     static const int GPS_DATA_EVENT_ID = 10; ///< Unique ID for GPS data event.
@@ -55,25 +67,42 @@ public:
      * @param txPin The TX pin for GPS communication.
      * @param updateInterval Minimum interval between GPS updates in milliseconds.
      * @param eventHandler Optional handler to receive GPS events (default: nullptr).
+     * @param clock Time source (default: the system clock).
      */
-    GpsSensor(int rxPin, int txPin, unsigned long updateInterval = 10000, EventHandler *eventHandler = nullptr);
+    GpsSensor(int rxPin, int txPin, unsigned long updateInterval = 10000, EventHandler *eventHandler = nullptr,
+              Clock &clock = SystemClock::instance());
 
     /**
      * @brief Reads and processes GPS data, triggers events when new data is available.
+     * The fix is delivered as a GpsData payload of GPS_DATA_EVENT.
      */
     void update();
 
-    /**
-     * @brief Gets the last valid GPS data.
-     * @return GpsData structure with latest coordinates and validity status.
-     */
-    GpsData getLastData() const;
-
     /**
      * @brief Checks if GPS has valid location data.
      * @return True if GPS has valid fix, false otherwise.
      */
     bool hasValidFix() const;
+
+    /**
+     * @brief Changes the minimum interval between published fixes.
+     * @param intervalMs New interval in milliseconds.
+     */
+    void setUpdateInterval(unsigned long intervalMs);
+
+    unsigned long getUpdateInterval() const { return updateInterval; } ///< Current interval in milliseconds.
+
+    /**
+     * @brief Reads NMEA from another stream (e.g. a recorded session) instead of the UART.
+     * @param input The NMEA source.
+     */
+    void setInput(Stream *input);
+
+    /**
+     * @brief Registers NMEA sentence and checksum-failure metrics.
+     * @param registry The registry to add the metrics to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
 };
 
 #endif // GPS_SENSOR_H
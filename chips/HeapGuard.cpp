@@ -0,0 +1,126 @@
+/**
+ * @file HeapGuard.cpp
+ * @brief Implements the HeapGuard utility.
+ *
+ * Replaces the global allocation operators when MODESTIOT_HEAP_GUARD is defined, counting the
+ * allocations made while the guard is armed.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "HeapGuard.h"
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+static std::atomic<bool> guardArmed(false);
+static std::atomic<uint32_t> guardedAllocations(0);
+
+void HeapGuard::arm()
+{
+    guardedAllocations.store(0, std::memory_order_relaxed);
+    guardArmed.store(true, std::memory_order_release);
+}
+
+void HeapGuard::disarm()
+{
+    guardArmed.store(false, std::memory_order_release);
+}
+
+bool HeapGuard::isArmed()
+{
+#ifdef MODESTIOT_HEAP_GUARD
+    return guardArmed.load(std::memory_order_acquire);
+#else
+    return false;
+#endif
+}
+
+uint32_t HeapGuard::allocationsSinceArm()
+{
+    return guardedAllocations.load(std::memory_order_relaxed);
+}
+
+#ifdef MODESTIOT_HEAP_GUARD
+
+static void *guardedAllocate(size_t size)
+{
+    if (guardArmed.load(std::memory_order_relaxed))
+    {
+        guardedAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return malloc(size == 0 ? 1 : size);
+}
+
+/**
+ * @brief Allocates for the throwing operators, which must never return null.
+ */
+static void *guardedAllocateOrFail(size_t size)
+{
+    void *pointer = guardedAllocate(size);
+    if (pointer == nullptr)
+    {
+#if defined(__cpp_exceptions)
+        throw std::bad_alloc();
+#else
+        abort();
+#endif
+    }
+    return pointer;
+}
+
+void *operator new(size_t size)
+{
+    return guardedAllocateOrFail(size);
+}
+
+void *operator new[](size_t size)
+{
+    return guardedAllocateOrFail(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return guardedAllocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return guardedAllocate(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+#endif // MODESTIOT_HEAP_GUARD
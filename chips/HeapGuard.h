@@ -0,0 +1,61 @@
+#ifndef HEAP_GUARD_H
+#define HEAP_GUARD_H
+
+/**
+ * @file HeapGuard.h
+ * @brief Declares the HeapGuard utility.
+ *
+ * Enforces the heap-free steady state of the Modest IoT Nano-framework. When the
+ * `MODESTIOT_HEAP_GUARD` build mode is enabled, the global `operator new` family is replaced
+ * with versions that count every allocation made while the guard is armed. Devices arm the
+ * guard at the end of initialization, so a non-zero count means something allocated in the
+ * main loop. Without the build mode the guard is inert and always reports zero. Allocations made
+ * directly through malloc (Arduino `String`, C libraries) bypass the operators and are not counted,
+ * which is why the framework itself avoids `String` in steady state.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ModestIoTConfig.h"
+#include <stdint.h>
+
+class HeapGuard {
+public:
+    /**
+     * @brief Starts counting allocations.
+     */
+    static void arm();
+
+    /**
+     * @brief Stops counting allocations.
+     */
+    static void disarm();
+
+    /**
+     * @brief Checks whether the guard is counting.
+     * @return True if armed and the build mode is enabled.
+     */
+    static bool isArmed();
+
+    /**
+     * @brief Gets the number of allocations made while armed.
+     * @return Allocation count (always 0 without MODESTIOT_HEAP_GUARD).
+     */
+    static uint32_t allocationsSinceArm();
+};
+
+#endif // HEAP_GUARD_H
@@ -0,0 +1,110 @@
+/**
+ * @file HttpTransport.cpp
+ * @brief Implements the HttpTransport class.
+ *
+ * WiFi connection handling and HTTP POST uploads for the Modest IoT Nano-framework.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "HttpTransport.h"
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <Arduino.h>
+
+HttpTransport::HttpTransport(Clock &clock) : clock(&clock)
+{
+}
+
+bool HttpTransport::connect(const char *ssid, const char *password)
+{
+    return joinWiFi(ssid, password, *clock);
+}
+
+bool HttpTransport::joinWiFi(const char *ssid, const char *password, Clock &clock)
+{
+    WiFi.begin(ssid, password);
+
+    int attempts = 0;
+    while (WiFi.status() != WL_CONNECTED && attempts < WIFI_CONNECT_ATTEMPTS)
+    {
+        clock.sleepMs(WIFI_CONNECT_POLL_MS);
+        Serial.print(".");
+        attempts++;
+    }
+    return WiFi.status() == WL_CONNECTED;
+}
+
+void HttpTransport::disconnect()
+{
+    WiFi.disconnect();
+}
+
+bool HttpTransport::isConnected()
+{
+    return WiFi.status() == WL_CONNECTED;
+}
+
+int HttpTransport::post(const TransportRequest &request, char *response, size_t responseSize)
+{
+    HTTPClient http;
+    http.begin(request.url);
+    http.addHeader("Content-Type", request.contentType);
+    for (uint8_t i = 0; i < request.headerCount; i++)
+    {
+        http.addHeader(request.headerNames[i], request.headerValues[i]);
+    }
+
+    int httpCode = http.POST(const_cast<uint8_t *>(request.body), request.length);
+    if (httpCode > 0)
+    {
+        readResponse(http, response, responseSize);
+    }
+    else if (responseSize > 0)
+    {
+        response[0] = '\0';
+    }
+    http.end();
+    return httpCode;
+}
+
+size_t HttpTransport::readResponse(HTTPClient &http, char *buffer, size_t size)
+{
+    size_t length = 0;
+    WiFiClient *stream = http.getStreamPtr();
+    if (stream != nullptr)
+    {
+        // Read no more than the declared body; with an unknown length take what has arrived
+        int declared = http.getSize();
+        size_t wanted = size - 1;
+        if (declared >= 0 && static_cast<size_t>(declared) < wanted)
+        {
+            wanted = declared;
+        }
+        while (length < wanted && (declared >= 0 || stream->available() > 0))
+        {
+            size_t read = stream->readBytes(buffer + length, wanted - length);
+            if (read == 0)
+            {
+                break;
+            }
+            length += read;
+        }
+    }
+    buffer[length] = '\0';
+    return length;
+}
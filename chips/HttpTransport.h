@@ -0,0 +1,82 @@
+#ifndef HTTP_TRANSPORT_H
+#define HTTP_TRANSPORT_H
+
+/**
+ * @file HttpTransport.h
+ * @brief Declares the HttpTransport class.
+ *
+ * The default Transport of the Modest IoT Nano-framework: WiFi station link and one HTTP POST
+ * per upload through the ESP32 HTTPClient.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Transport.h"
+#include "Clock.h"
+
+class HTTPClient;
+
+#define WIFI_CONNECT_ATTEMPTS 20      ///< Status polls before a WiFi connection attempt fails.
+#define WIFI_CONNECT_POLL_MS 500      ///< Delay between WiFi status polls.
+
+class HttpTransport : public Transport
+{
+private:
+    Clock *clock; ///< Time source for connection polling.
+
+public:
+    /**
+     * @brief Constructs an HTTP transport.
+     * @param clock Time source (default: the system clock).
+     */
+    explicit HttpTransport(Clock &clock = SystemClock::instance());
+
+    bool connect(const char *ssid, const char *password) override;
+    void disconnect() override;
+    bool isConnected() override;
+
+    /**
+     * @brief POSTs the request body and reads back the start of the response.
+     * @param request The request to send.
+     * @param response Destination for the response body (always null-terminated).
+     * @param responseSize Size of the response buffer.
+     * @return HTTP status code, or a negative HTTPClient error.
+     */
+    int post(const TransportRequest &request, char *response, size_t responseSize) override;
+
+    /**
+     * @brief Joins a WiFi network, polling its status up to WIFI_CONNECT_ATTEMPTS times.
+     * Shared with the other transports that run over the ESP32's WiFi station.
+     * @param ssid Network name.
+     * @param password Network password.
+     * @param clock Time source to wait on between polls.
+     * @return True if connected.
+     */
+    static bool joinWiFi(const char *ssid, const char *password, Clock &clock);
+
+private:
+    /**
+     * @brief Reads the response body into a fixed buffer without allocating.
+     * @param http The client holding the response.
+     * @param buffer Destination for the body (always null-terminated).
+     * @param size Size of the destination buffer.
+     * @return Number of bytes read.
+     */
+    size_t readResponse(HTTPClient &http, char *buffer, size_t size);
+};
+
+#endif // HTTP_TRANSPORT_H
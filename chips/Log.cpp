@@ -0,0 +1,342 @@
+/**
+ * @file Log.cpp
+ * @brief Implements the Logger facility.
+ *
+ * The ring is a bounded multi-producer queue in the style of Vyukov's: every slot carries a
+ * sequence number telling whether it is free for the position a producer claimed, or committed
+ * for the position the drain expects. Producers claim positions with a compare-and-swap and
+ * never wait; the drain is the only consumer. Sequences are stored relative to the slot index,
+ * so the zero-initialized ring is ready before any constructor runs.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Log.h"
+#include "Metrics.h"
+#include "PinnedTask.h"
+#include <Arduino.h>
+#include <stdio.h>
+
+static_assert((LOG_BUFFER_SLOTS & (LOG_BUFFER_SLOTS - 1)) == 0, "LOG_BUFFER_SLOTS must be a power of two");
+static_assert(LOG_MAX_ARGS <= 4, "LogRecord::argTypes holds four two-bit argument kinds");
+static_assert(LOG_MAX_FORMATS < 0xFF, "Format ids are one byte; 0xFF means unnumbered");
+
+#define LOG_LINE_SIZE 160          ///< Longest rendered line.
+#define LOG_FRAME_SYNC 0xA5        ///< First byte of every binary frame (never valid ASCII).
+#define LOG_FRAME_FORMAT 'F'       ///< Frame announcing a format id: id, length, text.
+#define LOG_FRAME_RECORD 'R'       ///< Frame carrying a record: id, level, time, arguments.
+#define LOG_UNNUMBERED 0xFF        ///< Format id used once the format table is full.
+
+static LogRecord ring[LOG_BUFFER_SLOTS];
+static std::atomic<uint32_t> ringTail(0); ///< Next position to claim (producers).
+static uint32_t ringHead = 0;             ///< Next position to drain (drain only).
+static Counter droppedRecords;
+static uint32_t reportedDrops = 0;        ///< Drops already reported by the drain.
+static std::atomic<bool> binaryMode(false);
+
+static const char* formats[LOG_MAX_FORMATS]; ///< Formats numbered so far (binary mode).
+static uint8_t formatCount = 0;
+
+static PinnedTask<LOG_TASK_STACK_SIZE> drainTask;
+static Print* drainOutput = nullptr;
+
+static inline uint32_t slotIndex(uint32_t position)
+{
+    return position & (LOG_BUFFER_SLOTS - 1);
+}
+
+LogRecord *Logger::claim(uint8_t level, const char *format)
+{
+    uint32_t position = ringTail.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        LogRecord &slot = ring[slotIndex(position)];
+        uint32_t sequence = slot.sequence.load(std::memory_order_acquire) + slotIndex(position);
+        int32_t lag = static_cast<int32_t>(sequence - position);
+        if (lag == 0)
+        {
+            if (ringTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.timestampMs = millis();
+                slot.format = format;
+                slot.level = level;
+                slot.argCount = 0;
+                slot.argTypes = 0;
+                slot.stringBytes = 0;
+                return &slot;
+            }
+        }
+        else if (lag < 0)
+        {
+            // The drain is a full lap behind: losing this line beats blocking the caller
+            droppedRecords.add();
+            return nullptr;
+        }
+        else
+        {
+            position = ringTail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::commit(LogRecord *record)
+{
+    uint32_t sequence = record->sequence.load(std::memory_order_relaxed);
+    record->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Renders a record's message with its captured arguments.
+ */
+static void renderMessage(const LogRecord &record, char *line, size_t size)
+{
+    size_t used = 0;
+    uint8_t next = 0;
+    const char *cursor = record.format;
+    while (*cursor != '\0' && used + 1 < size)
+    {
+        if (*cursor != '%' || cursor[1] == '%')
+        {
+            line[used++] = *cursor;
+            cursor += *cursor == '%' ? 2 : 1;
+            continue;
+        }
+
+        // Copy flags, width and precision; drop length modifiers, the argument's kind decides
+        char spec[16] = "%";
+        size_t specLength = 1;
+        cursor++;
+        while (*cursor != '\0' && strchr("-+ #0123456789.", *cursor) != nullptr && specLength < sizeof(spec) - 3)
+        {
+            spec[specLength++] = *cursor++;
+        }
+        while (*cursor == 'l' || *cursor == 'h' || *cursor == 'z')
+        {
+            cursor++;
+        }
+        char conversion = *cursor != '\0' ? *cursor++ : 's';
+
+        uint32_t value = next < record.argCount ? record.args[next] : 0;
+        LogArg type = static_cast<LogArg>((record.argTypes >> (2 * next)) & 0x3);
+        bool present = next < record.argCount;
+        next++;
+
+        char *destination = line + used;
+        size_t room = size - used;
+        int written;
+        if (!present)
+        {
+            written = snprintf(destination, room, "?");
+        }
+        else if (conversion == 's')
+        {
+            spec[specLength++] = 's';
+            spec[specLength] = '\0';
+            const char *text = type == LogArg::STRING && value < LOG_STRING_SIZE ? record.strings + value : "?";
+            written = snprintf(destination, room, spec, text);
+        }
+        else if (conversion == 'f' || conversion == 'e' || conversion == 'g')
+        {
+            spec[specLength++] = conversion;
+            spec[specLength] = '\0';
+            float number = 0;
+            if (type == LogArg::FLOAT)
+            {
+                memcpy(&number, &value, sizeof(number));
+            }
+            else
+            {
+                number = type == LogArg::INT ? static_cast<float>(static_cast<int32_t>(value)) : static_cast<float>(value);
+            }
+            written = snprintf(destination, room, spec, static_cast<double>(number));
+        }
+        else if (conversion == 'c')
+        {
+            spec[specLength++] = 'c';
+            spec[specLength] = '\0';
+            written = snprintf(destination, room, spec, static_cast<int>(value));
+        }
+        else if (conversion == 'd' || conversion == 'i')
+        {
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'd';
+            spec[specLength] = '\0';
+            written = snprintf(destination, room, spec, static_cast<long>(static_cast<int32_t>(value)));
+        }
+        else
+        {
+            spec[specLength++] = 'l';
+            spec[specLength++] = conversion == 'x' || conversion == 'X' ? conversion : 'u';
+            spec[specLength] = '\0';
+            written = snprintf(destination, room, spec, static_cast<unsigned long>(value));
+        }
+
+        if (written > 0)
+        {
+            used += static_cast<size_t>(written) < room ? static_cast<size_t>(written) : room - 1;
+        }
+    }
+    line[used] = '\0';
+}
+
+static void writeText(Print &out, const LogRecord &record)
+{
+    static const char LEVEL_LETTERS[] = "-EWID";
+    char line[LOG_LINE_SIZE];
+    int prefix = snprintf(line, sizeof(line), "%lu %c ", static_cast<unsigned long>(record.timestampMs),
+                          LEVEL_LETTERS[record.level <= LOG_LEVEL_DEBUG ? record.level : 0]);
+    renderMessage(record, line + prefix, sizeof(line) - prefix);
+    out.println(line);
+}
+
+static void putWord(uint8_t *frame, size_t &length, uint32_t value)
+{
+    frame[length++] = static_cast<uint8_t>(value);
+    frame[length++] = static_cast<uint8_t>(value >> 8);
+    frame[length++] = static_cast<uint8_t>(value >> 16);
+    frame[length++] = static_cast<uint8_t>(value >> 24);
+}
+
+/**
+ * @brief Numbers a format, announcing it with a format frame the first time it is seen.
+ * @return The format's id, or LOG_UNNUMBERED if the table is full.
+ */
+static uint8_t formatId(Print &out, const char *format)
+{
+    for (uint8_t id = 0; id < formatCount; id++)
+    {
+        if (formats[id] == format)
+        {
+            return id;
+        }
+    }
+    if (formatCount >= LOG_MAX_FORMATS)
+    {
+        return LOG_UNNUMBERED;
+    }
+
+    uint8_t id = formatCount++;
+    formats[id] = format;
+    size_t length = strnlen(format, 0xFF);
+    uint8_t header[4] = {LOG_FRAME_SYNC, LOG_FRAME_FORMAT, id, static_cast<uint8_t>(length)};
+    out.write(header, sizeof(header));
+    out.write(reinterpret_cast<const uint8_t *>(format), length);
+    return id;
+}
+
+static void writeBinary(Print &out, const LogRecord &record)
+{
+    uint8_t id = formatId(out, record.format);
+    if (id == LOG_UNNUMBERED)
+    {
+        writeText(out, record);
+        return;
+    }
+
+    // Sync, kind, format id, level, time, argument count and kinds, then each argument:
+    // four bytes, or a length byte and the characters for a string
+    uint8_t frame[10 + LOG_MAX_ARGS * 4 + LOG_STRING_SIZE];
+    size_t length = 0;
+    frame[length++] = LOG_FRAME_SYNC;
+    frame[length++] = LOG_FRAME_RECORD;
+    frame[length++] = id;
+    frame[length++] = record.level;
+    putWord(frame, length, record.timestampMs);
+    frame[length++] = record.argCount;
+    frame[length++] = record.argTypes;
+    for (uint8_t i = 0; i < record.argCount; i++)
+    {
+        LogArg type = static_cast<LogArg>((record.argTypes >> (2 * i)) & 0x3);
+        if (type == LogArg::STRING)
+        {
+            const char *text = record.args[i] < LOG_STRING_SIZE ? record.strings + record.args[i] : "";
+            size_t textLength = strnlen(text, LOG_STRING_SIZE - record.args[i]);
+            frame[length++] = static_cast<uint8_t>(textLength);
+            memcpy(frame + length, text, textLength);
+            length += textLength;
+        }
+        else
+        {
+            putWord(frame, length, record.args[i]);
+        }
+    }
+    out.write(frame, length);
+}
+
+size_t Logger::drain(Print &out)
+{
+    size_t written = 0;
+    bool binary = binaryMode.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        LogRecord &slot = ring[slotIndex(ringHead)];
+        uint32_t sequence = slot.sequence.load(std::memory_order_acquire) + slotIndex(ringHead);
+        if (sequence != ringHead + 1)
+        {
+            break; // Empty, or the next record is still being captured
+        }
+
+        if (binary)
+        {
+            writeBinary(out, slot);
+        }
+        else
+        {
+            writeText(out, slot);
+        }
+        slot.sequence.store(ringHead + LOG_BUFFER_SLOTS - slotIndex(ringHead), std::memory_order_release);
+        ringHead++;
+        written++;
+    }
+
+    uint32_t drops = droppedRecords.get();
+    if (drops != reportedDrops)
+    {
+        char line[48];
+        snprintf(line, sizeof(line), "%lu W log: %lu records dropped", static_cast<unsigned long>(millis()),
+                 static_cast<unsigned long>(drops - reportedDrops));
+        out.println(line);
+        reportedDrops = drops;
+    }
+    return written;
+}
+
+static void drainStep(void *output)
+{
+    Logger::drain(*static_cast<Print *>(output));
+}
+
+bool Logger::start(Print &out)
+{
+    drainOutput = &out;
+    return drainTask.start("log", drainStep, drainOutput, LOG_TASK_PERIOD_MS, LOG_TASK_CORE, LOG_TASK_PRIORITY);
+}
+
+void Logger::setBinary(bool enabled)
+{
+    binaryMode.store(enabled, std::memory_order_relaxed);
+}
+
+uint32_t Logger::dropped()
+{
+    return droppedRecords.get();
+}
+
+void Logger::registerMetrics(MetricsRegistry &registry)
+{
+    registry.add("log.dropped", droppedRecords);
+}
@@ -0,0 +1,201 @@
+#ifndef LOG_H
+#define LOG_H
+
+/**
+ * @file Log.h
+ * @brief Declares the Logger facility and the LOG_ERROR, LOG_WARN, LOG_INFO and LOG_DEBUG macros.
+ *
+ * Asynchronous, leveled logging for the Modest IoT Nano-framework. A LOG_* call never formats and
+ * never waits for the UART: it claims a slot in a lock-free RAM ring, stores the static format
+ * string's address, a timestamp and up to LOG_MAX_ARGS arguments (integers, floats and short
+ * strings, copied by value), and returns. A low-priority drain task later renders the records as
+ * text lines, or in binary mode writes them as compact frames of a format id plus the raw
+ * arguments, sending each format string only once; `tools/log_decode.py` turns a captured binary
+ * stream back into text. When the ring is full the newest record is dropped and counted.
+ *
+ * Levels above MODESTIOT_LOG_LEVEL (see ModestIoTConfig.h) compile to nothing, arguments included.
+ * Formats support the printf conversions d, i, u, x, X, c, s, f, e, g and %% with flags, width,
+ * precision and the l/h length modifiers.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ModestIoTConfig.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+class Print;
+class MetricsRegistry;
+
+#define LOG_LEVEL_NONE 0  ///< Compile every LOG_* call out.
+#define LOG_LEVEL_ERROR 1 ///< Failures that lose data.
+#define LOG_LEVEL_WARN 2  ///< Recoverable problems (retries, reconnects, full queues).
+#define LOG_LEVEL_INFO 3  ///< One line per upload or state change.
+#define LOG_LEVEL_DEBUG 4 ///< Per-event detail, including response bodies.
+
+#ifndef MODESTIOT_LOG_LEVEL
+#define MODESTIOT_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_BUFFER_SLOTS 32     ///< Records the ring holds (power of two).
+#define LOG_MAX_ARGS 4          ///< Arguments a record can carry.
+#define LOG_STRING_SIZE 48      ///< Bytes for a record's string arguments, terminators included.
+#define LOG_MAX_FORMATS 64      ///< Distinct formats the binary mode can number.
+#define LOG_TASK_STACK_SIZE 3072 ///< Stack bytes for the drain task.
+#define LOG_TASK_PERIOD_MS 20   ///< Drain period.
+#define LOG_TASK_CORE 0         ///< Core running the drain task.
+#define LOG_TASK_PRIORITY 0     ///< Below the ingest and network tasks.
+
+/**
+ * @brief Argument kinds, two bits each in LogRecord::argTypes.
+ */
+enum class LogArg : uint8_t { INT, UINT, FLOAT, STRING };
+
+/**
+ * @brief One captured log call.
+ */
+struct LogRecord {
+    std::atomic<uint32_t> sequence; ///< Ring position this slot is ready for (see Logger).
+    uint32_t timestampMs;           ///< millis() at the call.
+    const char* format;             ///< Static format string.
+    uint8_t level;                  ///< LOG_LEVEL_* of the call.
+    uint8_t argCount;               ///< Arguments captured.
+    uint8_t argTypes;               ///< LogArg of each argument, two bits each.
+    uint8_t stringBytes;            ///< Bytes of `strings` in use.
+    uint32_t args[LOG_MAX_ARGS];    ///< Integer values, float bits or offsets into `strings`.
+    char strings[LOG_STRING_SIZE];  ///< String arguments, each null-terminated (truncated to fit).
+
+    void add(LogArg type, uint32_t value) {
+        argTypes |= static_cast<uint8_t>(type) << (2 * argCount);
+        args[argCount++] = value;
+    }
+
+    void capture(const char* text) {
+        size_t room = LOG_STRING_SIZE - stringBytes;
+        size_t length = text != nullptr ? strnlen(text, room > 0 ? room - 1 : 0) : 0;
+        add(LogArg::STRING, stringBytes);
+        if (room > 0) {
+            memcpy(strings + stringBytes, text, length);
+            strings[stringBytes + length] = '\0';
+            stringBytes += length + 1;
+        }
+    }
+
+    void capture(double value) {
+        float narrowed = static_cast<float>(value);
+        uint32_t bits;
+        memcpy(&bits, &narrowed, sizeof(bits));
+        add(LogArg::FLOAT, bits);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type capture(T value) {
+        if (std::is_signed<T>::value) {
+            add(LogArg::INT, static_cast<uint32_t>(static_cast<int32_t>(value)));
+        } else {
+            add(LogArg::UINT, static_cast<uint32_t>(value));
+        }
+    }
+};
+
+class Logger {
+private:
+    static LogRecord* claim(uint8_t level, const char* format);
+    static void commit(LogRecord* record);
+
+    static void captureAll(LogRecord&) {}
+
+    template <typename First, typename... Rest>
+    static void captureAll(LogRecord& record, First first, Rest... rest) {
+        record.capture(first);
+        captureAll(record, rest...);
+    }
+
+public:
+    /**
+     * @brief Queues a record; called by the LOG_* macros. Safe from any task on either core.
+     * @param level LOG_LEVEL_* of the call.
+     * @param format Static printf-style format.
+     * @param args Up to LOG_MAX_ARGS arguments, copied by value.
+     */
+    template <typename... Args>
+    static void log(uint8_t level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments (see LOG_MAX_ARGS)");
+        LogRecord* record = claim(level, format);
+        if (record != nullptr) {
+            captureAll(*record, args...);
+            commit(record);
+        }
+    }
+
+    /**
+     * @brief Writes the queued records to an output. Only one caller may drain at a time.
+     * @param out Destination (e.g. Serial).
+     * @return Number of records written.
+     */
+    static size_t drain(Print& out);
+
+    /**
+     * @brief Starts the task that drains the ring every LOG_TASK_PERIOD_MS.
+     * @param out Destination (e.g. Serial).
+     * @return True if the task was started, false if it is already running.
+     */
+    static bool start(Print& out);
+
+    /**
+     * @brief Switches between text lines and binary frames (see tools/log_decode.py).
+     * @param enabled True for binary frames.
+     */
+    static void setBinary(bool enabled);
+
+    static uint32_t dropped(); ///< Records dropped because the ring was full.
+
+    /**
+     * @brief Registers `log.dropped`.
+     * @param registry The registry to add it to.
+     */
+    static void registerMetrics(MetricsRegistry& registry);
+};
+
+#if MODESTIOT_LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) Logger::log(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#if MODESTIOT_LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) Logger::log(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if MODESTIOT_LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) Logger::log(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if MODESTIOT_LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) Logger::log(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#endif // LOG_H
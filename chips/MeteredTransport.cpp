@@ -0,0 +1,66 @@
+/**
+ * @file MeteredTransport.cpp
+ * @brief Implements the MeteredTransport class.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "MeteredTransport.h"
+
+MeteredTransport::MeteredTransport(Transport &inner, TransportMetrics &metrics, Clock &clock)
+    : inner(&inner), metrics(&metrics), clock(&clock)
+{
+}
+
+bool MeteredTransport::connect(const char *ssid, const char *password)
+{
+    return inner->connect(ssid, password);
+}
+
+void MeteredTransport::disconnect()
+{
+    inner->disconnect();
+}
+
+bool MeteredTransport::isConnected()
+{
+    return inner->isConnected();
+}
+
+int MeteredTransport::post(const TransportRequest &request, char *response, size_t responseSize)
+{
+    metrics->requests.add();
+    metrics->bytes.add(request.length);
+    unsigned long startedAt = clock->nowUs();
+    int status = inner->post(request, response, responseSize);
+    metrics->latency.record(clock->nowUs() - startedAt);
+    if (status < 200 || status >= 300)
+    {
+        metrics->errors.add();
+    }
+    return status;
+}
+
+void MeteredTransport::poll()
+{
+    inner->poll();
+}
+
+size_t MeteredTransport::maxPayload() const
+{
+    return inner->maxPayload();
+}
@@ -0,0 +1,68 @@
+#ifndef METERED_TRANSPORT_H
+#define METERED_TRANSPORT_H
+
+/**
+ * @file MeteredTransport.h
+ * @brief Declares the TransportMetrics struct and the MeteredTransport class.
+ *
+ * A Transport decorator for the Modest IoT Nano-framework that counts requests, payload bytes
+ * and failures and records client-side latency before delegating to another transport. The
+ * metrics are lock-free, so one TransportMetrics can aggregate many devices running on
+ * different threads (e.g. a simulated fleet).
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Transport.h"
+#include "Metrics.h"
+#include "Clock.h"
+
+/**
+ * @brief Upload metrics shared by any number of MeteredTransports.
+ */
+struct TransportMetrics {
+    Counter requests;  ///< Uploads attempted.
+    Counter bytes;     ///< Payload bytes attempted.
+    Counter errors;    ///< Uploads without a 2xx status.
+    Histogram latency; ///< Client-side latency in microseconds.
+};
+
+class MeteredTransport : public Transport
+{
+private:
+    Transport *inner;
+    TransportMetrics *metrics;
+    Clock *clock;
+
+public:
+    /**
+     * @brief Wraps a transport.
+     * @param inner The transport that carries the uploads.
+     * @param metrics Where to record them.
+     * @param clock Time source for latency (default: the system clock, i.e. real latency).
+     */
+    MeteredTransport(Transport &inner, TransportMetrics &metrics, Clock &clock = SystemClock::instance());
+
+    bool connect(const char *ssid, const char *password) override;
+    void disconnect() override;
+    bool isConnected() override;
+    int post(const TransportRequest &request, char *response, size_t responseSize) override;
+    void poll() override;
+    size_t maxPayload() const override;
+};
+
+#endif // METERED_TRANSPORT_H
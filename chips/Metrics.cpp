@@ -0,0 +1,203 @@
+/**
+ * @file Metrics.cpp
+ * @brief Implements the Histogram and MetricsRegistry classes.
+ *
+ * Snapshot rendering for the Modest IoT Nano-framework metrics. Recording itself is inline in
+ * Metrics.h; this file only contains the colder percentile and formatting code.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Metrics.h"
+#include <Arduino.h>
+#include <stdio.h>
+
+Histogram::Histogram() : count(0), maximum(0)
+{
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint32_t Histogram::percentile(uint8_t percent) const
+{
+    uint32_t total = samples();
+    if (total == 0)
+    {
+        return 0;
+    }
+    uint32_t rank = static_cast<uint32_t>((static_cast<uint64_t>(total) * percent + 99) / 100);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    uint32_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            // Bucket i holds [2^(i-1), 2^i); report its upper bound, capped by the true maximum
+            uint32_t upper = i == 0 ? 0 : (i >= 32 ? UINT32_MAX : (1u << i) - 1);
+            return upper < max() ? upper : max();
+        }
+    }
+    return max();
+}
+
+MetricsRegistry::MetricsRegistry() : entryCount(0)
+{
+}
+
+bool MetricsRegistry::addEntry(const char *name, Kind kind, const void *metric, uint8_t width)
+{
+    if (entryCount >= METRICS_MAX_ENTRIES)
+    {
+        return false;
+    }
+    entries[entryCount++] = Entry{name, kind, width, metric};
+    return true;
+}
+
+bool MetricsRegistry::add(const char *name, const Counter &counter)
+{
+    return addEntry(name, Kind::COUNTER, &counter, 1);
+}
+
+bool MetricsRegistry::add(const char *name, const Gauge &gauge)
+{
+    return addEntry(name, Kind::GAUGE, &gauge, 1);
+}
+
+bool MetricsRegistry::add(const char *name, const Histogram &histogram)
+{
+    return addEntry(name, Kind::HISTOGRAM, &histogram, 1);
+}
+
+bool MetricsRegistry::add(const char *name, const Counter *counters, uint8_t width)
+{
+    return addEntry(name, Kind::COUNTER_FAMILY, counters, width);
+}
+
+/**
+ * @brief Formats one entry's value (without its name) into a buffer.
+ */
+static size_t formatValue(char *buffer, size_t size, MetricsRegistry::Kind kind,
+                          const void *metric, uint8_t width)
+{
+    int written = 0;
+    switch (kind)
+    {
+    case MetricsRegistry::Kind::COUNTER:
+        written = snprintf(buffer, size, "%lu",
+                           static_cast<unsigned long>(static_cast<const Counter *>(metric)->get()));
+        break;
+    case MetricsRegistry::Kind::GAUGE:
+        written = snprintf(buffer, size, "%ld",
+                           static_cast<long>(static_cast<const Gauge *>(metric)->get()));
+        break;
+    case MetricsRegistry::Kind::HISTOGRAM:
+    {
+        const Histogram *histogram = static_cast<const Histogram *>(metric);
+        written = snprintf(buffer, size, "%lu/%lu/%lu/%lu",
+                           static_cast<unsigned long>(histogram->samples()),
+                           static_cast<unsigned long>(histogram->percentile(50)),
+                           static_cast<unsigned long>(histogram->percentile(99)),
+                           static_cast<unsigned long>(histogram->max()));
+        break;
+    }
+    case MetricsRegistry::Kind::COUNTER_FAMILY:
+    {
+        const Counter *counters = static_cast<const Counter *>(metric);
+        size_t used = 0;
+        buffer[0] = '\0';
+        for (uint8_t i = 0; i < width && used < size; i++)
+        {
+            uint32_t value = counters[i].get();
+            if (value == 0)
+            {
+                continue;
+            }
+            int part = snprintf(buffer + used, size - used, "%s%u:%lu", used > 0 ? "," : "",
+                                i, static_cast<unsigned long>(value));
+            if (part < 0)
+            {
+                break;
+            }
+            used += part;
+        }
+        return used < size ? used : size - 1;
+    }
+    }
+    if (written < 0)
+    {
+        buffer[0] = '\0';
+        return 0;
+    }
+    return static_cast<size_t>(written) < size ? written : size - 1;
+}
+
+void MetricsRegistry::print(Print &out) const
+{
+    char value[96];
+    for (uint8_t i = 0; i < entryCount; i++)
+    {
+        formatValue(value, sizeof(value), entries[i].kind, entries[i].metric, entries[i].width);
+        out.print(entries[i].name);
+        out.print(entries[i].kind == Kind::HISTOGRAM ? " (n/p50/p99/max): " : ": ");
+        out.println(value);
+    }
+}
+
+size_t MetricsRegistry::writeCompact(char *buffer, size_t size, uint8_t first, uint8_t *next) const
+{
+    uint8_t index = first < entryCount ? first : 0;
+    size_t used = 0;
+    for (uint8_t rendered = 0; rendered < entryCount && size > 0; rendered++)
+    {
+        // Render after what is already there, and keep the entry only if it fit whole
+        const Entry &entry = entries[index];
+        int part = snprintf(buffer + used, size - used, "%s%s=", used > 0 ? ";" : "", entry.name);
+        size_t value = 0;
+        if (part >= 0 && used + part + 1 < size)
+        {
+            value = formatValue(buffer + used + part, size - used - part, entry.kind, entry.metric,
+                                entry.width);
+        }
+        if (part < 0 || used + part + value + 1 >= size)
+        {
+            buffer[used] = '\0';
+            if (rendered == 0)
+            {
+                index = (index + 1) % entryCount; // Never fits: skip it rather than stall the rotation
+            }
+            break;
+        }
+        used += part + value;
+        index = (index + 1) % entryCount;
+    }
+    if (size > 0 && used == 0)
+    {
+        buffer[0] = '\0';
+    }
+    if (next != nullptr)
+    {
+        *next = index;
+    }
+    return used;
+}
@@ -0,0 +1,169 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/**
+ * @file Metrics.h
+ * @brief Declares the Counter, Gauge, Histogram and MetricsRegistry classes.
+ *
+ * Lightweight runtime metrics for the Modest IoT Nano-framework. Recording is a handful of
+ * relaxed atomic operations with no locks and no allocation, so metrics can sit on hot paths
+ * and be updated from either core. Components own their metrics and register them, by name,
+ * with a fixed-capacity registry that renders snapshots for the serial console or in a compact
+ * form suitable for piggybacking on uploads.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+class Print;
+
+#define METRICS_MAX_ENTRIES 40   ///< Metrics a registry can hold.
+#define HISTOGRAM_BUCKETS 33     ///< Log2 buckets: 0, [1,2), [2,4), ... [2^31, 2^32).
+
+/**
+ * @brief Monotonic event counter.
+ */
+class Counter {
+private:
+    std::atomic<uint32_t> value;
+
+public:
+    Counter() : value(0) {}
+
+    /// Increments the counter. Always inlined, so IRAM interrupt handlers can count.
+    __attribute__((always_inline)) void add(uint32_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+    uint32_t get() const { return value.load(std::memory_order_relaxed); } ///< Current count.
+};
+
+/**
+ * @brief Last-value gauge (queue depths, connection state, ...).
+ */
+class Gauge {
+private:
+    std::atomic<int32_t> value;
+
+public:
+    Gauge() : value(0) {}
+
+    void set(int32_t newValue) { value.store(newValue, std::memory_order_relaxed); } ///< Records a new value.
+    int32_t get() const { return value.load(std::memory_order_relaxed); } ///< Last recorded value.
+};
+
+/**
+ * @brief Fixed-bucket histogram with power-of-two bucket boundaries.
+ *
+ * Values are typically durations in microseconds. Percentiles are estimated as the upper
+ * bound of the bucket containing the requested rank, so they are accurate to within 2x.
+ */
+class Histogram {
+private:
+    std::atomic<uint32_t> buckets[HISTOGRAM_BUCKETS];
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> maximum;
+
+public:
+    Histogram();
+
+    /**
+     * @brief Records one value.
+     * @param value The value to record.
+     */
+    void record(uint32_t value) {
+        int bucket = value == 0 ? 0 : 32 - __builtin_clz(value);
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        uint32_t previous = maximum.load(std::memory_order_relaxed);
+        while (value > previous &&
+               !maximum.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint32_t samples() const { return count.load(std::memory_order_relaxed); } ///< Values recorded.
+    uint32_t max() const { return maximum.load(std::memory_order_relaxed); } ///< Largest value recorded.
+
+    /**
+     * @brief Estimates a percentile.
+     * @param percent Percentile in the range 0..100.
+     * @return Upper bound of the bucket holding that percentile (0 if empty).
+     */
+    uint32_t percentile(uint8_t percent) const;
+};
+
+/**
+ * @brief Named, fixed-capacity collection of metrics owned by other components.
+ */
+class MetricsRegistry {
+public:
+    enum class Kind : uint8_t { COUNTER, GAUGE, HISTOGRAM, COUNTER_FAMILY };
+
+private:
+    struct Entry {
+        const char* name;
+        Kind kind;
+        uint8_t width; ///< Number of counters in a family.
+        const void* metric;
+    };
+
+    Entry entries[METRICS_MAX_ENTRIES];
+    uint8_t entryCount;
+
+    bool addEntry(const char* name, Kind kind, const void* metric, uint8_t width);
+
+public:
+    MetricsRegistry();
+
+    bool add(const char* name, const Counter& counter);     ///< Registers a counter.
+    bool add(const char* name, const Gauge& gauge);         ///< Registers a gauge.
+    bool add(const char* name, const Histogram& histogram); ///< Registers a histogram.
+
+    /**
+     * @brief Registers an array of counters indexed by a small integer (e.g. event id).
+     * @param name Family name.
+     * @param counters First counter of the array.
+     * @param width Number of counters in the array.
+     * @return True if registered, false if the registry is full.
+     */
+    bool add(const char* name, const Counter* counters, uint8_t width);
+
+    /**
+     * @brief Prints one line per metric, for the serial console.
+     * @param out Destination (e.g. Serial).
+     */
+    void print(Print& out) const;
+
+    /**
+     * @brief Renders as many metrics as fit as a single compact line.
+     *
+     * Format: `name=value` pairs separated by ';'. Histograms render as
+     * `count/p50/p99/max` and counter families as `index:value` pairs joined by ','
+     * (zero entries omitted). Only whole entries are written. Rendering starts at entry `first`
+     * and wraps around, so a small buffer can rotate through the registry: pass the `next` of
+     * one call as the `first` of the following one.
+     *
+     * @param buffer Destination (always null-terminated).
+     * @param size Size of the destination.
+     * @param first Index of the first entry to render (default: 0).
+     * @param next Receives the index of the first entry not rendered (optional).
+     * @return Number of characters written, excluding the terminator.
+     */
+    size_t writeCompact(char* buffer, size_t size, uint8_t first = 0, uint8_t* next = nullptr) const;
+};
+
+#endif // METRICS_H
@@ -30,6 +30,7 @@
 #include "EventHandler.h"
 #include "CommandHandler.h"
 #include "Sensor.h"
+#include "SampledSensor.h"
 #include "Actuator.h"
 #include "Button.h"
 #include "Led.h"
@@ -39,7 +40,26 @@
 #include "CiaSteelFaucet.h"
 #include "GpsSensor.h"
 #include "RfidSensor.h"
+#include "Rc522Reader.h"
+#include "OutboundQueue.h"
+#include "DeflateEncoder.h"
 #include "CommunicationHandler.h"
+#include "UplinkGovernor.h"
 #include "TrackingDevice.h"
+#include "Transport.h"
+#include "HttpTransport.h"
+#include "MqttTransport.h"
+#include "RecordingTransport.h"
+#include "SessionReplay.h"
+#include "SocketTransport.h"
+#include "SocketClient.h"
+#include "MeteredTransport.h"
+#include "SyntheticRoute.h"
+#include "ScanPattern.h"
+#include "FleetSimulator.h"
+#include "DeadlineMonitor.h"
+#include "Trace.h"
+#include "Log.h"
+#include "Benchmark.h"
 
 #endif // MODEST_IOT_H
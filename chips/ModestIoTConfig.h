@@ -0,0 +1,42 @@
+#ifndef MODEST_IOT_CONFIG_H
+#define MODEST_IOT_CONFIG_H
+
+/**
+ * @file ModestIoTConfig.h
+ * @brief Build-time switches for the Modest IoT Nano-framework (C++ Edition).
+ *
+ * The Arduino toolchain compiles every framework source on its own, so options that must be seen
+ * by all of them are collected here instead of being defined in the sketch. Uncomment a switch
+ * (or pass it with -D) to enable the corresponding build mode.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+// Count every C++ heap allocation made after TrackingDevice::initialize() (see HeapGuard.h).
+// #define MODESTIOT_HEAP_GUARD
+
+// Record TRACE_SCOPE spans into the RAM trace buffer (see Trace.h). Compiled out when undefined.
+// #define MODESTIOT_TRACE
+
+// Most verbose LOG_* level compiled in (see Log.h): LOG_LEVEL_NONE, _ERROR, _WARN, _INFO (default)
+// or _DEBUG. Calls above it cost nothing.
+// #define MODESTIOT_LOG_LEVEL LOG_LEVEL_DEBUG
+
+// Run the FrameworkBenchmark suite from setup() and print JSON results (see Benchmark.h).
+// #define MODESTIOT_BENCHMARK
+
+#endif // MODEST_IOT_CONFIG_H
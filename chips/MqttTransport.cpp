@@ -0,0 +1,455 @@
+/**
+ * @file MqttTransport.cpp
+ * @brief Implements the MqttTransport class.
+ *
+ * MQTT 3.1.1 packet encoding (CONNECT, PUBLISH, PINGREQ, DISCONNECT) and an incremental parser
+ * for what the broker sends back, all in fixed buffers.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "MqttTransport.h"
+#include "HttpTransport.h"
+#include "Trace.h"
+#include <Client.h>
+#ifdef ESP32
+#include <WiFi.h>
+#endif
+#include <Arduino.h>
+#include <string.h>
+
+// Control packet types (upper nibble of the fixed header)
+static const uint8_t MQTT_CONNECT = 0x10;
+static const uint8_t MQTT_CONNACK = 0x20;
+static const uint8_t MQTT_PUBLISH = 0x30;
+static const uint8_t MQTT_PUBACK = 0x40;
+static const uint8_t MQTT_PINGREQ = 0xC0;
+static const uint8_t MQTT_PINGRESP = 0xD0;
+static const uint8_t MQTT_DISCONNECT = 0xE0;
+static const uint8_t MQTT_DUP_FLAG = 0x08;
+
+// Parser stages
+static const uint8_t RX_TYPE = 0;
+static const uint8_t RX_LENGTH = 1;
+static const uint8_t RX_BODY = 2;
+
+/**
+ * @brief Writes an MQTT variable-length "remaining length" field.
+ * @return Bytes used (1 to 4).
+ */
+static size_t encodeLength(uint8_t *buffer, uint32_t length)
+{
+    size_t used = 0;
+    do
+    {
+        uint8_t digit = length % 128;
+        length /= 128;
+        buffer[used++] = length > 0 ? (digit | 0x80) : digit;
+    } while (length > 0 && used < 4);
+    return used;
+}
+
+static size_t encodeString(uint8_t *buffer, const char *text, size_t length)
+{
+    buffer[0] = static_cast<uint8_t>(length >> 8);
+    buffer[1] = static_cast<uint8_t>(length & 0xFF);
+    memcpy(buffer + 2, text, length);
+    return length + 2;
+}
+
+MqttTransport::MqttTransport(Client &client, const char *brokerHost, uint16_t brokerPort,
+                             const char *deviceId, uint8_t qos, Clock &clock)
+    : client(&client), brokerHost(brokerHost), brokerPort(brokerPort), clientId(deviceId),
+      qos(qos > 1 ? 1 : qos), clock(&clock), sessionOpen(false), connackReceived(false),
+      connackCode(0), nextPacketId(1), lastSent(0), inflightHead(0), inflightCount(0),
+      rxType(0), rxRemaining(0), rxLengthShift(0), rxStage(RX_TYPE), rxBodyLength(0)
+{
+}
+
+bool MqttTransport::connect(const char *ssid, const char *password)
+{
+#ifdef ESP32
+    if (!HttpTransport::joinWiFi(ssid, password, *clock))
+    {
+        return false;
+    }
+#else
+    (void)ssid;
+    (void)password;
+#endif
+    return openSession();
+}
+
+bool MqttTransport::openSession()
+{
+    TRACE_SCOPE("mqtt.connect");
+    sessionOpen = false;
+    client->stop();
+    if (!client->connect(brokerHost, brokerPort))
+    {
+        return false;
+    }
+    rxStage = RX_TYPE;
+
+    // CONNECT: protocol "MQTT" level 4, clean session off, keepalive, client id
+    uint8_t packet[16 + MQTT_CLIENT_ID_SIZE];
+    size_t idLength = strlen(clientId.c_str());
+    uint32_t remaining = 10 + 2 + idLength;
+    size_t used = 0;
+    packet[used++] = MQTT_CONNECT;
+    used += encodeLength(packet + used, remaining);
+    used += encodeString(packet + used, "MQTT", 4);
+    packet[used++] = 4;    // Protocol level 3.1.1
+    packet[used++] = 0x00; // Connect flags: persistent session, no will, no credentials
+    packet[used++] = MQTT_KEEPALIVE_S >> 8;
+    packet[used++] = MQTT_KEEPALIVE_S & 0xFF;
+    used += encodeString(packet + used, clientId.c_str(), idLength);
+
+    connackReceived = false;
+    if (!writePacket(packet, used) ||
+        !waitFor([](MqttTransport &self) { return self.connackReceived; }, MQTT_ACK_TIMEOUT_MS) ||
+        connackCode != 0)
+    {
+        client->stop();
+        return false;
+    }
+    sessionOpen = true;
+
+    // Resend what the previous connection left unacknowledged, in order
+    for (uint8_t i = 0; i < inflightCount; i++)
+    {
+        InFlight &entry = inflight[(inflightHead + i) % MQTT_MAX_INFLIGHT];
+        if (!entry.acked)
+        {
+            entry.packet[0] |= MQTT_DUP_FLAG;
+            retransmitted.add();
+            if (!writePacket(entry.packet, entry.length))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void MqttTransport::disconnect()
+{
+    if (sessionOpen)
+    {
+        const uint8_t packet[] = {MQTT_DISCONNECT, 0x00};
+        writePacket(packet, sizeof(packet));
+    }
+    sessionOpen = false;
+    client->stop();
+}
+
+bool MqttTransport::isConnected()
+{
+#ifdef ESP32
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        return false;
+    }
+#endif
+    return sessionOpen && client->connected();
+}
+
+bool MqttTransport::writePacket(const uint8_t *packet, size_t length)
+{
+    if (client->write(packet, length) != length)
+    {
+        sessionOpen = false;
+        return false;
+    }
+    wireBytes.add(length);
+    lastSent = clock->nowMs();
+    return true;
+}
+
+void MqttTransport::readPackets()
+{
+    uint8_t chunk[64];
+    int waiting;
+    while ((waiting = client->available()) > 0)
+    {
+        int count = client->read(chunk, waiting < static_cast<int>(sizeof(chunk)) ? waiting : sizeof(chunk));
+        if (count <= 0)
+        {
+            break;
+        }
+        wireBytes.add(count);
+        for (int i = 0; i < count; i++)
+        {
+            uint8_t byte = chunk[i];
+            switch (rxStage)
+            {
+            case RX_TYPE:
+                rxType = byte;
+                rxRemaining = 0;
+                rxLengthShift = 0;
+                rxBodyLength = 0;
+                rxStage = RX_LENGTH;
+                break;
+            case RX_LENGTH:
+                rxRemaining |= static_cast<uint32_t>(byte & 0x7F) << rxLengthShift;
+                rxLengthShift += 7;
+                if ((byte & 0x80) == 0)
+                {
+                    rxStage = RX_BODY;
+                    if (rxRemaining == 0)
+                    {
+                        onPacket();
+                        rxStage = RX_TYPE;
+                    }
+                }
+                break;
+            default:
+                // Keep the first bytes of the body; the packets handled here are no longer
+                if (rxBodyLength < sizeof(rxBody))
+                {
+                    rxBody[rxBodyLength] = byte;
+                }
+                rxBodyLength = rxBodyLength < 255 ? rxBodyLength + 1 : rxBodyLength;
+                if (--rxRemaining == 0)
+                {
+                    onPacket();
+                    rxStage = RX_TYPE;
+                }
+                break;
+            }
+        }
+    }
+}
+
+void MqttTransport::onPacket()
+{
+    switch (rxType & 0xF0)
+    {
+    case MQTT_CONNACK:
+        connackReceived = true;
+        connackCode = rxBodyLength >= 2 ? rxBody[1] : 0xFF;
+        break;
+    case MQTT_PUBACK:
+    {
+        if (rxBodyLength < 2)
+        {
+            break;
+        }
+        uint16_t packetId = static_cast<uint16_t>((rxBody[0] << 8) | rxBody[1]);
+        for (uint8_t i = 0; i < inflightCount; i++)
+        {
+            InFlight &entry = inflight[(inflightHead + i) % MQTT_MAX_INFLIGHT];
+            if (entry.packetId == packetId && !entry.acked)
+            {
+                entry.acked = true;
+                acknowledged.add();
+                break;
+            }
+        }
+        // Brokers acknowledge in order, so the ring normally retires from its head
+        while (inflightCount > 0 && inflight[inflightHead].acked)
+        {
+            inflightHead = (inflightHead + 1) % MQTT_MAX_INFLIGHT;
+            inflightCount--;
+        }
+        inflightDepth.set(inflightCount);
+        break;
+    }
+    case MQTT_PINGRESP:
+    default:
+        break;
+    }
+}
+
+bool MqttTransport::waitFor(bool (*done)(MqttTransport &), unsigned long timeoutMs)
+{
+    unsigned long startedAt = clock->nowMs();
+    for (;;)
+    {
+        readPackets();
+        if (done(*this))
+        {
+            return true;
+        }
+        if (!client->connected() || clock->nowMs() - startedAt >= timeoutMs)
+        {
+            return false;
+        }
+        clock->sleepMs(1);
+    }
+}
+
+size_t MqttTransport::encodePublish(uint8_t *buffer, size_t size, const char *topic, const uint8_t *payload,
+                                    size_t length, uint8_t publishQos, uint16_t packetId)
+{
+    size_t topicLength = strlen(topic);
+    uint32_t remaining = 2 + topicLength + (publishQos > 0 ? 2 : 0) + length;
+    if (1 + 4 + remaining > size)
+    {
+        return 0;
+    }
+    size_t used = 0;
+    buffer[used++] = MQTT_PUBLISH | (publishQos << 1);
+    used += encodeLength(buffer + used, remaining);
+    used += encodeString(buffer + used, topic, topicLength);
+    if (publishQos > 0)
+    {
+        buffer[used++] = static_cast<uint8_t>(packetId >> 8);
+        buffer[used++] = static_cast<uint8_t>(packetId & 0xFF);
+    }
+    memcpy(buffer + used, payload, length);
+    return used + length;
+}
+
+void MqttTransport::buildTopic(char *topic, size_t size, const char *url, const char *encoding) const
+{
+    const char *path = url;
+    const char *scheme = strstr(url, "://");
+    if (scheme != nullptr)
+    {
+        path = strchr(scheme + 3, '/');
+        path = path != nullptr ? path : "";
+    }
+    while (*path == '/')
+    {
+        path++;
+    }
+    if (strncmp(path, "api/v1/", 7) == 0)
+    {
+        path += 7;
+    }
+    if (encoding != nullptr)
+    {
+        snprintf(topic, size, "%s/%s/%s/%s", MQTT_TOPIC_PREFIX, clientId.c_str(), path, encoding);
+    }
+    else
+    {
+        snprintf(topic, size, "%s/%s/%s", MQTT_TOPIC_PREFIX, clientId.c_str(), path);
+    }
+}
+
+int MqttTransport::post(const TransportRequest &request, char *response, size_t responseSize)
+{
+    TRACE_SCOPE("mqtt.publish");
+    if (responseSize > 0)
+    {
+        response[0] = '\0';
+    }
+    if (!sessionOpen && !openSession())
+    {
+        return ERROR_NO_SESSION;
+    }
+    readPackets();
+
+    char topic[MQTT_TOPIC_SIZE];
+    const char *encoding = nullptr;
+    for (uint8_t i = 0; i < request.headerCount; i++)
+    {
+        if (strcmp(request.headerNames[i], "Content-Encoding") == 0)
+        {
+            encoding = request.headerValues[i]; // Part of the body's topic, below
+            continue;
+        }
+
+        // MQTT 3.1.1 has no headers; each one travels as its own QoS 0 message
+        char headerTopic[MQTT_TOPIC_SIZE];
+        snprintf(headerTopic, sizeof(headerTopic), "%s/%s/%s", MQTT_TOPIC_PREFIX, clientId.c_str(),
+                 request.headerNames[i]);
+        uint8_t packet[MQTT_MAX_PACKET_SIZE];
+        size_t length = encodePublish(packet, sizeof(packet), headerTopic,
+                                      reinterpret_cast<const uint8_t *>(request.headerValues[i]),
+                                      strlen(request.headerValues[i]), 0, 0);
+        if (length > 0 && writePacket(packet, length))
+        {
+            published.add();
+        }
+    }
+    buildTopic(topic, sizeof(topic), request.url, encoding);
+
+    if (qos == 0)
+    {
+        uint8_t packet[MQTT_MAX_PACKET_SIZE];
+        size_t length = encodePublish(packet, sizeof(packet), topic, request.body, request.length, 0, 0);
+        if (length == 0)
+        {
+            return ERROR_TOO_LARGE;
+        }
+        if (!writePacket(packet, length))
+        {
+            return ERROR_NO_SESSION;
+        }
+        published.add();
+        return STATUS_SENT;
+    }
+
+    // Pipelining: only wait when every slot still holds an unacknowledged publish
+    if (inflightCount == MQTT_MAX_INFLIGHT &&
+        !waitFor([](MqttTransport &self) { return self.inflightCount < MQTT_MAX_INFLIGHT; },
+                 MQTT_ACK_TIMEOUT_MS))
+    {
+        return ERROR_BACKLOG;
+    }
+    InFlight &entry = inflight[(inflightHead + inflightCount) % MQTT_MAX_INFLIGHT];
+    uint16_t packetId = nextPacketId;
+    size_t length = encodePublish(entry.packet, sizeof(entry.packet), topic, request.body, request.length, 1,
+                                  packetId);
+    if (length == 0)
+    {
+        return ERROR_TOO_LARGE;
+    }
+    nextPacketId = nextPacketId == 0xFFFF ? 1 : nextPacketId + 1;
+    entry.packetId = packetId;
+    entry.length = static_cast<uint16_t>(length);
+    entry.acked = false;
+    inflightCount++;
+    inflightDepth.set(inflightCount);
+
+    // A failed write leaves the publish in flight; it is resent when the session reopens
+    if (writePacket(entry.packet, length))
+    {
+        published.add();
+    }
+    return STATUS_ACCEPTED;
+}
+
+void MqttTransport::poll()
+{
+    if (!sessionOpen)
+    {
+        return;
+    }
+    readPackets();
+    if (clock->nowMs() - lastSent >= MQTT_KEEPALIVE_S * 1000UL / 2)
+    {
+        const uint8_t packet[] = {MQTT_PINGREQ, 0x00};
+        writePacket(packet, sizeof(packet));
+    }
+}
+
+bool MqttTransport::flush(unsigned long timeoutMs)
+{
+    return inflightCount == 0 ||
+           waitFor([](MqttTransport &self) { return self.inflightCount == 0; }, timeoutMs);
+}
+
+void MqttTransport::registerMetrics(MetricsRegistry &registry)
+{
+    registry.add("mqtt.published", published);
+    registry.add("mqtt.acked", acknowledged);
+    registry.add("mqtt.retransmits", retransmitted);
+    registry.add("mqtt.inflight", inflightDepth);
+}
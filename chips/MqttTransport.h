@@ -0,0 +1,171 @@
+#ifndef MQTT_TRANSPORT_H
+#define MQTT_TRANSPORT_H
+
+/**
+ * @file MqttTransport.h
+ * @brief Declares the MqttTransport class.
+ *
+ * An MQTT 3.1.1 uplink for the Modest IoT Nano-framework. Each upload becomes one PUBLISH on a
+ * per-device topic instead of an HTTP request/response, over a single persistent session
+ * (clean session off, so the broker keeps it across reconnects). At QoS 1 publishes are
+ * pipelined: post() returns as soon as the packet is written, up to MQTT_MAX_INFLIGHT
+ * unacknowledged packets are kept for retransmission, and PUBACKs are collected as they arrive.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Transport.h"
+#include "FixedString.h"
+#include "Metrics.h"
+#include "Clock.h"
+
+class Client;
+
+#define MQTT_MAX_PACKET_SIZE 512    ///< Largest PUBLISH (topic + payload + header) that can be sent.
+#define MQTT_MAX_INFLIGHT 8         ///< Unacknowledged QoS 1 publishes kept for retransmission.
+#define MQTT_TOPIC_SIZE 96          ///< Longest topic, including terminator.
+#define MQTT_MAX_PAYLOAD (MQTT_MAX_PACKET_SIZE - 5 - 2 - (MQTT_TOPIC_SIZE - 1) - 2) ///< Largest body any topic can carry.
+#define MQTT_CLIENT_ID_SIZE 24      ///< MQTT 3.1.1 guarantees client ids of up to 23 bytes.
+#define MQTT_TOPIC_PREFIX "modestiot" ///< Topics are MQTT_TOPIC_PREFIX/<deviceId>/<endpoint>.
+#define MQTT_KEEPALIVE_S 60         ///< Keepalive announced in CONNECT.
+#define MQTT_ACK_TIMEOUT_MS 5000    ///< Wait for CONNACK, or for a free in-flight slot.
+
+class MqttTransport : public Transport
+{
+public:
+    static const int STATUS_SENT = 200;     ///< QoS 0 publish written.
+    static const int STATUS_ACCEPTED = 202; ///< QoS 1 publish written; its PUBACK is pending.
+    static const int ERROR_NO_SESSION = -1; ///< The broker could not be reached or refused us.
+    static const int ERROR_TOO_LARGE = -2;  ///< The publish does not fit MQTT_MAX_PACKET_SIZE.
+    static const int ERROR_BACKLOG = -3;    ///< All in-flight slots stayed unacknowledged.
+
+private:
+    struct InFlight
+    {
+        uint16_t packetId;
+        uint16_t length;
+        bool acked;
+        uint8_t packet[MQTT_MAX_PACKET_SIZE];
+    };
+
+    Client *client;
+    const char *brokerHost;
+    uint16_t brokerPort;
+    FixedString<MQTT_CLIENT_ID_SIZE> clientId;
+    uint8_t qos;
+    Clock *clock;
+
+    bool sessionOpen;
+    bool connackReceived;
+    uint8_t connackCode;
+    uint16_t nextPacketId;
+    unsigned long lastSent;
+
+    InFlight inflight[MQTT_MAX_INFLIGHT]; ///< Ring of QoS 1 publishes in send order.
+    uint8_t inflightHead;
+    uint8_t inflightCount;
+
+    // Incoming packet parser (only CONNACK, PUBACK and PINGRESP are of interest)
+    uint8_t rxType;
+    uint32_t rxRemaining;
+    uint8_t rxLengthShift;
+    uint8_t rxStage;
+    uint8_t rxBody[4];
+    uint8_t rxBodyLength;
+
+    Counter published;     ///< Publishes written.
+    Counter acknowledged;  ///< PUBACKs received.
+    Counter retransmitted; ///< Publishes resent after a reconnect.
+    Counter wireBytes;     ///< Bytes written to and read from the broker.
+    Gauge inflightDepth;   ///< Publishes awaiting a PUBACK.
+
+    bool openSession();
+    bool writePacket(const uint8_t *packet, size_t length);
+    void readPackets();
+    void onPacket();
+    bool waitFor(bool (*done)(MqttTransport &), unsigned long timeoutMs);
+    size_t encodePublish(uint8_t *buffer, size_t size, const char *topic, const uint8_t *payload,
+                         size_t length, uint8_t publishQos, uint16_t packetId);
+    void buildTopic(char *topic, size_t size, const char *url, const char *encoding) const;
+
+public:
+    /**
+     * @brief Constructs an MQTT transport.
+     * @param client Network client to the broker (WiFiClient on the ESP32, SocketClient on a host).
+     * @param brokerHost Broker host name or address (must outlive the transport).
+     * @param brokerPort Broker port (1883 for plain MQTT).
+     * @param deviceId Client id and topic segment.
+     * @param qos 0 (fire and forget) or 1 (at least once, pipelined).
+     * @param clock Time source for timeouts and keepalives (default: the system clock).
+     */
+    MqttTransport(Client &client, const char *brokerHost, uint16_t brokerPort, const char *deviceId,
+                  uint8_t qos = 1, Clock &clock = SystemClock::instance());
+
+    /**
+     * @brief Joins WiFi (on the ESP32) and opens the broker session.
+     * Unacknowledged publishes from a previous session are resent with the DUP flag.
+     * @return True if the broker accepted the session.
+     */
+    bool connect(const char *ssid, const char *password) override;
+
+    void disconnect() override; ///< Sends DISCONNECT; the broker keeps the session.
+    bool isConnected() override;
+
+    /**
+     * @brief Publishes the body to MQTT_TOPIC_PREFIX/<deviceId>/<endpoint>.
+     * The endpoint is the URL path without a leading "/api/v1/" ("tracking",
+     * "sensor-scans/create"). A Content-Encoding header extends the topic instead, so the
+     * encoding travels with the body it describes: a deflated batch goes to .../tracking/deflate.
+     * Other extra headers are published at QoS 0 to .../<header name>.
+     * Waits only when all MQTT_MAX_INFLIGHT slots are taken.
+     * @param request The request to publish.
+     * @param response Receives an empty string (MQTT has no response body).
+     * @param responseSize Size of the response buffer.
+     * @return STATUS_SENT, STATUS_ACCEPTED or one of the negative ERROR_ codes.
+     */
+    int post(const TransportRequest &request, char *response, size_t responseSize) override;
+
+    /**
+     * @brief Gets the largest body a PUBLISH can carry: MQTT_MAX_PACKET_SIZE less the fixed header,
+     * the longest topic and the packet id.
+     * @return MQTT_MAX_PAYLOAD.
+     */
+    size_t maxPayload() const override { return MQTT_MAX_PAYLOAD; }
+
+    /**
+     * @brief Collects PUBACKs and sends a PINGREQ when the link has been idle.
+     */
+    void poll() override;
+
+    /**
+     * @brief Waits until every in-flight publish has been acknowledged.
+     * @param timeoutMs Longest time to wait.
+     * @return True if nothing is left in flight.
+     */
+    bool flush(unsigned long timeoutMs = MQTT_ACK_TIMEOUT_MS);
+
+    uint32_t bytesOnWire() const { return wireBytes.get(); } ///< Bytes exchanged with the broker.
+
+    /**
+     * @brief Registers the transport's metrics (`mqtt.published`, `mqtt.acked`,
+     * `mqtt.retransmits`, `mqtt.inflight`).
+     * @param registry The registry to add them to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
+};
+
+#endif // MQTT_TRANSPORT_H
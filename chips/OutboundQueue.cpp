@@ -0,0 +1,207 @@
+/**
+ * @file OutboundQueue.cpp
+ * @brief Implements the OutboundQueue class.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "OutboundQueue.h"
+
+template <size_t Capacity>
+static size_t pushEvicting(BoundedQueue<OutboundRecord, Capacity> &queue, const OutboundRecord &record,
+                           bool keepLatest)
+{
+    size_t evicted = 0;
+    OutboundRecord oldest;
+    while (queue.full() || (keepLatest && queue.size() > 0))
+    {
+        // The newest record is worth more than the oldest one in the same class
+        queue.pop(oldest);
+        evicted++;
+    }
+    queue.push(record);
+    return evicted;
+}
+
+OutboundQueue::OutboundQueue()
+{
+    agingMs[static_cast<uint8_t>(OutboundClass::ACCESS)] = OUTBOUND_ACCESS_AGING_MS;
+    agingMs[static_cast<uint8_t>(OutboundClass::ROUTINE)] = OUTBOUND_ROUTINE_AGING_MS;
+    for (uint8_t index = 0; index < OUTBOUND_CLASSES; index++)
+    {
+        keepLatest[index] = false;
+        passedOver[index] = 0;
+    }
+}
+
+const OutboundRecord *OutboundQueue::head(uint8_t index) const
+{
+    switch (static_cast<OutboundClass>(index))
+    {
+    case OutboundClass::ACCESS:
+        return access.peek();
+    default:
+        return routine.peek();
+    }
+}
+
+bool OutboundQueue::popFrom(uint8_t index, OutboundRecord &record)
+{
+    switch (static_cast<OutboundClass>(index))
+    {
+    case OutboundClass::ACCESS:
+        return access.pop(record);
+    default:
+        return routine.pop(record);
+    }
+}
+
+bool OutboundQueue::pushFrontTo(uint8_t index, const OutboundRecord &record)
+{
+    switch (static_cast<OutboundClass>(index))
+    {
+    case OutboundClass::ACCESS:
+        return access.pushFront(record);
+    default:
+        return routine.pushFront(record);
+    }
+}
+
+bool OutboundQueue::push(OutboundClass cls, const Event &event, unsigned long nowMs)
+{
+    OutboundRecord record;
+    record.event = event;
+    record.queuedAt = nowMs;
+
+    uint8_t index = static_cast<uint8_t>(cls);
+    size_t dropped;
+    switch (cls)
+    {
+    case OutboundClass::ACCESS:
+        dropped = pushEvicting(access, record, keepLatest[index]);
+        break;
+    default:
+        dropped = pushEvicting(routine, record, keepLatest[index]);
+        break;
+    }
+
+    if (dropped > 0)
+    {
+        evicted[index].add(dropped);
+    }
+    depth.set(size());
+    return dropped == 0;
+}
+
+void OutboundQueue::setConflation(OutboundClass cls, bool enabled)
+{
+    keepLatest[static_cast<uint8_t>(cls)] = enabled;
+}
+
+bool OutboundQueue::pop(OutboundRecord &record, OutboundClass &cls, unsigned long nowMs,
+                        OutboundClass lowest)
+{
+    int chosen = -1;
+    for (uint8_t index = 0; index <= static_cast<uint8_t>(lowest); index++)
+    {
+        const OutboundRecord *next = head(index);
+        if (next == nullptr)
+        {
+            continue;
+        }
+        if (chosen < 0)
+        {
+            chosen = index;
+            passedOver[index] = 0;
+        }
+        else if (nowMs - next->queuedAt >= agingMs[index])
+        {
+            // An overdue class only gets a share of the uplink: one record after every
+            // OUTBOUND_OVERDUE_SHARE of the classes above it, so stale bulk data cannot keep a
+            // fresh scan waiting
+            if (passedOver[index] >= OUTBOUND_OVERDUE_SHARE)
+            {
+                chosen = index;
+                passedOver[index] = 0;
+                break;
+            }
+            passedOver[index]++;
+        }
+    }
+
+    if (chosen < 0)
+    {
+        return false;
+    }
+    cls = static_cast<OutboundClass>(chosen);
+    return pop(cls, record, nowMs);
+}
+
+bool OutboundQueue::pop(OutboundClass cls, OutboundRecord &record, unsigned long nowMs)
+{
+    uint8_t index = static_cast<uint8_t>(cls);
+    if (!popFrom(index, record))
+    {
+        return false;
+    }
+    waitMs[index].record(nowMs - record.queuedAt);
+    depth.set(size());
+    return true;
+}
+
+bool OutboundQueue::requeue(OutboundClass cls, OutboundRecord record)
+{
+    uint8_t index = static_cast<uint8_t>(cls);
+    record.attempts++;
+    if (record.attempts >= OUTBOUND_MAX_ATTEMPTS || !pushFrontTo(index, record))
+    {
+        dropped[index].add();
+        return false;
+    }
+    depth.set(size());
+    return true;
+}
+
+void OutboundQueue::setAging(OutboundClass cls, unsigned long limitMs)
+{
+    agingMs[static_cast<uint8_t>(cls)] = limitMs;
+}
+
+size_t OutboundQueue::size() const
+{
+    return access.size() + routine.size();
+}
+
+size_t OutboundQueue::size(OutboundClass cls) const
+{
+    switch (cls)
+    {
+    case OutboundClass::ACCESS:
+        return access.size();
+    default:
+        return routine.size();
+    }
+}
+
+void OutboundQueue::registerMetrics(MetricsRegistry &registry)
+{
+    registry.add("outbound.depth", depth);
+    registry.add("outbound.evicted", evicted, OUTBOUND_CLASSES);
+    registry.add("outbound.dropped", dropped, OUTBOUND_CLASSES);
+    registry.add("outbound.access.wait_ms", waitMs[static_cast<uint8_t>(OutboundClass::ACCESS)]);
+    registry.add("outbound.routine.wait_ms", waitMs[static_cast<uint8_t>(OutboundClass::ROUTINE)]);
+}
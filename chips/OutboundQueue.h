@@ -0,0 +1,168 @@
+#ifndef OUTBOUND_QUEUE_H
+#define OUTBOUND_QUEUE_H
+
+/**
+ * @file OutboundQueue.h
+ * @brief Declares the OutboundQueue class.
+ *
+ * A multi-level priority queue of records waiting for the uplink. Each priority class has its
+ * own bounded ring, so a burst of routine GPS fixes can never crowd out an access scan, and a
+ * full class evicts its own oldest record instead of rejecting the newest one. Classes are
+ * served highest first. A lower class whose head has waited longer than its aging limit is
+ * overdue; it is served once every OUTBOUND_OVERDUE_SHARE records of the higher classes, so
+ * routine traffic is delayed but never starved, and a fresh access scan never waits behind
+ * more than one stale fix.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "EventHandler.h"
+#include "BoundedQueue.h"
+#include "Metrics.h"
+
+#define OUTBOUND_CLASSES 2                ///< Number of priority classes.
+#define OUTBOUND_ACCESS_CAPACITY 8        ///< Access (RFID) records held (power of two).
+#define OUTBOUND_ROUTINE_CAPACITY 16      ///< Routine (GPS) records held (power of two).
+#define OUTBOUND_ACCESS_AGING_MS 500      ///< Access records are overdue after half a second.
+#define OUTBOUND_ROUTINE_AGING_MS 30000   ///< Routine records are overdue after 30 seconds.
+#define OUTBOUND_OVERDUE_SHARE 4          ///< Higher-class records served per overdue lower-class record.
+#define OUTBOUND_MAX_ATTEMPTS 5           ///< Failed uploads after which a record is dropped.
+
+/**
+ * @brief Priority classes, highest first.
+ */
+enum class OutboundClass : uint8_t
+{
+    ACCESS,  ///< Gate access scans (RFID).
+    ROUTINE  ///< Periodic tracking fixes (GPS).
+};
+
+/**
+ * @brief A queued record: the event to upload, the time it was queued and its failed uploads.
+ */
+struct OutboundRecord
+{
+    Event event;            ///< Event carrying the record.
+    unsigned long queuedAt; ///< Clock time the record was queued, in milliseconds.
+    uint8_t attempts;       ///< Uploads of this record that have failed.
+
+    OutboundRecord() : event(0), queuedAt(0), attempts(0) {}
+};
+
+/**
+ * @brief Per-class bounded queues served by priority with aging.
+ * push() and pop() must be called from the same task (the one that owns the uplink).
+ */
+class OutboundQueue
+{
+private:
+    BoundedQueue<OutboundRecord, OUTBOUND_ACCESS_CAPACITY> access;
+    BoundedQueue<OutboundRecord, OUTBOUND_ROUTINE_CAPACITY> routine;
+    unsigned long agingMs[OUTBOUND_CLASSES]; ///< Wait after which a class's head is overdue.
+    bool keepLatest[OUTBOUND_CLASSES];       ///< Classes that hold only their newest record.
+    uint8_t passedOver[OUTBOUND_CLASSES];    ///< Higher-class records served while the class was overdue.
+
+    Counter evicted[OUTBOUND_CLASSES];  ///< Records evicted because their class was full.
+    Counter dropped[OUTBOUND_CLASSES];  ///< Records dropped after OUTBOUND_MAX_ATTEMPTS failed uploads.
+    Histogram waitMs[OUTBOUND_CLASSES]; ///< Time from push() to pop() per class, in milliseconds.
+    Gauge depth;                        ///< Records queued across all classes.
+
+    const OutboundRecord *head(uint8_t index) const;
+    bool popFrom(uint8_t index, OutboundRecord &record);
+    bool pushFrontTo(uint8_t index, const OutboundRecord &record);
+
+public:
+    OutboundQueue();
+
+    /**
+     * @brief Queues an event in its class, evicting the class's oldest record if it is full
+     * (or every queued record, if the class is conflated).
+     * @param cls Priority class.
+     * @param event Event to upload.
+     * @param nowMs Current clock time in milliseconds.
+     * @return True if nothing was evicted.
+     */
+    bool push(OutboundClass cls, const Event &event, unsigned long nowMs);
+
+    /**
+     * @brief Makes a class keep only its newest record: each push evicts what is queued.
+     * Used to conflate GPS fixes while the uplink cannot keep up with them.
+     * @param cls Priority class.
+     * @param enabled True to conflate, false to queue every record again.
+     */
+    void setConflation(OutboundClass cls, bool enabled);
+
+    /**
+     * @brief Removes the oldest record of one class and records how long it waited.
+     * @param cls Priority class.
+     * @param record Destination for the record.
+     * @param nowMs Current clock time in milliseconds.
+     * @return True if a record was removed, false if the class is empty.
+     */
+    bool pop(OutboundClass cls, OutboundRecord &record, unsigned long nowMs);
+
+    /**
+     * @brief Removes the next record to upload and records how long it waited.
+     * The highest non-empty class wins, unless a lower class has been overdue for
+     * OUTBOUND_OVERDUE_SHARE records in a row; then that class gets one record.
+     * @param record Destination for the record.
+     * @param cls Receives the record's class.
+     * @param nowMs Current clock time in milliseconds.
+     * @param lowest Lowest class to consider; lower classes stay queued (default: all classes).
+     * @return True if a record was removed, false if every considered class is empty.
+     */
+    bool pop(OutboundRecord &record, OutboundClass &cls, unsigned long nowMs,
+             OutboundClass lowest = OutboundClass::ROUTINE);
+
+    /**
+     * @brief Puts back a record whose upload failed at the head of its class, so it is retried
+     * before anything queued after it. Its queue time is kept, so it ages as if never taken.
+     * A record that has failed OUTBOUND_MAX_ATTEMPTS times is dropped instead.
+     * @param cls Class the record was popped from.
+     * @param record The record; its attempt count is incremented here.
+     * @return True if requeued, false if dropped.
+     */
+    bool requeue(OutboundClass cls, OutboundRecord record);
+
+    /**
+     * @brief Changes when a class's records become overdue.
+     * @param cls Priority class.
+     * @param limitMs Wait in milliseconds.
+     */
+    void setAging(OutboundClass cls, unsigned long limitMs);
+
+    /**
+     * @brief Gets the oldest record of a class without removing it.
+     * @param cls Priority class.
+     * @return Pointer to the record, or nullptr if the class is empty.
+     */
+    const OutboundRecord *peek(OutboundClass cls) const { return head(static_cast<uint8_t>(cls)); }
+
+    size_t size() const; ///< Records queued across all classes.
+    size_t size(OutboundClass cls) const; ///< Records queued in one class.
+
+    const Histogram &waitTime(OutboundClass cls) const { return waitMs[static_cast<uint8_t>(cls)]; } ///< Queue wait of one class.
+
+    /**
+     * @brief Registers the queue's metrics (`outbound.depth`, `outbound.evicted`, `outbound.dropped`, and
+     * `outbound.<class>.wait_ms` for access and routine).
+     * @param registry The registry to add them to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
+};
+
+#endif // OUTBOUND_QUEUE_H
@@ -0,0 +1,165 @@
+#ifndef PINNED_TASK_H
+#define PINNED_TASK_H
+
+/**
+ * @file PinnedTask.h
+ * @brief Declares the PinnedTask template.
+ *
+ * A periodic task pinned to one CPU core for the Modest IoT Nano-framework. On the ESP32 it is a
+ * statically allocated FreeRTOS task (stack and control block live inside the object), so
+ * starting it never touches the heap. Elsewhere it maps onto `std::thread`, which lets the same
+ * device code run on a host for throughput measurements and ThreadSanitizer runs.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <atomic>
+#include <chrono>
+#include <thread>
+#endif
+
+/**
+ * @brief Runs a step function at a fixed period on a dedicated core.
+ * @tparam StackSize Task stack size in bytes (ignored on the host).
+ */
+template <size_t StackSize>
+class PinnedTask {
+public:
+    using Step = void (*)(void* context); ///< Function called once per period.
+
+private:
+    Step step;
+    void* context;
+    uint32_t periodMs;
+
+#ifdef ESP32
+    StackType_t stack[StackSize / sizeof(StackType_t)];
+    StaticTask_t control;
+    TaskHandle_t handle;
+
+    static void run(void* self) {
+        PinnedTask* task = static_cast<PinnedTask*>(self);
+        TickType_t lastWake = xTaskGetTickCount();
+        for (;;) {
+            task->step(task->context);
+            vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(task->periodMs));
+        }
+    }
+#else
+    std::thread thread;
+    std::atomic<bool> running;
+
+    void run() {
+        auto nextWake = std::chrono::steady_clock::now();
+        while (running.load(std::memory_order_acquire)) {
+            step(context);
+            nextWake += std::chrono::milliseconds(periodMs);
+            std::this_thread::sleep_until(nextWake);
+        }
+    }
+#endif
+
+public:
+#ifdef ESP32
+    PinnedTask() : step(nullptr), context(nullptr), periodMs(0), handle(nullptr) {}
+#else
+    PinnedTask() : step(nullptr), context(nullptr), periodMs(0), running(false) {}
+    ~PinnedTask() { stop(); }
+#endif
+
+    /**
+     * @brief Starts the task.
+     * @param name Task name (shown by FreeRTOS tooling).
+     * @param stepFunction Function called once per period.
+     * @param stepContext Argument passed to the step function.
+     * @param period Period between step starts in milliseconds.
+     * @param core CPU core to pin the task to (ignored on the host).
+     * @param priority FreeRTOS priority (ignored on the host).
+     * @return True if the task was started, false if it is already running.
+     */
+    bool start(const char* name, Step stepFunction, void* stepContext, uint32_t period,
+               int core, unsigned priority) {
+        if (isRunning()) {
+            return false;
+        }
+        step = stepFunction;
+        context = stepContext;
+        periodMs = period;
+#ifdef ESP32
+        handle = xTaskCreateStaticPinnedToCore(run, name, StackSize, this, priority,
+                                               stack, &control, core);
+        return handle != nullptr;
+#else
+        (void)name;
+        (void)core;
+        (void)priority;
+        running.store(true, std::memory_order_release);
+        thread = std::thread(&PinnedTask::run, this);
+        return true;
+#endif
+    }
+
+    /**
+     * @brief Stops the task (after its current step on the host).
+     */
+    void stop() {
+#ifdef ESP32
+        if (handle != nullptr) {
+            vTaskDelete(handle);
+            handle = nullptr;
+        }
+#else
+        running.store(false, std::memory_order_release);
+        if (thread.joinable()) {
+            thread.join();
+        }
+#endif
+    }
+
+    /**
+     * @brief Checks whether the task has been started.
+     * @return True if running.
+     */
+    bool isRunning() const {
+#ifdef ESP32
+        return handle != nullptr;
+#else
+        return running.load(std::memory_order_acquire);
+#endif
+    }
+
+    /**
+     * @brief Gets the minimum free stack seen so far.
+     * @return Stack high-water mark in bytes (0 on the host or if not started).
+     */
+    uint32_t stackHighWaterMark() const {
+#ifdef ESP32
+        return handle != nullptr ? uxTaskGetStackHighWaterMark(handle) : 0;
+#else
+        return 0;
+#endif
+    }
+};
+
+#endif // PINNED_TASK_H
@@ -0,0 +1,274 @@
+/**
+ * @file Rc522Reader.cpp
+ * @brief Implements the Rc522Reader class.
+ *
+ * Register-level MFRC522 access over SPI and the ISO 14443-A exchanges needed to read a UID.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Rc522Reader.h"
+#include "Trace.h"
+#include <Arduino.h>
+#include <string.h>
+
+// Registers
+static const uint8_t COMMAND_REG = 0x01;
+static const uint8_t COM_IRQ_REG = 0x04;
+static const uint8_t DIV_IRQ_REG = 0x05;
+static const uint8_t ERROR_REG = 0x06;
+static const uint8_t FIFO_DATA_REG = 0x09;
+static const uint8_t FIFO_LEVEL_REG = 0x0A;
+static const uint8_t CONTROL_REG = 0x0C;
+static const uint8_t BIT_FRAMING_REG = 0x0D;
+static const uint8_t COLL_REG = 0x0E;
+static const uint8_t MODE_REG = 0x11;
+static const uint8_t TX_MODE_REG = 0x12;
+static const uint8_t RX_MODE_REG = 0x13;
+static const uint8_t TX_CONTROL_REG = 0x14;
+static const uint8_t TX_ASK_REG = 0x15;
+static const uint8_t CRC_RESULT_H_REG = 0x21;
+static const uint8_t CRC_RESULT_L_REG = 0x22;
+static const uint8_t MOD_WIDTH_REG = 0x24;
+static const uint8_t T_MODE_REG = 0x2A;
+static const uint8_t T_PRESCALER_REG = 0x2B;
+static const uint8_t T_RELOAD_H_REG = 0x2C;
+static const uint8_t T_RELOAD_L_REG = 0x2D;
+static const uint8_t VERSION_REG = 0x37;
+
+// Reader commands
+static const uint8_t CMD_IDLE = 0x00;
+static const uint8_t CMD_CALC_CRC = 0x03;
+static const uint8_t CMD_TRANSCEIVE = 0x0C;
+static const uint8_t CMD_SOFT_RESET = 0x0F;
+
+// Card commands
+static const uint8_t PICC_REQA = 0x26;
+static const uint8_t PICC_SEL_CL1 = 0x93;
+static const uint8_t PICC_HLTA = 0x50;
+
+Rc522Reader::Rc522Reader(int csPin, int rstPin, SPIClass &spi, Clock &clock)
+    : csPin(csPin), rstPin(rstPin), spi(&spi), clock(&clock)
+{
+}
+
+void Rc522Reader::writeRegister(uint8_t reg, uint8_t value)
+{
+    writeRegister(reg, &value, 1);
+}
+
+void Rc522Reader::writeRegister(uint8_t reg, const uint8_t *values, uint8_t count)
+{
+    spi->beginTransaction(SPISettings(RC522_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+    digitalWrite(csPin, LOW);
+    spi->transfer((reg << 1) & 0x7E);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        spi->transfer(values[i]);
+    }
+    digitalWrite(csPin, HIGH);
+    spi->endTransaction();
+}
+
+uint8_t Rc522Reader::readRegister(uint8_t reg)
+{
+    uint8_t value;
+    readRegister(reg, &value, 1);
+    return value;
+}
+
+void Rc522Reader::readRegister(uint8_t reg, uint8_t *values, uint8_t count)
+{
+    // Each byte clocked out carries the value addressed by the previous one; a 0 ends the burst
+    uint8_t address = 0x80 | ((reg << 1) & 0x7E);
+    spi->beginTransaction(SPISettings(RC522_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+    digitalWrite(csPin, LOW);
+    spi->transfer(address);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        values[i] = spi->transfer(i + 1 < count ? address : 0);
+    }
+    digitalWrite(csPin, HIGH);
+    spi->endTransaction();
+}
+
+bool Rc522Reader::begin()
+{
+    pinMode(csPin, OUTPUT);
+    digitalWrite(csPin, HIGH);
+    spi->begin();
+    if (rstPin >= 0)
+    {
+        pinMode(rstPin, OUTPUT);
+        digitalWrite(rstPin, LOW);
+        delayMicroseconds(2);
+        digitalWrite(rstPin, HIGH);
+    }
+    else
+    {
+        writeRegister(COMMAND_REG, CMD_SOFT_RESET);
+    }
+    clock->sleepMs(50); // Oscillator start-up
+
+    // Timer in auto mode with a 25 us tick, so a silent card times out after RC522_TIMER_RELOAD ticks
+    writeRegister(T_MODE_REG, 0x80);
+    writeRegister(T_PRESCALER_REG, 0xA9);
+    writeRegister(T_RELOAD_H_REG, RC522_TIMER_RELOAD >> 8);
+    writeRegister(T_RELOAD_L_REG, RC522_TIMER_RELOAD & 0xFF);
+    writeRegister(TX_ASK_REG, 0x40);  // 100% ASK modulation
+    writeRegister(MODE_REG, 0x3D);    // CRC preset 0x6363 (CRC_A)
+    writeRegister(TX_MODE_REG, 0x00); // 106 kbit/s, CRCs handled explicitly
+    writeRegister(RX_MODE_REG, 0x00);
+    writeRegister(MOD_WIDTH_REG, 0x26);
+    uint8_t txControl = readRegister(TX_CONTROL_REG);
+    if ((txControl & 0x03) != 0x03)
+    {
+        writeRegister(TX_CONTROL_REG, txControl | 0x03); // Antenna on
+    }
+
+    uint8_t chipVersion = version();
+    return chipVersion == 0x91 || chipVersion == 0x92 || chipVersion == 0x88;
+}
+
+uint8_t Rc522Reader::version()
+{
+    return readRegister(VERSION_REG);
+}
+
+bool Rc522Reader::calculateCrc(const uint8_t *data, uint8_t length, uint8_t *result)
+{
+    writeRegister(COMMAND_REG, CMD_IDLE);
+    writeRegister(DIV_IRQ_REG, 0x04);    // Clear CRCIRq
+    writeRegister(FIFO_LEVEL_REG, 0x80); // Flush the FIFO
+    writeRegister(FIFO_DATA_REG, data, length);
+    writeRegister(COMMAND_REG, CMD_CALC_CRC);
+
+    unsigned long startedAt = clock->nowMs();
+    while ((readRegister(DIV_IRQ_REG) & 0x04) == 0)
+    {
+        if (clock->nowMs() - startedAt > RC522_TIMEOUT_MS)
+        {
+            return false;
+        }
+    }
+    writeRegister(COMMAND_REG, CMD_IDLE);
+    result[0] = readRegister(CRC_RESULT_L_REG);
+    result[1] = readRegister(CRC_RESULT_H_REG);
+    return true;
+}
+
+bool Rc522Reader::transceive(const uint8_t *data, uint8_t length, uint8_t lastBits, uint8_t *back,
+                             uint8_t &backLength)
+{
+    writeRegister(COMMAND_REG, CMD_IDLE);
+    writeRegister(COM_IRQ_REG, 0x7F);    // Clear all interrupt flags
+    writeRegister(FIFO_LEVEL_REG, 0x80); // Flush the FIFO
+    writeRegister(FIFO_DATA_REG, data, length);
+    writeRegister(BIT_FRAMING_REG, lastBits);
+    writeRegister(COMMAND_REG, CMD_TRANSCEIVE);
+    writeRegister(BIT_FRAMING_REG, 0x80 | lastBits); // StartSend
+
+    unsigned long startedAt = clock->nowMs();
+    for (;;)
+    {
+        uint8_t irq = readRegister(COM_IRQ_REG);
+        if (irq & 0x30) // RxIRq or IdleIRq
+        {
+            break;
+        }
+        if ((irq & 0x01) || clock->nowMs() - startedAt > RC522_TIMEOUT_MS) // TimerIRq: no answer
+        {
+            return false;
+        }
+    }
+    if (readRegister(ERROR_REG) & 0x13) // BufferOvfl, ParityErr, ProtocolErr
+    {
+        return false;
+    }
+    uint8_t received = readRegister(FIFO_LEVEL_REG);
+    if (received > backLength)
+    {
+        return false;
+    }
+    backLength = received;
+    readRegister(FIFO_DATA_REG, back, received);
+    return true;
+}
+
+bool Rc522Reader::readCard(uint8_t *uid)
+{
+    TRACE_SCOPE("rfid.poll");
+    unsigned long startedAt = clock->nowUs();
+
+    // REQA is a short frame: 7 bits, no CRC
+    writeRegister(COLL_REG, readRegister(COLL_REG) & 0x7F);
+    uint8_t request = PICC_REQA;
+    uint8_t atqa[2] = {};
+    uint8_t atqaLength = sizeof(atqa);
+    bool present = transceive(&request, 1, 7, atqa, atqaLength) && atqaLength == 2 &&
+                   (readRegister(CONTROL_REG) & 0x07) == 0;
+    if (!present)
+    {
+        pollDuration.record(clock->nowUs() - startedAt);
+        return false;
+    }
+
+    // Anticollision returns UID0..3 and BCC; SELECT with CRC_A answers SAK and CRC_A.
+    // Buffers start zeroed and every answer is used only at its exact expected length
+    uint8_t frame[9] = {PICC_SEL_CL1, 0x20};
+    uint8_t answer[5] = {};
+    uint8_t answerLength = sizeof(answer);
+    bool read = transceive(frame, 2, 0, answer, answerLength) && answerLength == 5 &&
+                (answer[0] ^ answer[1] ^ answer[2] ^ answer[3]) == answer[4];
+    if (read)
+    {
+        frame[1] = 0x70;
+        memcpy(frame + 2, answer, 5);
+        uint8_t sak[3] = {};
+        uint8_t sakLength = sizeof(sak);
+        uint8_t crc[2] = {};
+        read = calculateCrc(frame, 7, frame + 7) && transceive(frame, 9, 0, sak, sakLength) &&
+               sakLength == 3 && calculateCrc(sak, 1, crc) && crc[0] == sak[1] && crc[1] == sak[2];
+    }
+    if (read)
+    {
+        memcpy(uid, answer, RC522_UID_SIZE);
+
+        // HLTA: the card stays quiet until it leaves the field
+        uint8_t halt[4] = {PICC_HLTA, 0x00};
+        uint8_t none[1] = {};
+        uint8_t noneLength = 0;
+        if (calculateCrc(halt, 2, halt + 2))
+        {
+            transceive(halt, 4, 0, none, noneLength);
+        }
+        cardsRead.add();
+    }
+    else
+    {
+        exchangeErrors.add();
+    }
+    pollDuration.record(clock->nowUs() - startedAt);
+    return read;
+}
+
+void Rc522Reader::registerMetrics(MetricsRegistry &registry)
+{
+    registry.add("rfid.poll_us", pollDuration);
+    registry.add("rfid.cards", cardsRead);
+    registry.add("rfid.errors", exchangeErrors);
+}
@@ -0,0 +1,94 @@
+#ifndef RC522_READER_H
+#define RC522_READER_H
+
+/**
+ * @file Rc522Reader.h
+ * @brief Declares the Rc522Reader class.
+ *
+ * A minimal MFRC522 (RC522) driver for the Modest IoT Nano-framework: enough of the reader's SPI
+ * register interface to detect an ISO 14443-A card (REQA), read its 4-byte UID (anticollision and
+ * SELECT, with CRC_A computed by the reader) and halt it. Attach it to an RfidSensor to turn real
+ * (or simulated, see rfid.chip.c) cards into RFID_DETECTED_EVENTs.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Metrics.h"
+#include "Clock.h"
+#include <SPI.h>
+
+#define RC522_SPI_CLOCK 4000000  ///< SPI clock; the RC522 accepts up to 10 MHz.
+#define RC522_UID_SIZE 4         ///< Single-size (cascade level 1) UIDs only.
+#define RC522_TIMEOUT_MS 5       ///< Host-side limit on one card exchange.
+#define RC522_TIMER_RELOAD 100   ///< Reader timer reload: 100 x 25 us = 2.5 ms without an answer.
+
+class Rc522Reader
+{
+private:
+    int csPin;
+    int rstPin;
+    SPIClass *spi;
+    Clock *clock;
+    Histogram pollDuration; ///< Duration of readCard() calls in microseconds.
+    Counter cardsRead;      ///< UIDs read successfully.
+    Counter exchangeErrors; ///< Card exchanges that failed after a card answered REQA.
+
+    void writeRegister(uint8_t reg, uint8_t value);
+    void writeRegister(uint8_t reg, const uint8_t *values, uint8_t count);
+    uint8_t readRegister(uint8_t reg);
+    void readRegister(uint8_t reg, uint8_t *values, uint8_t count);
+    bool calculateCrc(const uint8_t *data, uint8_t length, uint8_t *result);
+    bool transceive(const uint8_t *data, uint8_t length, uint8_t lastBits, uint8_t *back, uint8_t &backLength);
+
+public:
+    /**
+     * @brief Constructs a reader.
+     * @param csPin Chip select pin (the module's SDA).
+     * @param rstPin Reset pin (-1 if not connected).
+     * @param spi SPI bus the reader is on (default: the default bus, VSPI on the ESP32).
+     * @param clock Time source for exchange timeouts (default: the system clock).
+     */
+    Rc522Reader(int csPin, int rstPin = -1, SPIClass &spi = SPI, Clock &clock = SystemClock::instance());
+
+    /**
+     * @brief Resets and configures the reader and turns the antenna on.
+     * @return True if a reader answered with a known version.
+     */
+    bool begin();
+
+    /**
+     * @brief Gets the reader's VersionReg (0x91 or 0x92 for genuine RC522s).
+     * @return The version byte.
+     */
+    uint8_t version();
+
+    /**
+     * @brief Looks for a new card and reads its UID; the card is halted afterwards.
+     * A halted card is not read again until it leaves the field and comes back.
+     * @param uid Receives RC522_UID_SIZE bytes.
+     * @return True if a card was read.
+     */
+    bool readCard(uint8_t *uid);
+
+    /**
+     * @brief Registers the reader's metrics (`rfid.poll_us`, `rfid.cards`, `rfid.errors`).
+     * @param registry The registry to add them to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
+};
+
+#endif // RC522_READER_H
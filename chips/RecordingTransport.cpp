@@ -0,0 +1,141 @@
+/**
+ * @file RecordingTransport.cpp
+ * @brief Implements the RecordingTransport class.
+ *
+ * Records uploads and answers them from a script of status codes and latencies.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "RecordingTransport.h"
+#include <Arduino.h>
+
+RecordingTransport::RecordingTransport(Clock &clock)
+    : clock(&clock), sink(nullptr), listener(nullptr), listenerContext(nullptr), linkUp(true), uploads(0), bytes(0),
+      latencyBaseMs(0), latencyJitterMs(0), latencyState(1)
+{
+}
+
+bool RecordingTransport::connect(const char *ssid, const char *password)
+{
+    (void)ssid;
+    (void)password;
+    return linkUp;
+}
+
+void RecordingTransport::disconnect()
+{
+}
+
+bool RecordingTransport::isConnected()
+{
+    return linkUp;
+}
+
+int RecordingTransport::post(const TransportRequest &request, char *response, size_t responseSize)
+{
+    ScriptedResponse next;
+    if (!script.pop(next))
+    {
+        next = ScriptedResponse{200, modeledLatencyMs()};
+    }
+    if (next.latencyMs > 0)
+    {
+        clock->sleepMs(next.latencyMs);
+    }
+
+    uploads++;
+    bytes += request.length;
+    if (sink != nullptr)
+    {
+        sink->print("P ");
+        bool verbatim = request.length <= RECORDING_INLINE_BODY_SIZE;
+        for (size_t i = 0; i < request.length && verbatim; i++)
+        {
+            verbatim = request.body[i] >= 0x20 && request.body[i] < 0x7F;
+        }
+        if (verbatim)
+        {
+            sink->write(request.body, request.length);
+        }
+        else
+        {
+            sink->printf("#%08lx", static_cast<unsigned long>(digest(request.body, request.length)));
+        }
+        sink->println();
+    }
+    if (listener != nullptr)
+    {
+        listener(listenerContext, request, next.status);
+    }
+    if (responseSize > 0)
+    {
+        response[0] = '\0';
+    }
+    return next.status;
+}
+
+bool RecordingTransport::scriptResponse(int status, uint32_t latencyMs)
+{
+    return script.push(ScriptedResponse{status, latencyMs});
+}
+
+void RecordingTransport::setLatencyModel(uint32_t baseMs, uint32_t jitterMs, uint32_t seed)
+{
+    latencyBaseMs = baseMs;
+    latencyJitterMs = jitterMs;
+    latencyState = seed != 0 ? seed : 1;
+}
+
+uint32_t RecordingTransport::modeledLatencyMs()
+{
+    if (latencyJitterMs == 0)
+    {
+        return latencyBaseMs;
+    }
+    latencyState ^= latencyState << 13;
+    latencyState ^= latencyState >> 17;
+    latencyState ^= latencyState << 5;
+    return latencyBaseMs + latencyState % (latencyJitterMs + 1);
+}
+
+uint32_t RecordingTransport::digest(const void *data, size_t length)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void RecordingTransport::setSink(Print *output)
+{
+    sink = output;
+}
+
+void RecordingTransport::setListener(Listener callback, void *context)
+{
+    listener = callback;
+    listenerContext = context;
+}
+
+void RecordingTransport::setLinkUp(bool up)
+{
+    linkUp = up;
+}
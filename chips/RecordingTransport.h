@@ -0,0 +1,139 @@
+#ifndef RECORDING_TRANSPORT_H
+#define RECORDING_TRANSPORT_H
+
+/**
+ * @file RecordingTransport.h
+ * @brief Declares the RecordingTransport class.
+ *
+ * An offline Transport for the Modest IoT Nano-framework. Every upload is recorded instead of
+ * sent: written as a `P <body>` line (or `P #<digest>`, see digest()) to an optional sink and
+ * reported to an optional listener.
+ * Responses (status code and latency) are scripted, so a recorded session can be replayed with
+ * the server behaviour it originally saw.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Transport.h"
+#include "BoundedQueue.h"
+#include "Clock.h"
+
+class Print;
+
+#define RECORDING_SCRIPT_DEPTH 16 ///< Scripted responses that can be queued ahead of uploads.
+#define RECORDING_INLINE_BODY_SIZE 256 ///< Longest body written inline; others are written as a digest.
+
+class RecordingTransport : public Transport
+{
+public:
+    /// Called after every recorded upload with the request and the status it was answered with.
+    using Listener = void (*)(void *context, const TransportRequest &request, int status);
+
+private:
+    struct ScriptedResponse
+    {
+        int status;
+        uint32_t latencyMs;
+    };
+
+    BoundedQueue<ScriptedResponse, RECORDING_SCRIPT_DEPTH> script;
+    Clock *clock;
+    Print *sink;
+    Listener listener;
+    void *listenerContext;
+    bool linkUp;
+    uint32_t uploads;
+    uint32_t bytes;
+    uint32_t latencyBaseMs;   ///< Latency of every unscripted upload.
+    uint32_t latencyJitterMs; ///< Largest extra latency drawn per unscripted upload.
+    uint32_t latencyState;    ///< xorshift32 state of the jitter draws.
+
+    uint32_t modeledLatencyMs();
+
+public:
+    /**
+     * @brief Constructs a recording transport.
+     * @param clock Time source that scripted latencies are spent on (default: the system clock).
+     */
+    explicit RecordingTransport(Clock &clock = SystemClock::instance());
+
+    bool connect(const char *ssid, const char *password) override;
+    void disconnect() override;
+    bool isConnected() override;
+
+    /**
+     * @brief Records the request and answers with the next scripted response.
+     * Without a scripted response the upload succeeds with status 200 after the latency of the
+     * model (immediately unless setLatencyModel() was called).
+     * @param request The request to record.
+     * @param response Receives an empty body.
+     * @param responseSize Size of the response buffer.
+     * @return The scripted status code.
+     */
+    int post(const TransportRequest &request, char *response, size_t responseSize) override;
+
+    /**
+     * @brief Queues the response for a future upload.
+     * @param status Status code to return (negative for a transport failure).
+     * @param latencyMs Time the upload takes before returning.
+     * @return True if queued, false if RECORDING_SCRIPT_DEPTH responses are already waiting.
+     */
+    bool scriptResponse(int status, uint32_t latencyMs);
+
+    /**
+     * @brief Gives unscripted uploads a latency: `baseMs` plus a uniform draw of up to `jitterMs`.
+     * The latency is spent on the transport's clock, so a VirtualClock moves forward by it.
+     * @param baseMs Latency of every upload.
+     * @param jitterMs Largest extra latency.
+     * @param seed Seed of the draws, so runs are reproducible.
+     */
+    void setLatencyModel(uint32_t baseMs, uint32_t jitterMs, uint32_t seed = 1);
+
+    /**
+     * @brief Writes every upload as a `P <body>` line.
+     * Bodies longer than RECORDING_INLINE_BODY_SIZE, or not printable on one line (deflated
+     * bodies), are written as `P #<digest>` with the digest() of the whole body in hex.
+     * @param output Destination (nullptr disables recording to a stream).
+     */
+    void setSink(Print *output);
+
+    /**
+     * @brief Digests a body for comparison (32-bit FNV-1a over every byte).
+     * @param data The body.
+     * @param length Its length in bytes.
+     * @return The digest.
+     */
+    static uint32_t digest(const void *data, size_t length);
+
+    /**
+     * @brief Reports every upload to a callback.
+     * @param callback Function to call (nullptr disables it).
+     * @param context Argument passed to the callback.
+     */
+    void setListener(Listener callback, void *context);
+
+    /**
+     * @brief Simulates the link going down or coming back.
+     * @param up True if the link is up.
+     */
+    void setLinkUp(bool up);
+
+    uint32_t uploadCount() const { return uploads; } ///< Uploads recorded.
+    uint32_t uploadedBytes() const { return bytes; } ///< Payload bytes recorded.
+};
+
+#endif // RECORDING_TRANSPORT_H
@@ -0,0 +1,81 @@
+/**
+ * @file RelayModule.cpp
+ * @brief Implements the RelayModule class.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "RelayModule.h"
+#include <Arduino.h>
+
+const Command RelayModule::ACTIVATE_RELAY_COMMAND = Command(ACTIVATE_RELAY_COMMAND_ID);
+const Command RelayModule::DEACTIVATE_RELAY_COMMAND = Command(DEACTIVATE_RELAY_COMMAND_ID);
+
+RelayModule::RelayModule(int pin, bool activeLow, unsigned long minSwitchIntervalMs,
+                         CommandHandler* commandHandler, Clock& clock)
+    : Actuator(pin, commandHandler), clock(&clock), activeLow(activeLow), active(false), pending(false),
+      minIntervalMs(minSwitchIntervalMs), immediateActivation(false), switched(false), lastSwitchMs(0),
+      lastSwitchUs(0) {
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, activeLow ? HIGH : LOW);
+}
+
+void RelayModule::handle(Command command) {
+    if (command == ACTIVATE_RELAY_COMMAND) {
+        set(true);
+    } else if (command == DEACTIVATE_RELAY_COMMAND) {
+        set(false);
+    }
+    Actuator::handle(command); // Propagate to handler if set
+}
+
+void RelayModule::apply(bool energize) {
+    digitalWrite(pin, energize != activeLow ? HIGH : LOW);
+    active = energize;
+    pending = false;
+    switched = true;
+    lastSwitchMs = clock->nowMs();
+    lastSwitchUs = static_cast<uint32_t>(clock->nowUs());
+    switches.add();
+}
+
+bool RelayModule::set(bool energize) {
+    if (energize == active) {
+        pending = false; // A deferred change back is no longer wanted
+        return true;
+    }
+    if (!switched || (energize && immediateActivation) || clock->nowMs() - lastSwitchMs >= minIntervalMs) {
+        apply(energize);
+        return true;
+    }
+    if (!pending) {
+        deferrals.add();
+    }
+    pending = true;
+    return false;
+}
+
+void RelayModule::update() {
+    if (pending && clock->nowMs() - lastSwitchMs >= minIntervalMs) {
+        apply(!active);
+    }
+}
+
+void RelayModule::registerMetrics(MetricsRegistry& registry) {
+    registry.add("relay.switches", switches);
+    registry.add("relay.deferred", deferrals);
+}
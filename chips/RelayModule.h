@@ -0,0 +1,108 @@
+#ifndef RELAY_MODULE_H
+#define RELAY_MODULE_H
+
+/**
+ * @file RelayModule.h
+ * @brief Declares the RelayModule class.
+ *
+ * A concrete actuator class in the Modest IoT Nano-framework for driving a relay module (a
+ * solenoid valve, a pump, a lamp). Mechanical relays and the loads behind them wear with every
+ * switch, so the module enforces a minimum interval between state changes: a request that comes
+ * too soon is deferred, not dropped, and update() applies it once the interval has passed, so the
+ * relay always ends in the last state asked for.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Actuator.h"
+#include "Clock.h"
+#include "Metrics.h"
+
+#define RELAY_MIN_SWITCH_INTERVAL_MS 100 ///< Default shortest time between two state changes.
+
+class RelayModule : public Actuator {
+private:
+    Clock* clock;
+    bool activeLow;              ///< True if the module energizes on a low input.
+    bool active;                 ///< True while the relay is energized.
+    bool pending;                ///< True while a deferred change waits for the interval.
+    unsigned long minIntervalMs; ///< Shortest time between two state changes.
+    bool immediateActivation;    ///< True if energizing ignores the interval.
+    bool switched;               ///< False until the first state change.
+    unsigned long lastSwitchMs;  ///< Time of the last state change.
+    uint32_t lastSwitchUs;       ///< Same instant in microseconds, for latency measurements.
+    Counter switches;            ///< State changes applied.
+    Counter deferrals;           ///< Requests deferred by the rate limit.
+
+    void apply(bool energize);
+
+public:
+    static const int ACTIVATE_RELAY_COMMAND_ID = 40; ///< Unique ID for the activate command.
+    static const int DEACTIVATE_RELAY_COMMAND_ID = 41; ///< Unique ID for the deactivate command.
+    static const Command ACTIVATE_RELAY_COMMAND; ///< Predefined command to energize the relay.
+    static const Command DEACTIVATE_RELAY_COMMAND; ///< Predefined command to release the relay.
+
+    /**
+     * @brief Constructs a relay module (released).
+     * @param pin The GPIO pin driving the module (configured as OUTPUT).
+     * @param activeLow True for modules that energize on a low input.
+     * @param minSwitchIntervalMs Shortest time between two state changes.
+     * @param commandHandler Optional handler to receive commands (default: nullptr).
+     * @param clock Time source (default: the system clock).
+     */
+    RelayModule(int pin, bool activeLow = false, unsigned long minSwitchIntervalMs = RELAY_MIN_SWITCH_INTERVAL_MS,
+                CommandHandler* commandHandler = nullptr, Clock& clock = SystemClock::instance());
+
+    /**
+     * @brief Handles ACTIVATE_RELAY_COMMAND and DEACTIVATE_RELAY_COMMAND.
+     * @param command The command to execute.
+     */
+    void handle(Command command) override;
+
+    /**
+     * @brief Asks for a state; switches now if the interval allows, otherwise defers the change.
+     * @param energize True to energize the relay.
+     * @return True if the relay is in the requested state on return.
+     */
+    bool set(bool energize);
+
+    /**
+     * @brief Lets energizing bypass the minimum interval, so only releases are rate-limited.
+     * For loads whose switch-on latency matters and whose own logic already bounds how soon
+     * they come back on (e.g. a valve that closes only after a delay).
+     * @param immediate True to energize without waiting.
+     */
+    void setImmediateActivation(bool immediate) { immediateActivation = immediate; }
+
+    /**
+     * @brief Applies a deferred change once the interval has passed; call it periodically.
+     */
+    void update();
+
+    bool isActive() const { return active; } ///< True while the relay is energized.
+    bool isPending() const { return pending; } ///< True while a deferred change waits.
+    uint32_t getLastSwitchUs() const { return lastSwitchUs; } ///< Time of the last change (Clock::nowUs()).
+    uint32_t getSwitchCount() const { return switches.get(); } ///< State changes so far.
+
+    /**
+     * @brief Registers `relay.switches` and `relay.deferred`.
+     * @param registry The registry to add them to.
+     */
+    void registerMetrics(MetricsRegistry& registry);
+};
+
+#endif // RELAY_MODULE_H
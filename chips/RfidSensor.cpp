@@ -23,23 +23,55 @@
  */
 
 #include "RfidSensor.h"
+#include "Rc522Reader.h"
+#include "Trace.h"
 #include <Arduino.h>
 
 const Event RfidSensor::RFID_DETECTED_EVENT = Event(RFID_DETECTED_EVENT_ID);
 
-RfidSensor::RfidSensor(int pin, unsigned long scanInterval, EventHandler *eventHandler)
-    : Sensor(pin, eventHandler), scanInterval(scanInterval), lastScan(0), codeCount(0)
+RfidSensor::RfidSensor(int pin, unsigned long scanInterval, EventHandler *eventHandler, Clock &clock)
+    : Sensor(pin, eventHandler), lastScan(0), scanInterval(scanInterval), codeCount(0), simulating(true),
+      clock(&clock), reader(nullptr)
 {
-    lastDetection.isValid = false;
 }
 
-void RfidSensor::addRfidCode(const String &code)
+bool RfidSensor::addRfidCode(const char *code)
 {
-    if (codeCount < 10)
+    size_t length = strnlen(code, RFID_CODE_SIZE);
+    if (length == 0 || length >= RFID_CODE_SIZE || codeCount >= RFID_MAX_CODES || isAllowed(code))
     {
-        availableCodes[codeCount] = code;
-        codeCount++;
+        return false;
     }
+    memcpy(allowedCodes[codeCount], code, length + 1);
+    codeCount++;
+    return true;
+}
+
+bool RfidSensor::removeRfidCode(const char *code)
+{
+    for (int i = 0; i < codeCount; i++)
+    {
+        if (strncmp(allowedCodes[i], code, RFID_CODE_SIZE) == 0)
+        {
+            // Order does not matter to the allowlist; move the last code into the gap
+            codeCount--;
+            memcpy(allowedCodes[i], allowedCodes[codeCount], RFID_CODE_SIZE);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RfidSensor::isAllowed(const char *code) const
+{
+    for (int i = 0; i < codeCount; i++)
+    {
+        if (strncmp(allowedCodes[i], code, RFID_CODE_SIZE) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 void RfidSensor::simulateScan()
@@ -47,26 +79,59 @@ void RfidSensor::simulateScan()
     if (codeCount > 0)
     {
         int index = random(0, codeCount);
-        lastDetection.rfidCode = availableCodes[index];
-        lastDetection.scanType = "ENTRY";
-        lastDetection.isValid = true;
-
-        lastScan = millis();
+        injectScan(allowedCodes[index], "ENTRY");
+    }
+}
 
-        // Trigger RFID detection event
-        on(RFID_DETECTED_EVENT);
+bool RfidSensor::injectScan(const char *code, const char *scanType)
+{
+    RfidData detection;
+    strncpy(detection.rfidCode, code, sizeof(detection.rfidCode) - 1);
+    detection.rfidCode[sizeof(detection.rfidCode) - 1] = '\0';
+    strncpy(detection.scanType, scanType, sizeof(detection.scanType) - 1);
+    detection.scanType[sizeof(detection.scanType) - 1] = '\0';
+    detection.isValid = true;
+    detection.allowed = isAllowed(code);
+    if (!detection.allowed)
+    {
+        deniedScans.add(); // Still published: the server records denied access attempts too
     }
+
+    lastScan = clock->nowMs();
+
+    // Trigger RFID detection event carrying the scan
+    on(Event(RFID_DETECTED_EVENT_ID, detection, lastScan));
+    return detection.allowed;
+}
+
+void RfidSensor::setSimulation(bool enabled)
+{
+    simulating = enabled;
+}
+
+void RfidSensor::setReader(Rc522Reader *reader)
+{
+    this->reader = reader;
+    simulating = reader == nullptr;
 }
 
 void RfidSensor::update()
 {
-    if (millis() - lastScan >= scanInterval)
+    TRACE_SCOPE("rfid.update");
+    uint8_t uid[RC522_UID_SIZE];
+    if (reader != nullptr && reader->readCard(uid))
+    {
+        char code[RFID_CODE_SIZE];
+        snprintf(code, sizeof(code), "%02X%02X%02X%02X", uid[0], uid[1], uid[2], uid[3]);
+        injectScan(code, "ENTRY");
+    }
+    if (simulating && clock->nowMs() - lastScan >= scanInterval)
     {
         simulateScan();
     }
 }
 
-RfidData RfidSensor::getLastDetection() const
+void RfidSensor::registerMetrics(MetricsRegistry &registry)
 {
-    return lastDetection;
+    registry.add("rfid.denied", deniedScans);
 }
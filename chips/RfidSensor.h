@@ -26,12 +26,25 @@
  */
 
 #include "Sensor.h"
+#include "Metrics.h"
+#include "Clock.h"
+#include <Arduino.h>
 
+class Rc522Reader;
+
+#define RFID_CODE_SIZE 16     ///< Maximum RFID code length, including terminator.
+#define RFID_SCAN_TYPE_SIZE 8 ///< Maximum scan type length, including terminator.
+#define RFID_MAX_CODES 32     ///< Codes the allowlist holds.
+
+/**
+ * @brief RFID detection carried as the payload of RFID_DETECTED_EVENT.
+ */
 struct RfidData
 {
-    String rfidCode;
-    String scanType;
+    char rfidCode[RFID_CODE_SIZE];
+    char scanType[RFID_SCAN_TYPE_SIZE];
     bool isValid;
+    bool allowed; ///< True if the code is on the allowlist; false for a denied access.
 };
 
 class RfidSensor : public Sensor
@@ -39,9 +52,12 @@ class RfidSensor : public Sensor
 private:
     unsigned long lastScan;
     unsigned long scanInterval;
-    String availableCodes[10];
+    char allowedCodes[RFID_MAX_CODES][RFID_CODE_SIZE]; ///< Codes granted access.
     int codeCount;
-    RfidData lastDetection;
+    bool simulating; ///< True while update() generates random scans.
+    Clock *clock;    ///< Time source for the scan interval.
+    Rc522Reader *reader; ///< Card reader polled by update(), if attached.
+    Counter deniedScans; ///< Scans of codes that are not allowlisted.
 
 public:
     static const int RFID_DETECTED_EVENT_ID = 11; ///< Unique ID for RFID detection event.
@@ -52,30 +68,73 @@ public:
      * @param pin The GPIO pin for RFID sensor (if applicable).
      * @param scanInterval Interval between RFID scans in milliseconds.
      * @param eventHandler Optional handler to receive RFID events (default: nullptr).
+     * @param clock Time source (default: the system clock).
      */
-    RfidSensor(int pin, unsigned long scanInterval = 5000, EventHandler *eventHandler = nullptr);
+    RfidSensor(int pin, unsigned long scanInterval = 5000, EventHandler *eventHandler = nullptr,
+               Clock &clock = SystemClock::instance());
 
     /**
-     * @brief Adds an RFID code to the list of available codes for simulation.
+     * @brief Adds an RFID code to the allowlist.
+     * Scans of listed codes are granted access, whatever the source; the scan simulation draws
+     * from the same list.
      * @param code The RFID code to add.
+     * @return True if added, false if it is empty, too long, already listed, or the list is full.
+     */
+    bool addRfidCode(const char *code);
+
+    /**
+     * @brief Removes an RFID code from the allowlist.
+     * @param code The RFID code to remove.
+     * @return True if the code was in the list.
+     */
+    bool removeRfidCode(const char *code);
+
+    /**
+     * @brief Checks a code against the allowlist.
+     * @param code The RFID code.
+     * @return True if scans of the code are granted access.
      */
-    void addRfidCode(const String &code);
+    bool isAllowed(const char *code) const;
 
     /**
-     * @brief Simulates RFID scanning, randomly selecting from available codes.
+     * @brief Simulates RFID scanning, randomly selecting from the allowlisted codes.
+     * The detection is delivered as an RfidData payload of RFID_DETECTED_EVENT.
      */
     void simulateScan();
 
     /**
-     * @brief Gets the last detected RFID data.
-     * @return RfidData structure with latest detection info.
+     * @brief Publishes a detection from an external source (real reader or recorded session).
+     * Every scan is published. One whose code is missing from the allowlist is flagged as denied
+     * (RfidData::allowed is false) and counted in `rfid.denied`.
+     * @param code The RFID code read.
+     * @param scanType "ENTRY" or "EXIT".
+     * @return True if access was granted.
      */
-    RfidData getLastDetection() const;
+    bool injectScan(const char *code, const char *scanType);
+
+    /**
+     * @brief Enables or disables the random scans generated by update().
+     * @param enabled False when detections are injected instead.
+     */
+    void setSimulation(bool enabled);
+
+    /**
+     * @brief Reads cards from an RC522 instead of simulating scans.
+     * Every update() polls the reader and publishes each UID read, as upper-case hex.
+     * @param reader The reader (already started with begin()), or nullptr to detach it.
+     */
+    void setReader(Rc522Reader *reader);
 
     /**
      * @brief Updates the sensor, checking for new RFID detections.
      */
     void update();
+
+    /**
+     * @brief Registers the sensor's metrics (`rfid.denied`).
+     * @param registry The registry to add them to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
 };
 
 #endif // RFID_SENSOR_H
@@ -0,0 +1,292 @@
+#ifndef SAMPLED_SENSOR_H
+#define SAMPLED_SENSOR_H
+
+/**
+ * @file SampledSensor.h
+ * @brief Declares the SampledSensor template.
+ *
+ * Base class for sensors read at a fixed rate in the Modest IoT Nano-framework. update() takes a
+ * sample whenever the schedule says one is due (the schedule never drifts; samples a late caller
+ * missed are counted, not taken in a burst) and keeps the last N in a ring buffer. Minimum,
+ * maximum, mean and standard deviation of that window are maintained incrementally, so each
+ * sample costs O(1) whatever N is. Instead of one event per sample, the sensor publishes a
+ * SampleSummary every `publishEvery` samples, letting a fast sensor report at an aggregated rate.
+ *
+ * Subclasses implement sample(); sensors that capture readings asynchronously (e.g. in an
+ * interrupt) can feed them with record() instead.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Sensor.h"
+#include "Clock.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+/**
+ * @brief Statistics of a sample window, carried as the payload of a sensor's summary event.
+ */
+struct SampleSummary {
+    float minimum;    ///< Smallest sample in the window.
+    float maximum;    ///< Largest sample in the window.
+    float mean;       ///< Mean of the window.
+    float stddev;     ///< Population standard deviation of the window.
+    float latest;     ///< Newest sample.
+    uint16_t samples; ///< Samples in the window.
+    uint16_t missed;  ///< Samples skipped or failed since the previous summary.
+    uint32_t spanMs;  ///< Time from the oldest to the newest sample in the window.
+};
+
+/**
+ * @brief Sensor sampled at a fixed rate, with statistics over its last `N` samples.
+ * @tparam T Sample type (any arithmetic type).
+ * @tparam N Window length in samples.
+ */
+template <typename T, size_t N>
+class SampledSensor : public Sensor {
+    static_assert(std::is_arithmetic<T>::value, "SampledSensor samples must be numbers");
+    static_assert(N > 0 && N <= 0xFFFF, "SampledSensor window must hold 1 to 65535 samples");
+
+private:
+    /**
+     * @brief Sample numbers whose values are monotonic, front first: the front is the extremum.
+     */
+    struct MonotonicIndex {
+        uint32_t items[N];
+        size_t first;
+        size_t count;
+    };
+
+    Clock* clock;
+    int summaryEventId;
+    unsigned long periodMs;     ///< Time between samples.
+    unsigned long nextSampleMs; ///< When the next sample is due.
+    bool scheduled;             ///< False until the first update() anchors the schedule.
+    size_t publishEvery;        ///< Samples between summaries.
+    size_t sinceSummary;        ///< Samples since the last summary.
+
+    T values[N];                ///< Ring of the newest samples, indexed by sample number % N.
+    unsigned long times[N];     ///< Capture time of each sample.
+    uint32_t taken;             ///< Samples ever recorded (the next sample's number).
+    size_t count;               ///< Samples in the window.
+    float mean;                 ///< Running mean of the window.
+    float squares;              ///< Running sum of squared deviations from the mean.
+    MonotonicIndex lowest;      ///< Candidates for the minimum.
+    MonotonicIndex highest;     ///< Candidates for the maximum.
+    uint16_t missed;            ///< Samples skipped or failed since the last summary.
+    uint32_t missedTotal;       ///< Samples skipped or failed so far.
+
+    const T& valueOf(uint32_t sampleNumber) const { return values[sampleNumber % N]; }
+
+    void push(MonotonicIndex& index, uint32_t sampleNumber, bool smallest) {
+        // Drop the sample leaving the window, then every candidate the new sample beats
+        if (index.count > 0 && taken - index.items[index.first] > N) {
+            index.first = (index.first + 1) % N;
+            index.count--;
+        }
+        const T& value = valueOf(sampleNumber);
+        while (index.count > 0) {
+            const T& back = valueOf(index.items[(index.first + index.count - 1) % N]);
+            if (smallest ? back < value : back > value) {
+                break;
+            }
+            index.count--;
+        }
+        index.items[(index.first + index.count) % N] = sampleNumber;
+        index.count++;
+    }
+
+    /**
+     * @brief Recomputes the mean and squared deviations from the window, discarding rounding drift.
+     */
+    void resync() {
+        float sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            sum += static_cast<float>(values[i]);
+        }
+        mean = sum / count;
+        squares = 0;
+        for (size_t i = 0; i < count; i++) {
+            float deviation = static_cast<float>(values[i]) - mean;
+            squares += deviation * deviation;
+        }
+    }
+
+protected:
+    /**
+     * @brief Reads one sample; called by update() when a sample is due.
+     * @param value Destination for the reading.
+     * @return True if a reading was taken, false if none was available (counted as missed).
+     */
+    virtual bool sample(T& value) = 0;
+
+    /**
+     * @brief Adds a sample to the window and publishes a summary when one is due.
+     * @param value The reading.
+     * @param atMs Capture time in Clock::nowMs() units.
+     */
+    void record(T value, unsigned long atMs) {
+        uint32_t number = taken;
+        float incoming = static_cast<float>(value);
+        if (count < N) {
+            // Welford's update while the window fills
+            count++;
+            float deviation = incoming - mean;
+            mean += deviation / count;
+            squares += deviation * (incoming - mean);
+        } else {
+            // Sliding update: the new sample replaces the oldest one
+            float outgoing = static_cast<float>(valueOf(number));
+            float previousMean = mean;
+            mean += (incoming - outgoing) / N;
+            squares += (incoming - outgoing) * (incoming - mean + outgoing - previousMean);
+            if (squares < 0) {
+                squares = 0;
+            }
+        }
+        values[number % N] = value;
+        times[number % N] = atMs;
+        taken++;
+        if (count == N && taken % N == 0) {
+            resync();
+        }
+        push(lowest, number, true);
+        push(highest, number, false);
+
+        if (++sinceSummary >= publishEvery) {
+            SampleSummary windowSummary = summary();
+            sinceSummary = 0;
+            missed = 0;
+            on(Event(summaryEventId, windowSummary, atMs));
+        }
+    }
+
+    /**
+     * @brief Counts a sample that could not be taken.
+     */
+    void recordMissed(uint32_t samples = 1) {
+        missed = missed + samples > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(missed + samples);
+        missedTotal += samples;
+    }
+
+    Clock& getClock() { return *clock; } ///< Time source of the sensor.
+
+public:
+    /**
+     * @brief Constructs a sampled sensor.
+     * @param pin The GPIO pin of the sensor.
+     * @param samplePeriodMs Time between samples in milliseconds.
+     * @param summaryEventId Id of the event carrying each SampleSummary.
+     * @param publishEvery Samples between summaries (default: one window).
+     * @param eventHandler Optional handler to receive the summaries (default: nullptr).
+     * @param clock Time source (default: the system clock).
+     */
+    SampledSensor(int pin, unsigned long samplePeriodMs, int summaryEventId, size_t publishEvery = N,
+                  EventHandler* eventHandler = nullptr, Clock& clock = SystemClock::instance())
+        : Sensor(pin, eventHandler), clock(&clock), summaryEventId(summaryEventId),
+          periodMs(samplePeriodMs > 0 ? samplePeriodMs : 1), nextSampleMs(0), scheduled(false),
+          publishEvery(publishEvery > 0 ? publishEvery : N), sinceSummary(0), values(), times(), taken(0),
+          count(0), mean(0), squares(0), lowest(), highest(), missed(0), missedTotal(0) {}
+
+    /**
+     * @brief Takes a sample if one is due; call it at least as often as the sample period.
+     * @return True if a sample was taken.
+     */
+    bool update() {
+        unsigned long now = clock->nowMs();
+        if (!scheduled) {
+            nextSampleMs = now;
+            scheduled = true;
+        }
+        if (static_cast<long>(now - nextSampleMs) < 0) {
+            return false;
+        }
+
+        unsigned long late = now - nextSampleMs;
+        if (late >= periodMs) {
+            // Readings taken now cannot stand in for the instants that passed
+            unsigned long skipped = late / periodMs;
+            recordMissed(skipped);
+            nextSampleMs += skipped * periodMs;
+        }
+        nextSampleMs += periodMs;
+
+        T value;
+        if (!sample(value)) {
+            recordMissed();
+            return false;
+        }
+        record(value, now);
+        return true;
+    }
+
+    /**
+     * @brief Gets the statistics of the current window.
+     * @return The summary (all zero before the first sample).
+     */
+    SampleSummary summary() const {
+        SampleSummary result = {};
+        if (count > 0) {
+            uint32_t newest = taken - 1;
+            result.minimum = static_cast<float>(valueOf(lowest.items[lowest.first]));
+            result.maximum = static_cast<float>(valueOf(highest.items[highest.first]));
+            result.mean = mean;
+            result.stddev = sqrtf(squares / count);
+            result.latest = static_cast<float>(valueOf(newest));
+            result.samples = static_cast<uint16_t>(count);
+            result.missed = missed;
+            result.spanMs = static_cast<uint32_t>(times[newest % N] - times[(taken - count) % N]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Changes the sampling rate; the next sample is due one new period after the last one.
+     * @param samplePeriodMs Time between samples in milliseconds.
+     */
+    void setSamplePeriod(unsigned long samplePeriodMs) {
+        if (scheduled) {
+            nextSampleMs += (samplePeriodMs > 0 ? samplePeriodMs : 1) - periodMs;
+        }
+        periodMs = samplePeriodMs > 0 ? samplePeriodMs : 1;
+    }
+
+    /**
+     * @brief Empties the window; the next update() samples at once and restarts the schedule.
+     */
+    void reset() {
+        scheduled = false;
+        sinceSummary = 0;
+        count = 0;
+        mean = 0;
+        squares = 0;
+        lowest.count = 0;
+        highest.count = 0;
+        missed = 0;
+    }
+
+    unsigned long getSamplePeriod() const { return periodMs; } ///< Time between samples.
+    T latest() const { return count > 0 ? valueOf(taken - 1) : T(); } ///< Newest sample (0 if none).
+    size_t windowSize() const { return count; } ///< Samples in the window.
+    uint32_t samplesTaken() const { return taken; } ///< Samples recorded so far.
+    uint32_t samplesMissed() const { return missedTotal; } ///< Samples skipped or failed so far.
+    static constexpr size_t windowCapacity() { return N; } ///< Window length in samples.
+};
+
+#endif // SAMPLED_SENSOR_H
@@ -0,0 +1,72 @@
+/**
+ * @file ScanPattern.cpp
+ * @brief Implements the ScanPattern class.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ScanPattern.h"
+#include <math.h>
+#include <stdio.h>
+
+ScanPattern::ScanPattern(RfidSensor &sensor, Clock &clock, unsigned long meanIntervalMs, uint32_t seed)
+    : sensor(&sensor), clock(&clock), meanIntervalMs(meanIntervalMs), nextScanAt(0),
+      randomState(seed != 0 ? seed : 1), cardBase(0), onBoard(0), scans(0)
+{
+    cardBase = (nextRandom() % 100000) * SCAN_PATTERN_CARDS;
+    for (uint32_t card = 0; card < SCAN_PATTERN_CARDS; card++)
+    {
+        // The sensor only publishes allowlisted cards
+        char code[RFID_CODE_SIZE];
+        snprintf(code, sizeof(code), "C%07lu", static_cast<unsigned long>(cardBase + card));
+        sensor.addRfidCode(code);
+    }
+    scheduleNext(clock.nowMs());
+}
+
+uint32_t ScanPattern::nextRandom()
+{
+    uint32_t x = randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    randomState = x;
+    return x;
+}
+
+void ScanPattern::scheduleNext(unsigned long now)
+{
+    // Exponential inter-arrival time: -mean * ln(U), U in (0, 1]
+    double uniform = (nextRandom() % 1000000 + 1) / 1000000.0;
+    nextScanAt = now + static_cast<unsigned long>(-log(uniform) * meanIntervalMs);
+}
+
+void ScanPattern::update()
+{
+    unsigned long now = clock->nowMs();
+    while (static_cast<long>(now - nextScanAt) >= 0)
+    {
+        uint32_t card = nextRandom() % SCAN_PATTERN_CARDS;
+        uint16_t bit = static_cast<uint16_t>(1u << card);
+        char code[RFID_CODE_SIZE];
+        snprintf(code, sizeof(code), "C%07lu", static_cast<unsigned long>(cardBase + card));
+        sensor->injectScan(code, (onBoard & bit) != 0 ? "EXIT" : "ENTRY");
+        onBoard ^= bit;
+        scans++;
+        scheduleNext(nextScanAt);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef SCAN_PATTERN_H
+#define SCAN_PATTERN_H
+
+/**
+ * @file ScanPattern.h
+ * @brief Declares the ScanPattern class.
+ *
+ * A synthetic RFID workload for the Modest IoT Nano-framework. Scans arrive at exponentially
+ * distributed intervals around a mean (a Poisson process, like passengers boarding) from a pool
+ * of card codes; each card alternates between ENTRY and EXIT. Detections are injected into an
+ * RfidSensor, so the device handles them exactly like reads from a real reader.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "RfidSensor.h"
+#include "Clock.h"
+
+#define SCAN_PATTERN_CARDS 16 ///< Distinct cards in each pattern's pool.
+
+class ScanPattern
+{
+    static_assert(SCAN_PATTERN_CARDS <= 16, "Card state is kept in a 16-bit mask");
+
+private:
+    RfidSensor *sensor;
+    Clock *clock;
+    unsigned long meanIntervalMs;
+    unsigned long nextScanAt;
+    uint32_t randomState;
+    uint32_t cardBase;  ///< First card number of this pattern's pool.
+    uint16_t onBoard;   ///< Bit per card: set after ENTRY, cleared after EXIT.
+    uint32_t scans;
+
+    uint32_t nextRandom();
+    void scheduleNext(unsigned long now);
+
+public:
+    /**
+     * @brief Constructs a scan pattern.
+     * @param sensor The sensor detections are injected into.
+     * @param clock Time source for the schedule.
+     * @param meanIntervalMs Mean time between scans in milliseconds.
+     * @param seed Seed for arrivals and card choice (0 is treated as 1).
+     */
+    ScanPattern(RfidSensor &sensor, Clock &clock, unsigned long meanIntervalMs, uint32_t seed = 1);
+
+    /**
+     * @brief Injects every scan that has fallen due.
+     * Call from the same context that updates the sensor.
+     */
+    void update();
+
+    uint32_t scanCount() const { return scans; } ///< Scans injected so far.
+};
+
+#endif // SCAN_PATTERN_H
@@ -0,0 +1,254 @@
+/**
+ * @file SessionReplay.cpp
+ * @brief Implements the ReplayStream and SessionReplay classes.
+ *
+ * Parses trace records, drives the device one pass per distinct timestamp and matches its
+ * uploads against the reference payloads as they stream in, so only the unmatched digests on
+ * either side are held in memory.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "SessionReplay.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+bool ReplayStream::feed(const char *sentence)
+{
+    bool fits = true;
+    for (const char *c = sentence; *c != '\0'; c++)
+    {
+        fits = bytes.push(static_cast<uint8_t>(*c)) && fits;
+    }
+    fits = bytes.push('\r') && fits;
+    return bytes.push('\n') && fits;
+}
+
+int ReplayStream::available()
+{
+    return static_cast<int>(bytes.size());
+}
+
+int ReplayStream::read()
+{
+    uint8_t byte;
+    return bytes.pop(byte) ? byte : -1;
+}
+
+int ReplayStream::peek()
+{
+    const uint8_t *byte = bytes.peek();
+    return byte != nullptr ? *byte : -1;
+}
+
+size_t ReplayStream::write(uint8_t byte)
+{
+    return bytes.push(byte) ? 1 : 0;
+}
+
+SessionReplay::SessionReplay(TrackingDevice &device, RecordingTransport &transport, VirtualClock *clock)
+    : device(device), transport(transport), clock(clock), speed(0), batchStartedAt(0),
+      records(0), matched(0), mismatched(0), missing(0), extra(0)
+{
+    device.getCommunicationHandler()->setTransport(&transport);
+    device.getGpsSensor()->setInput(&nmea);
+    device.getRfidSensor()->setSimulation(false);
+    transport.setListener(onUpload, this);
+}
+
+void SessionReplay::setSpeed(float factor)
+{
+    speed = factor;
+}
+
+void SessionReplay::onUpload(void *context, const TransportRequest &request, int status)
+{
+    (void)status;
+    SessionReplay *self = static_cast<SessionReplay *>(context);
+    if (self->batchStartedAt != 0)
+    {
+        self->latency.record(micros() - self->batchStartedAt);
+    }
+
+    uint32_t got = RecordingTransport::digest(request.body, request.length);
+    uint32_t want;
+    if (self->expected.pop(want))
+    {
+        self->compare(want, got);
+    }
+    else if (!self->produced.push(got))
+    {
+        self->extra++;
+    }
+}
+
+void SessionReplay::apply(char type, char *arguments)
+{
+    switch (type)
+    {
+    case 'G':
+        if (batchStartedAt == 0)
+        {
+            batchStartedAt = micros();
+        }
+        nmea.feed(arguments);
+        break;
+    case 'R':
+    {
+        char *scanType = strchr(arguments, ' ');
+        if (scanType != nullptr)
+        {
+            *scanType++ = '\0';
+        }
+        if (batchStartedAt == 0)
+        {
+            batchStartedAt = micros();
+        }
+        device.getRfidSensor()->injectScan(arguments, scanType != nullptr ? scanType : "ENTRY");
+        break;
+    }
+    case 'H':
+    {
+        char *rest = nullptr;
+        long status = strtol(arguments, &rest, 10);
+        transport.scriptResponse(static_cast<int>(status), strtoul(rest, nullptr, 10));
+        break;
+    }
+    case 'P':
+    {
+        uint32_t want = arguments[0] == '#'
+                            ? static_cast<uint32_t>(strtoul(arguments + 1, nullptr, 16))
+                            : RecordingTransport::digest(arguments, strlen(arguments));
+        uint32_t got;
+        if (produced.pop(got))
+        {
+            compare(want, got);
+        }
+        else if (!expected.push(want))
+        {
+            missing++;
+        }
+        break;
+    }
+    default:
+        return;
+    }
+    records++;
+}
+
+void SessionReplay::pass()
+{
+    device.runOnce();
+    batchStartedAt = 0;
+}
+
+void SessionReplay::compare(uint32_t want, uint32_t got)
+{
+    if (got == want)
+    {
+        matched++;
+    }
+    else
+    {
+        mismatched++;
+    }
+}
+
+void SessionReplay::finish()
+{
+    uint32_t digest;
+    while (expected.pop(digest))
+    {
+        missing++;
+    }
+    while (produced.pop(digest))
+    {
+        extra++;
+    }
+}
+
+bool SessionReplay::run(Stream &trace, Print &report)
+{
+    char line[REPLAY_LINE_SIZE];
+    unsigned long sessionTime = 0;
+    unsigned long startedAt = micros();
+    unsigned long wallStartedAt = millis();
+    uint64_t clockStartedAt = clock != nullptr ? clock->elapsedMs() : 0;
+
+    for (;;)
+    {
+        size_t length = trace.readBytesUntil('\n', line, sizeof(line) - 1);
+        if (length == 0 && trace.available() <= 0)
+        {
+            break;
+        }
+        line[length] = '\0';
+        if (length > 0 && line[length - 1] == '\r')
+        {
+            line[--length] = '\0';
+        }
+
+        // "<ms> <type> <arguments>"
+        char *cursor = nullptr;
+        unsigned long timestamp = strtoul(line, &cursor, 10);
+        if (cursor == line || cursor[0] != ' ' || cursor[1] == '\0')
+        {
+            continue;
+        }
+        char type = cursor[1];
+        char *arguments = cursor[2] == ' ' ? cursor + 3 : cursor + 2;
+
+        // Inputs sharing a timestamp form one batch; the device processes it in one pass
+        if (timestamp != sessionTime && type != 'P')
+        {
+            pass();
+            if (clock != nullptr)
+            {
+                clock->advanceToMs(clockStartedAt + timestamp);
+            }
+            else if (speed > 0 && timestamp > sessionTime)
+            {
+                unsigned long due = wallStartedAt + static_cast<unsigned long>(timestamp / speed);
+                while (static_cast<long>(due - millis()) > 0)
+                {
+                    delay(1);
+                }
+            }
+            sessionTime = timestamp;
+        }
+        apply(type, arguments);
+    }
+    pass();
+    finish();
+
+    unsigned long elapsed = micros() - startedAt;
+    double seconds = (elapsed > 0 ? elapsed : 1) / 1000000.0;
+    char summary[REPLAY_SUMMARY_SIZE];
+    snprintf(summary, sizeof(summary),
+             "{\"replay\":{\"records\":%lu,\"uploads\":%lu,\"session_ms\":%lu,\"wall_ms\":%lu,"
+             "\"events_per_s\":%.0f,\"latency_us\":{\"p50\":%lu,\"p99\":%lu,\"max\":%lu},"
+             "\"matched\":%lu,\"mismatched\":%lu,\"missing\":%lu,\"extra\":%lu}}",
+             static_cast<unsigned long>(records), static_cast<unsigned long>(transport.uploadCount()),
+             sessionTime, elapsed / 1000, records / seconds,
+             static_cast<unsigned long>(latency.percentile(50)),
+             static_cast<unsigned long>(latency.percentile(99)),
+             static_cast<unsigned long>(latency.max()),
+             static_cast<unsigned long>(matched), static_cast<unsigned long>(mismatched),
+             static_cast<unsigned long>(missing), static_cast<unsigned long>(extra));
+    report.println(summary);
+    return mismatched == 0 && missing == 0 && extra == 0;
+}
@@ -0,0 +1,135 @@
+#ifndef SESSION_REPLAY_H
+#define SESSION_REPLAY_H
+
+/**
+ * @file SessionReplay.h
+ * @brief Declares the ReplayStream and SessionReplay classes.
+ *
+ * Deterministic replay of recorded device sessions for the Modest IoT Nano-framework. A trace
+ * is read line by line from any Stream (serial console, a file on flash, or stdin on a host
+ * build) and drives an unmodified TrackingDevice: NMEA bytes are fed to the GPS sensor, RFID
+ * detections are injected, and server responses are scripted on a RecordingTransport. Every
+ * outbound payload is compared with the reference payloads in the trace, in order and as soon
+ * as both sides are known, by the digest of the whole body.
+ *
+ * Trace format, one record per line, timestamps in milliseconds since the session started:
+ *
+ *     <ms> G <NMEA sentence>        bytes received from the GPS receiver
+ *     <ms> R <code> <ENTRY|EXIT>    RFID detection
+ *     <ms> H <status> <latency_ms>  server response to the next upload
+ *     <ms> P <payload>              reference outbound payload
+ *     <ms> P #<digest>              reference payload given by RecordingTransport::digest() in hex
+ *
+ * A RecordingTransport sink writes `P` lines in the same format, so the output of one run can
+ * be merged into the trace as the reference for the next.
+ *
+ * With a VirtualClock the trace timestamps drive device time: the replay runs as fast as the
+ * CPU allows and wall-clock timestamps in the payloads are reproducible.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "TrackingDevice.h"
+#include "RecordingTransport.h"
+#include "BoundedQueue.h"
+#include "Metrics.h"
+#include <Arduino.h>
+
+#define REPLAY_LINE_SIZE 300          ///< Longest trace line (a reference payload plus its prefix).
+#define REPLAY_NMEA_BUFFER_SIZE 1024  ///< NMEA bytes buffered between device passes.
+#define REPLAY_PENDING_DEPTH 64       ///< Payload digests awaiting their counterpart on each side.
+#define REPLAY_SUMMARY_SIZE 512       ///< Summary line: fits every field at its widest (about 330 bytes).
+
+/**
+ * @brief In-memory byte stream the GPS sensor reads replayed NMEA from.
+ */
+class ReplayStream : public Stream
+{
+private:
+    BoundedQueue<uint8_t, REPLAY_NMEA_BUFFER_SIZE> bytes;
+
+public:
+    /**
+     * @brief Appends a sentence followed by CR LF.
+     * @param sentence The NMEA sentence.
+     * @return False if the buffer overflowed (bytes were dropped).
+     */
+    bool feed(const char *sentence);
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t byte) override;
+};
+
+class SessionReplay
+{
+private:
+    TrackingDevice &device;
+    RecordingTransport &transport;
+    ReplayStream nmea;
+    VirtualClock *clock; ///< Device clock advanced from trace timestamps, if virtual.
+    float speed;
+
+    BoundedQueue<uint32_t, REPLAY_PENDING_DEPTH> expected; ///< Reference digests the device has not produced yet.
+    BoundedQueue<uint32_t, REPLAY_PENDING_DEPTH> produced; ///< Device digests the trace has not reached yet.
+    unsigned long batchStartedAt; ///< micros() when the first input of the current pass was injected.
+
+    uint32_t records;
+    uint32_t matched;
+    uint32_t mismatched;
+    uint32_t missing;
+    uint32_t extra;
+    Histogram latency; ///< Input injection to upload, in microseconds.
+
+    static void onUpload(void *context, const TransportRequest &request, int status);
+
+    void apply(char type, char *arguments);
+    void pass();
+    void compare(uint32_t want, uint32_t got);
+    void finish();
+
+public:
+    /**
+     * @brief Wires a replay into a device. Call before device.initialize().
+     * Replaces the device's transport with `transport`, its NMEA source with the replay
+     * stream, and disables the RFID scan simulation.
+     * @param device The device under replay.
+     * @param transport The transport that records the device's uploads.
+     * @param clock The device's clock if it is virtual (nullptr replays in real time).
+     */
+    SessionReplay(TrackingDevice &device, RecordingTransport &transport, VirtualClock *clock = nullptr);
+
+    /**
+     * @brief Sets the replay speed.
+     * Ignored with a VirtualClock, which always replays as fast as possible.
+     * @param factor Multiple of real time to honour trace timestamps at (0 = as fast as possible).
+     */
+    void setSpeed(float factor);
+
+    /**
+     * @brief Replays a whole trace and prints a summary.
+     * The summary is one JSON line: records, uploads, events per second, injection-to-upload
+     * latency percentiles and divergence from the reference payloads.
+     * @param trace Source of trace lines.
+     * @param report Destination for the summary.
+     * @return True if every reference payload was reproduced exactly.
+     */
+    bool run(Stream &trace, Print &report);
+};
+
+#endif // SESSION_REPLAY_H
@@ -0,0 +1,166 @@
+/**
+ * @file SocketClient.cpp
+ * @brief Implements the SocketClient class.
+ *
+ * Non-blocking reads and blocking writes over a POSIX TCP socket for host builds.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#ifndef ESP32
+
+#include "SocketClient.h"
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+SocketClient::SocketClient() : socketFd(-1)
+{
+}
+
+SocketClient::~SocketClient()
+{
+    stop();
+}
+
+int SocketClient::connect(const char *host, uint16_t port)
+{
+    stop();
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    if (getaddrinfo(host, service, &hints, &result) != 0 || result == nullptr)
+    {
+        return 0;
+    }
+    for (addrinfo *address = result; address != nullptr; address = address->ai_next)
+    {
+        int candidate = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (candidate < 0)
+        {
+            continue;
+        }
+        if (::connect(candidate, address->ai_addr, address->ai_addrlen) == 0)
+        {
+            int noDelay = 1;
+            setsockopt(candidate, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            socketFd = candidate;
+            break;
+        }
+        close(candidate);
+    }
+    freeaddrinfo(result);
+    return socketFd >= 0 ? 1 : 0;
+}
+
+size_t SocketClient::write(uint8_t byte)
+{
+    return write(&byte, 1);
+}
+
+size_t SocketClient::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    while (socketFd >= 0 && written < size)
+    {
+        ssize_t sent = send(socketFd, buffer + written, size - written, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            stop();
+            break;
+        }
+        written += sent;
+    }
+    return written;
+}
+
+int SocketClient::available()
+{
+    int waiting = 0;
+    if (socketFd < 0 || ioctl(socketFd, FIONREAD, &waiting) != 0)
+    {
+        return 0;
+    }
+    return waiting;
+}
+
+int SocketClient::read()
+{
+    uint8_t byte;
+    return read(&byte, 1) == 1 ? byte : -1;
+}
+
+int SocketClient::read(uint8_t *buffer, size_t size)
+{
+    if (socketFd < 0)
+    {
+        return -1;
+    }
+    ssize_t received = recv(socketFd, buffer, size, MSG_DONTWAIT);
+    if (received == 0)
+    {
+        stop(); // Orderly close by the peer
+        return -1;
+    }
+    return received > 0 ? static_cast<int>(received) : -1;
+}
+
+int SocketClient::peek()
+{
+    uint8_t byte;
+    if (socketFd < 0 || recv(socketFd, &byte, 1, MSG_PEEK | MSG_DONTWAIT) != 1)
+    {
+        return -1;
+    }
+    return byte;
+}
+
+void SocketClient::stop()
+{
+    if (socketFd >= 0)
+    {
+        close(socketFd);
+        socketFd = -1;
+    }
+}
+
+uint8_t SocketClient::connected()
+{
+    if (socketFd < 0)
+    {
+        return 0;
+    }
+    uint8_t byte;
+    ssize_t result = recv(socketFd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (result == 0)
+    {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+#endif // ESP32
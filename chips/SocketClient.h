@@ -0,0 +1,63 @@
+#ifndef SOCKET_CLIENT_H
+#define SOCKET_CLIENT_H
+
+/**
+ * @file SocketClient.h
+ * @brief Declares the SocketClient class.
+ *
+ * An Arduino `Client` over a POSIX TCP socket for host builds of the Modest IoT Nano-framework,
+ * so stream-based transports (e.g. MqttTransport) can reach a local broker or server from a
+ * workstation. On the ESP32 use WiFiClient instead; this class is not built there.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#ifndef ESP32
+
+#include <Client.h>
+
+class SocketClient : public Client
+{
+private:
+    int socketFd; ///< Connected socket, or -1.
+
+public:
+    SocketClient();
+    ~SocketClient();
+
+    SocketClient(const SocketClient &) = delete;
+    SocketClient &operator=(const SocketClient &) = delete;
+
+    /**
+     * @brief Opens a TCP connection (Nagle disabled, so small packets leave at once).
+     * @return 1 if connected, 0 otherwise.
+     */
+    int connect(const char *host, uint16_t port) override;
+
+    size_t write(uint8_t byte) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    int available() override; ///< Bytes readable without blocking.
+    int read() override;      ///< Next byte, or -1 if none is waiting.
+    int read(uint8_t *buffer, size_t size) override;
+    int peek() override;
+    void stop() override;
+    uint8_t connected() override; ///< 1 until the peer closes or an error occurs.
+};
+
+#endif // ESP32
+
+#endif // SOCKET_CLIENT_H
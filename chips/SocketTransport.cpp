@@ -0,0 +1,207 @@
+/**
+ * @file SocketTransport.cpp
+ * @brief Implements the SocketTransport class.
+ *
+ * Minimal HTTP/1.1 client over POSIX sockets for host builds.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#ifndef ESP32
+
+#include "SocketTransport.h"
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+SocketTransport::SocketTransport(unsigned long timeoutMs)
+    : cachedAddressLength(0), timeoutMs(timeoutMs), wireBytes(0)
+{
+    cachedHost[0] = '\0';
+    cachedPort[0] = '\0';
+}
+
+bool SocketTransport::connect(const char *ssid, const char *password)
+{
+    (void)ssid;
+    (void)password;
+    return true;
+}
+
+void SocketTransport::disconnect()
+{
+}
+
+bool SocketTransport::isConnected()
+{
+    return true;
+}
+
+bool SocketTransport::resolve(const char *host, const char *port)
+{
+    if (cachedAddressLength > 0 && strcmp(host, cachedHost) == 0 && strcmp(port, cachedPort) == 0)
+    {
+        return true;
+    }
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    if (getaddrinfo(host, port, &hints, &result) != 0 || result == nullptr)
+    {
+        return false;
+    }
+    memcpy(&cachedAddress, result->ai_addr, result->ai_addrlen);
+    cachedAddressLength = result->ai_addrlen;
+    freeaddrinfo(result);
+    snprintf(cachedHost, sizeof(cachedHost), "%s", host);
+    snprintf(cachedPort, sizeof(cachedPort), "%s", port);
+    return true;
+}
+
+/**
+ * @brief Sends a whole buffer, retrying short writes.
+ */
+static bool sendAll(int socketFd, const void *data, size_t length)
+{
+    const char *cursor = static_cast<const char *>(data);
+    while (length > 0)
+    {
+        ssize_t sent = send(socketFd, cursor, length, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        cursor += sent;
+        length -= sent;
+    }
+    return true;
+}
+
+int SocketTransport::post(const TransportRequest &request, char *response, size_t responseSize)
+{
+    if (responseSize > 0)
+    {
+        response[0] = '\0';
+    }
+
+    // http://host[:port]/path
+    const char *prefix = "http://";
+    if (strncmp(request.url, prefix, strlen(prefix)) != 0)
+    {
+        return ERROR_URL;
+    }
+    const char *authority = request.url + strlen(prefix);
+    const char *path = strchr(authority, '/');
+    if (path == nullptr)
+    {
+        path = "/";
+    }
+    size_t authorityLength = (path[0] == '/' && path != authority + strlen(authority)) ? path - authority : strlen(authority);
+    char host[SOCKET_TRANSPORT_HOST_SIZE];
+    char port[8] = "80";
+    const char *colon = static_cast<const char *>(memchr(authority, ':', authorityLength));
+    size_t hostLength = colon != nullptr ? colon - authority : authorityLength;
+    if (hostLength == 0 || hostLength >= sizeof(host))
+    {
+        return ERROR_URL;
+    }
+    memcpy(host, authority, hostLength);
+    host[hostLength] = '\0';
+    if (colon != nullptr)
+    {
+        snprintf(port, sizeof(port), "%.*s", static_cast<int>(authority + authorityLength - colon - 1), colon + 1);
+    }
+    if (!resolve(host, port))
+    {
+        return ERROR_CONNECT;
+    }
+
+    int socketFd = socket(cachedAddress.ss_family, SOCK_STREAM, 0);
+    if (socketFd < 0)
+    {
+        return ERROR_CONNECT;
+    }
+    timeval timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+    setsockopt(socketFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(socketFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (::connect(socketFd, reinterpret_cast<sockaddr *>(&cachedAddress), cachedAddressLength) != 0)
+    {
+        close(socketFd);
+        return ERROR_CONNECT;
+    }
+
+    char head[SOCKET_TRANSPORT_REQUEST_SIZE];
+    int headLength = snprintf(head, sizeof(head),
+                              "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: %s\r\n"
+                              "Content-Length: %lu\r\nConnection: close\r\n",
+                              path, host, request.contentType, static_cast<unsigned long>(request.length));
+    for (uint8_t i = 0; i < request.headerCount && headLength > 0; i++)
+    {
+        headLength += snprintf(head + headLength, sizeof(head) - headLength, "%s: %s\r\n",
+                               request.headerNames[i], request.headerValues[i]);
+    }
+    if (headLength <= 0 || static_cast<size_t>(headLength) + 2 >= sizeof(head))
+    {
+        close(socketFd);
+        return ERROR_SEND;
+    }
+    memcpy(head + headLength, "\r\n", 2);
+    headLength += 2;
+    if (!sendAll(socketFd, head, headLength) || !sendAll(socketFd, request.body, request.length))
+    {
+        close(socketFd);
+        return ERROR_SEND;
+    }
+    wireBytes += headLength + request.length;
+
+    // Read until the server closes (or the buffer is full); only the start matters
+    char reply[SOCKET_TRANSPORT_RESPONSE_SIZE];
+    size_t received = 0;
+    while (received < sizeof(reply) - 1)
+    {
+        ssize_t count = recv(socketFd, reply + received, sizeof(reply) - 1 - received, 0);
+        if (count <= 0)
+        {
+            break;
+        }
+        received += count;
+    }
+    close(socketFd);
+    wireBytes += received;
+    reply[received] = '\0';
+
+    int status = 0;
+    if (sscanf(reply, "HTTP/%*d.%*d %d", &status) != 1 || status <= 0)
+    {
+        return ERROR_RESPONSE;
+    }
+    const char *body = strstr(reply, "\r\n\r\n");
+    if (body != nullptr && responseSize > 0)
+    {
+        snprintf(response, responseSize, "%s", body + 4);
+    }
+    return status;
+}
+
+#endif // ESP32
@@ -0,0 +1,82 @@
+#ifndef SOCKET_TRANSPORT_H
+#define SOCKET_TRANSPORT_H
+
+/**
+ * @file SocketTransport.h
+ * @brief Declares the SocketTransport class.
+ *
+ * A host-side Transport for the Modest IoT Nano-framework: one HTTP/1.1 POST per upload over a
+ * POSIX socket, so device code built for a workstation (simulations, replays, fleets) can talk
+ * to a real or mock server. On the ESP32 use HttpTransport instead; this class is not built there.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#ifndef ESP32
+
+#include "Transport.h"
+#include <sys/socket.h>
+
+#define SOCKET_TRANSPORT_HOST_SIZE 64      ///< Longest host name in an endpoint URL.
+#define SOCKET_TRANSPORT_TIMEOUT_MS 5000   ///< Connect, send and receive timeout.
+#define SOCKET_TRANSPORT_REQUEST_SIZE 512  ///< Request line and headers.
+#define SOCKET_TRANSPORT_RESPONSE_SIZE 512 ///< Response bytes read back (status line, headers, body start).
+
+class SocketTransport : public Transport
+{
+public:
+    static const int ERROR_URL = -1;     ///< The endpoint is not an http:// URL.
+    static const int ERROR_CONNECT = -2; ///< The server could not be reached.
+    static const int ERROR_SEND = -3;    ///< The request could not be sent.
+    static const int ERROR_RESPONSE = -4; ///< No valid status line was received.
+
+private:
+    char cachedHost[SOCKET_TRANSPORT_HOST_SIZE]; ///< Host of the last resolved endpoint.
+    char cachedPort[8];                          ///< Port of the last resolved endpoint.
+    sockaddr_storage cachedAddress;              ///< Resolved address of that endpoint.
+    socklen_t cachedAddressLength;
+    unsigned long timeoutMs;
+    uint32_t wireBytes; ///< Request and response bytes exchanged so far.
+
+    bool resolve(const char *host, const char *port);
+
+public:
+    /**
+     * @brief Constructs a socket transport.
+     * @param timeoutMs Connect, send and receive timeout in milliseconds.
+     */
+    explicit SocketTransport(unsigned long timeoutMs = SOCKET_TRANSPORT_TIMEOUT_MS);
+
+    bool connect(const char *ssid, const char *password) override; ///< No link to bring up; always true.
+    void disconnect() override;
+    bool isConnected() override;
+
+    /**
+     * @brief POSTs the request with `Connection: close` and reads the status and body start.
+     * @param request The request to send (the URL must be http://host[:port]/path).
+     * @param response Destination for the start of the response body.
+     * @param responseSize Size of the response buffer.
+     * @return HTTP status code, or one of the negative ERROR_ codes.
+     */
+    int post(const TransportRequest &request, char *response, size_t responseSize) override;
+
+    uint32_t bytesOnWire() const { return wireBytes; } ///< Bytes exchanged with servers (headers included).
+};
+
+#endif // ESP32
+
+#endif // SOCKET_TRANSPORT_H
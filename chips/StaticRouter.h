@@ -0,0 +1,178 @@
+#ifndef STATIC_ROUTER_H
+#define STATIC_ROUTER_H
+
+/**
+ * @file StaticRouter.h
+ * @brief Declares the Route and StaticRouter templates.
+ *
+ * Compile-time routing of events and commands in the Modest IoT Nano-framework. A device declares
+ * its (id, handler) pairs as `Route` types and the `StaticRouter` builds a dense dispatch table
+ * from them at compile time, rejecting duplicate ids with a static assertion. Small route sets
+ * are dispatched through an inlined comparison chain instead of the table, so a static topology
+ * costs no indirect calls at all.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <type_traits>
+
+#ifndef STATIC_ROUTER_INLINE_LIMIT
+#define STATIC_ROUTER_INLINE_LIMIT 4 ///< Route sets up to this size are dispatched inline.
+#endif
+
+/**
+ * @brief Extracts the owner and message types from a member handler pointer.
+ */
+template <typename Handler>
+struct RouteHandlerTraits;
+
+template <typename Owner, typename Message>
+struct RouteHandlerTraits<void (Owner::*)(const Message&)> {
+    using OwnerType = Owner;
+    using MessageType = Message;
+};
+
+/**
+ * @brief Binds a message id to a member handler.
+ *
+ * `Handler` must be a pointer to a member function taking the message (Event or Command) by
+ * const reference, e.g. `Route<GpsSensor::GPS_DATA_EVENT_ID, &MyDevice::onGpsData>`.
+ */
+template <int Id, auto Handler>
+struct Route {
+    static constexpr int id = Id; ///< Message id routed to the handler.
+    using Owner = typename RouteHandlerTraits<decltype(Handler)>::OwnerType;
+    using Message = typename RouteHandlerTraits<decltype(Handler)>::MessageType;
+
+    static void invoke(Owner& owner, const Message& message) {
+        (owner.*Handler)(message);
+    }
+};
+
+/**
+ * @brief Dispatches messages to the handlers declared by a set of routes.
+ *
+ * All routes must share the same owner and message type, and ids must be unique. The dense
+ * table spans the lowest to the highest declared id, so keep related ids close together.
+ */
+template <typename FirstRoute, typename... OtherRoutes>
+class StaticRouter {
+public:
+    using Owner = typename FirstRoute::Owner;
+    using Message = typename FirstRoute::Message;
+
+private:
+    using Thunk = void (*)(Owner&, const Message&);
+
+    static constexpr int routeCount = 1 + sizeof...(OtherRoutes);
+    static constexpr int ids[routeCount] = {FirstRoute::id, OtherRoutes::id...};
+
+    static_assert((std::is_same<typename OtherRoutes::Owner, Owner>::value && ...),
+                  "StaticRouter: all routes must share the same owner");
+    static_assert((std::is_same<typename OtherRoutes::Message, Message>::value && ...),
+                  "StaticRouter: all routes must share the same message type");
+
+    static constexpr bool hasDuplicateIds() {
+        for (int i = 0; i < routeCount; i++) {
+            for (int j = i + 1; j < routeCount; j++) {
+                if (ids[i] == ids[j]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    static_assert(!hasDuplicateIds(), "StaticRouter: duplicate route id");
+
+    static constexpr int findMinId() {
+        int result = ids[0];
+        for (int i = 1; i < routeCount; i++) {
+            result = ids[i] < result ? ids[i] : result;
+        }
+        return result;
+    }
+
+    static constexpr int findMaxId() {
+        int result = ids[0];
+        for (int i = 1; i < routeCount; i++) {
+            result = ids[i] > result ? ids[i] : result;
+        }
+        return result;
+    }
+
+    static constexpr int minId = findMinId();
+    static constexpr int maxId = findMaxId();
+
+    struct Table {
+        Thunk entries[maxId - minId + 1];
+    };
+
+    static constexpr Table buildTable() {
+        Table table{};
+        table.entries[FirstRoute::id - minId] = &FirstRoute::invoke;
+        ((table.entries[OtherRoutes::id - minId] = &OtherRoutes::invoke), ...);
+        return table;
+    }
+
+    static constexpr Table table = buildTable();
+
+public:
+    /**
+     * @brief Looks the handler up in the dense table and calls it.
+     * @return True if a route matched the message id, false otherwise.
+     */
+    static bool lookup(Owner& owner, const Message& message) {
+        if (message.id < minId || message.id > maxId) {
+            return false;
+        }
+        Thunk thunk = table.entries[message.id - minId];
+        if (thunk == nullptr) {
+            return false;
+        }
+        thunk(owner, message);
+        return true;
+    }
+
+    /**
+     * @brief Calls the matching handler through an inlined comparison chain.
+     * @return True if a route matched the message id, false otherwise.
+     */
+    static bool inlined(Owner& owner, const Message& message) {
+        if (message.id == FirstRoute::id) {
+            FirstRoute::invoke(owner, message);
+            return true;
+        }
+        return ((message.id == OtherRoutes::id ? (OtherRoutes::invoke(owner, message), true) : false) || ...);
+    }
+
+    /**
+     * @brief Routes a message to its handler using the cheapest strategy for this route set.
+     * @param owner The object whose member handler is called.
+     * @param message The event or command to route.
+     * @return True if a route matched the message id, false otherwise.
+     */
+    static bool dispatch(Owner& owner, const Message& message) {
+        if constexpr (routeCount <= STATIC_ROUTER_INLINE_LIMIT) {
+            return inlined(owner, message);
+        } else {
+            return lookup(owner, message);
+        }
+    }
+};
+
+#endif // STATIC_ROUTER_H
@@ -0,0 +1,160 @@
+/**
+ * @file SyntheticRoute.cpp
+ * @brief Implements the SyntheticRoute class.
+ *
+ * Random-walk route generation and NMEA GGA/RMC formatting.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "SyntheticRoute.h"
+#include <math.h>
+#include <stdio.h>
+
+static const double METRES_PER_DEGREE = 111320.0;
+static const double KNOTS_PER_MPS = 1.943844;
+static const double DEGREES_TO_RADIANS = 0.017453292519943295;
+
+SyntheticRoute::SyntheticRoute(Clock &clock, double originLatitude, double originLongitude,
+                               double speedMps, uint32_t seed, unsigned long fixIntervalMs)
+    : clock(&clock), latitude(originLatitude), longitude(originLongitude), heading(0),
+      speedMps(speedMps), fixIntervalMs(fixIntervalMs), nextFixAt(clock.nowMs()),
+      randomState(seed != 0 ? seed : 1), length(0), position(0)
+{
+    heading = nextRandom() % 360;
+}
+
+uint32_t SyntheticRoute::nextRandom()
+{
+    uint32_t x = randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    randomState = x;
+    return x;
+}
+
+void SyntheticRoute::move(double seconds)
+{
+    // Drift the heading by up to +/-15 degrees per fix, then advance along it
+    heading += static_cast<int>(nextRandom() % 31) - 15;
+    heading = fmod(heading + 360.0, 360.0);
+    double distance = speedMps * seconds;
+    double radians = heading * DEGREES_TO_RADIANS;
+    latitude += distance * cos(radians) / METRES_PER_DEGREE;
+    longitude += distance * sin(radians) / (METRES_PER_DEGREE * cos(latitude * DEGREES_TO_RADIANS));
+}
+
+/**
+ * @brief Appends "$<body>*CS\r\n" to a buffer.
+ */
+static size_t appendSentence(char *buffer, size_t size, const char *body)
+{
+    uint8_t checksum = 0;
+    for (const char *c = body; *c != '\0'; c++)
+    {
+        checksum ^= static_cast<uint8_t>(*c);
+    }
+    int written = snprintf(buffer, size, "$%s*%02X\r\n", body, checksum);
+    return written > 0 && static_cast<size_t>(written) < size ? written : 0;
+}
+
+/**
+ * @brief Formats a coordinate as NMEA (d)ddmm.mmmm plus hemisphere.
+ */
+static void formatCoordinate(char *buffer, size_t size, double degrees, bool isLatitude)
+{
+    char hemisphere = isLatitude ? (degrees < 0 ? 'S' : 'N') : (degrees < 0 ? 'W' : 'E');
+
+    // Work in ten-thousandths of a minute, so rounding carries into the minutes and degrees and
+    // every field has a known width (at most "179" + "59.9999" + ",W")
+    unsigned long total = static_cast<unsigned long>(lround(fabs(degrees) * 600000.0));
+    unsigned long whole = (total / 600000) % 1000;
+    unsigned long minutes = (total % 600000) / 10000;
+    unsigned long fraction = total % 10000;
+    snprintf(buffer, size, isLatitude ? "%02lu%02lu.%04lu,%c" : "%03lu%02lu.%04lu,%c", whole, minutes, fraction,
+             hemisphere);
+}
+
+void SyntheticRoute::emitFix()
+{
+    time_t now = clock->wallTime();
+    struct tm timeinfo;
+    gmtime_r(&now, &timeinfo);
+    char timeField[12];
+    char dateField[8];
+    char latitudeField[16];
+    char longitudeField[16];
+    // gmtime_r keeps every field within two digits; the modulo lets the compiler see that too
+    snprintf(timeField, sizeof(timeField), "%02u%02u%02u.00", static_cast<unsigned>(timeinfo.tm_hour) % 100,
+             static_cast<unsigned>(timeinfo.tm_min) % 100, static_cast<unsigned>(timeinfo.tm_sec) % 100);
+    snprintf(dateField, sizeof(dateField), "%02u%02u%02u", static_cast<unsigned>(timeinfo.tm_mday) % 100,
+             static_cast<unsigned>(timeinfo.tm_mon + 1) % 100, static_cast<unsigned>(timeinfo.tm_year) % 100);
+    formatCoordinate(latitudeField, sizeof(latitudeField), latitude, true);
+    formatCoordinate(longitudeField, sizeof(longitudeField), longitude, false);
+
+    char body[96];
+    length = 0;
+    position = 0;
+    snprintf(body, sizeof(body), "GPGGA,%s,%s,%s,1,08,1.0,0.0,M,0.0,M,,", timeField, latitudeField,
+             longitudeField);
+    length += appendSentence(buffer + length, sizeof(buffer) - length, body);
+    snprintf(body, sizeof(body), "GPRMC,%s,A,%s,%s,%.1f,%.1f,%s,,,A", timeField, latitudeField,
+             longitudeField, speedMps * KNOTS_PER_MPS, heading, dateField);
+    length += appendSentence(buffer + length, sizeof(buffer) - length, body);
+}
+
+int SyntheticRoute::available()
+{
+    if (position >= length)
+    {
+        unsigned long now = clock->nowMs();
+        if (static_cast<long>(now - nextFixAt) >= 0)
+        {
+            // Skip fixes nobody read; the position still advances by the elapsed time
+            unsigned long missed = (now - nextFixAt) / fixIntervalMs;
+            move((missed + 1) * fixIntervalMs / 1000.0);
+            nextFixAt += (missed + 1) * fixIntervalMs;
+            emitFix();
+        }
+    }
+    return static_cast<int>(length - position);
+}
+
+int SyntheticRoute::read()
+{
+    if (available() <= 0)
+    {
+        return -1;
+    }
+    return static_cast<uint8_t>(buffer[position++]);
+}
+
+int SyntheticRoute::peek()
+{
+    if (available() <= 0)
+    {
+        return -1;
+    }
+    return static_cast<uint8_t>(buffer[position]);
+}
+
+size_t SyntheticRoute::write(uint8_t byte)
+{
+    (void)byte;
+    return 1;
+}
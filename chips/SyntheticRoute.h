@@ -0,0 +1,82 @@
+#ifndef SYNTHETIC_ROUTE_H
+#define SYNTHETIC_ROUTE_H
+
+/**
+ * @file SyntheticRoute.h
+ * @brief Declares the SyntheticRoute class.
+ *
+ * A simulated GPS receiver for the Modest IoT Nano-framework. It is a Stream that emits a GGA
+ * and an RMC sentence per fix, following a seeded random-walk route from an origin at a given
+ * speed, timestamped from a Clock. Plug it into GpsSensor::setInput() to drive a device without
+ * a receiver; different seeds give different, reproducible routes.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Clock.h"
+#include <Arduino.h>
+
+#define SYNTHETIC_ROUTE_BUFFER_SIZE 192 ///< Room for one GGA and one RMC sentence.
+
+class SyntheticRoute : public Stream
+{
+private:
+    Clock *clock;
+    double latitude;       ///< Current position in degrees.
+    double longitude;      ///< Current position in degrees.
+    double heading;        ///< Current heading in degrees from north.
+    double speedMps;       ///< Ground speed in metres per second.
+    unsigned long fixIntervalMs;
+    unsigned long nextFixAt;
+    uint32_t randomState;  ///< xorshift32 state for heading changes.
+
+    char buffer[SYNTHETIC_ROUTE_BUFFER_SIZE]; ///< Sentences not yet read.
+    size_t length;
+    size_t position;
+
+    uint32_t nextRandom();
+    void move(double seconds);
+    void emitFix();
+
+public:
+    /**
+     * @brief Constructs a route.
+     * @param clock Time source for fix timing and NMEA timestamps.
+     * @param originLatitude Starting latitude in degrees.
+     * @param originLongitude Starting longitude in degrees.
+     * @param speedMps Ground speed in metres per second.
+     * @param seed Seed for the random walk (0 is treated as 1).
+     * @param fixIntervalMs Time between fixes in milliseconds.
+     */
+    SyntheticRoute(Clock &clock, double originLatitude, double originLongitude,
+                   double speedMps = 10.0, uint32_t seed = 1, unsigned long fixIntervalMs = 1000);
+
+    /**
+     * @brief Makes the latest fix available once it is due.
+     * Fixes that fell due while nobody was reading are skipped, as a UART would overrun.
+     * @return Number of bytes ready to read.
+     */
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t byte) override; ///< Input is ignored (no receiver configuration).
+
+    double getLatitude() const { return latitude; }   ///< Current latitude in degrees.
+    double getLongitude() const { return longitude; } ///< Current longitude in degrees.
+};
+
+#endif // SYNTHETIC_ROUTE_H
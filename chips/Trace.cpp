@@ -0,0 +1,148 @@
+/**
+ * @file Trace.cpp
+ * @brief Implements the Tracer and TraceSpan classes.
+ *
+ * Keeps completed spans in a fixed ring buffer and renders them as Chrome trace_event JSON.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Trace.h"
+#include <Arduino.h>
+#include <stdio.h>
+#include <atomic>
+
+#ifndef ESP32
+#include <chrono>
+#include <functional>
+#include <thread>
+#endif
+
+static TraceRecord traceBuffer[TRACE_BUFFER_SIZE];
+static std::atomic<uint32_t> traceSequence[TRACE_BUFFER_SIZE]; ///< Ticket + 1 of the span in each slot, 0 while written.
+static std::atomic<uint32_t> traceNext(0);  ///< Ticket of the next span.
+static std::atomic<uint32_t> traceFirst(0); ///< First ticket kept by clear().
+
+uint32_t Tracer::cycles()
+{
+#ifdef ESP32
+    return ESP.getCycleCount();
+#else
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+}
+
+/**
+ * @brief Gets the number of cycle-counter ticks per microsecond.
+ */
+static uint32_t cyclesPerMicrosecond()
+{
+#ifdef ESP32
+    return ESP.getCpuFreqMHz();
+#else
+    return 1000;
+#endif
+}
+
+/**
+ * @brief Identifies the core (or host thread) running the caller.
+ */
+static uint8_t currentCore()
+{
+#ifdef ESP32
+    return static_cast<uint8_t>(xPortGetCoreID());
+#else
+    return static_cast<uint8_t>(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0x7F);
+#endif
+}
+
+void Tracer::record(const char *name, uint32_t startUs, uint32_t startCycles)
+{
+    uint32_t durationCycles = cycles() - startCycles;
+    uint32_t durationUs = micros() - startUs;
+    uint32_t perMicrosecond = cyclesPerMicrosecond();
+    uint16_t durationNs = 0;
+
+    // The cycle count is only trusted well inside one wrap of the counter
+    if (durationUs < UINT32_MAX / perMicrosecond / 2)
+    {
+        durationUs = durationCycles / perMicrosecond;
+        durationNs = static_cast<uint16_t>((durationCycles % perMicrosecond) * 1000 / perMicrosecond);
+    }
+
+    // Claim a slot, mark it as being written, fill it, then publish it with its ticket
+    uint32_t ticket = traceNext.fetch_add(1, std::memory_order_relaxed);
+    uint32_t slot = ticket % TRACE_BUFFER_SIZE;
+    traceSequence[slot].store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    TraceRecord &record = traceBuffer[slot];
+    record.name = name;
+    record.startUs = startUs;
+    record.durationUs = durationUs;
+    record.durationNs = durationNs;
+    record.core = currentCore();
+    traceSequence[slot].store(ticket + 1, std::memory_order_release);
+}
+
+void Tracer::dumpChromeTrace(Print &out)
+{
+    uint32_t written = traceNext.load(std::memory_order_acquire);
+    uint32_t kept = written - traceFirst.load(std::memory_order_acquire);
+    uint32_t count = kept < TRACE_BUFFER_SIZE ? kept : TRACE_BUFFER_SIZE;
+    uint32_t first = written - count;
+
+    out.print("{\"traceEvents\":[");
+    char line[128];
+    uint32_t printed = 0;
+    for (uint32_t ticket = first; ticket != written; ticket++)
+    {
+        // Copy the slot, then check it held this ticket, finished, before and after the copy:
+        // spans still being written (or already overwritten) are skipped
+        uint32_t slot = ticket % TRACE_BUFFER_SIZE;
+        if (traceSequence[slot].load(std::memory_order_acquire) != ticket + 1)
+        {
+            continue;
+        }
+        TraceRecord record = traceBuffer[slot];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (traceSequence[slot].load(std::memory_order_relaxed) != ticket + 1 || record.name == nullptr)
+        {
+            continue;
+        }
+        snprintf(line, sizeof(line),
+                 "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lu,\"dur\":%lu.%03lu}",
+                 printed++ > 0 ? ",\n" : "\n", record.name, record.core,
+                 static_cast<unsigned long>(record.startUs),
+                 static_cast<unsigned long>(record.durationUs),
+                 static_cast<unsigned long>(record.durationNs));
+        out.print(line);
+    }
+    out.println("\n],\"displayTimeUnit\":\"ms\"}");
+}
+
+void Tracer::clear()
+{
+    // Tickets keep counting, so a slot published before the clear never passes for a new span
+    traceFirst.store(traceNext.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+TraceSpan::TraceSpan(const char *spanName)
+    : name(spanName), startUs(micros()), startCycles(Tracer::cycles())
+{
+}
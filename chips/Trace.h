@@ -0,0 +1,111 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * @file Trace.h
+ * @brief Declares the Tracer, TraceSpan and the TRACE_SCOPE macro.
+ *
+ * Phase tracing for the Modest IoT Nano-framework. A `TRACE_SCOPE("name")` at the top of a block
+ * records a span covering the block into a fixed RAM ring buffer, timed with the CPU cycle
+ * counter. The buffer can be dumped as Chrome `trace_event` JSON (load it in chrome://tracing or
+ * Perfetto) to see which phase of a loop pass ate the time. Spans are placed on the timeline
+ * with micros(), because the 32-bit cycle counter wraps every ~18 s at 240 MHz (~4.3 s on the
+ * host, where it counts nanoseconds). For the same reason spans longer than half a wrap are
+ * timed with micros() too, at microsecond resolution.
+ *
+ * Tracing is compiled out unless `MODESTIOT_TRACE` is defined in ModestIoTConfig.h.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ModestIoTConfig.h"
+#include <stdint.h>
+
+class Print;
+
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE 256 ///< Spans kept in the ring buffer (oldest are overwritten).
+#endif
+
+/**
+ * @brief One completed span.
+ */
+struct TraceRecord {
+    const char* name;        ///< Static span name.
+    uint32_t startUs;        ///< Start time from micros().
+    uint32_t durationUs;     ///< Whole microseconds of the duration.
+    uint16_t durationNs;     ///< Nanoseconds past durationUs (0 for spans timed with micros()).
+    uint8_t core;            ///< Core (or host thread slot) that ran the span.
+};
+
+class Tracer {
+public:
+    /**
+     * @brief Reads the cycle counter (nanoseconds on the host).
+     * @return Current cycle count.
+     */
+    static uint32_t cycles();
+
+    /**
+     * @brief Appends a completed span to the ring buffer. Safe to call from either core.
+     * @param name Static span name.
+     * @param startUs Start time from micros().
+     * @param startCycles Cycle count at the start of the span.
+     */
+    static void record(const char* name, uint32_t startUs, uint32_t startCycles);
+
+    /**
+     * @brief Writes the buffered spans as Chrome trace_event JSON.
+     * Safe while the traced code runs: each slot is published with a sequence number once its
+     * span is complete, and slots still being written or overwritten during the dump are skipped.
+     * @param out Destination (e.g. Serial).
+     */
+    static void dumpChromeTrace(Print& out);
+
+    /**
+     * @brief Discards all buffered spans.
+     */
+    static void clear();
+};
+
+/**
+ * @brief Records a span from construction to destruction.
+ */
+class TraceSpan {
+private:
+    const char* name;
+    uint32_t startUs;
+    uint32_t startCycles;
+
+public:
+    explicit TraceSpan(const char* spanName);
+    ~TraceSpan() { Tracer::record(name, startUs, startCycles); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef MODESTIOT_TRACE
+#define TRACE_SCOPE(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // TRACE_H
@@ -24,74 +24,172 @@
  */
 
 #include "TrackingDevice.h"
+#include "StaticRouter.h"
+#include "HeapGuard.h"
+#include "Trace.h"
+#include "Log.h"
 #include <Arduino.h>
 
 TrackingDevice::TrackingDevice(int gpsRxPin, int gpsTxPin, int rfidPin, int ledPin,
-                               const String &wifiSSID, const String &wifiPassword,
-                               const String &trackingUrl, const String &rfidUrl,
-                               const String &deviceId)
-    : lastUpdate(0), updateInterval(1000)
+                               const char *wifiSSID, const char *wifiPassword,
+                               const char *trackingUrl, const char *rfidUrl,
+                               const char *deviceId, Clock &clock, Transport *uplink)
+    : clock(clock),
+      gpsSensor(gpsRxPin, gpsTxPin, 10000, &eventBus, clock),
+      rfidSensor(rfidPin, 5000, &eventBus, clock),
+      commHandler(wifiSSID, wifiPassword, trackingUrl, rfidUrl, deviceId, clock, uplink),
+      statusLed(ledPin, false),
+      deadlines(&eventBus, clock),
+      governor(gpsSensor.getUpdateInterval(), clock),
+      lastUpdate(0), updateInterval(1000), lastTaskReport(0), ledPulsing(false),
+      ledPulseUntil(0), flushing(false)
 {
+    // Sensors publish on the bus; events this device uploads are queued for the uplink
+    eventBus.subscribe(this,
+                       Bus::topic(GpsSensor::GPS_DATA_EVENT_ID) |
+                           Bus::topic(RfidSensor::RFID_DETECTED_EVENT_ID),
+                       &uplinkQueue);
 
-    // Initialize components with this device as event/command handler
-    gpsSensor = new GpsSensor(gpsRxPin, gpsTxPin, 10000, this);
-    rfidSensor = new RfidSensor(rfidPin, 5000, this);
-    commHandler = new CommunicationHandler(wifiSSID, wifiPassword, trackingUrl, rfidUrl, deviceId);
-    statusLed = new Led(ledPin, false, this);
+    metrics.add("bus.published", eventBus.publishedCounters(), EVENT_BUS_TOPICS);
+    metrics.add("device.update_us", updateDuration);
+    metrics.add("device.ingest_us", ingestDuration);
+    metrics.add("device.uplink_us", uplinkDuration);
+    metrics.add("uplink.depth", uplinkDepth);
+    metrics.add("uplink.drops", uplinkDrops);
+    metrics.add("heap.allocations", heapAllocations);
+    deadlines.addActivity("update", updateInterval, UPDATE_SLIP_SLO_MS);
+    deadlines.addActivity("ingest", INGEST_TASK_PERIOD_MS, INGEST_SLIP_SLO_MS);
+    deadlines.addActivity("network", NETWORK_TASK_PERIOD_MS, NETWORK_SLIP_SLO_MS);
+    deadlines.addPhase("sensors");
+    deadlines.addPhase("upload");
+    deadlines.addPhase("downlink");
+    deadlines.addPhase("wifi");
+    deadlines.addPhase("report");
+
+    gpsSensor.registerMetrics(metrics);
+    rfidSensor.registerMetrics(metrics);
+    commHandler.registerMetrics(metrics);
+    commHandler.setMetricsPiggyback(&metrics, METRICS_PIGGYBACK_INTERVAL_MS);
+    deadlines.registerMetrics(metrics);
+    governor.registerMetrics(metrics);
+    Logger::registerMetrics(metrics);
 }
 
 void TrackingDevice::on(Event event)
 {
-    if (event == GpsSensor::GPS_DATA_EVENT)
+    TRACE_SCOPE("device.on");
+    using EventRoutes = StaticRouter<
+        Route<GpsSensor::GPS_DATA_EVENT_ID, &TrackingDevice::onGpsData>,
+        Route<RfidSensor::RFID_DETECTED_EVENT_ID, &TrackingDevice::onRfidDetected>>;
+
+    EventRoutes::dispatch(*this, event);
+}
+
+void TrackingDevice::handle(Command command)
+{
+    // Forward commands to appropriate handlers
+    using CommandRoutes = StaticRouter<
+        Route<CommunicationHandler::CONNECT_WIFI_COMMAND_ID, &TrackingDevice::forwardToCommunication>,
+        Route<Led::TOGGLE_LED_COMMAND_ID, &TrackingDevice::forwardToStatusLed>,
+        Route<Led::TURN_ON_COMMAND_ID, &TrackingDevice::forwardToStatusLed>,
+        Route<Led::TURN_OFF_COMMAND_ID, &TrackingDevice::forwardToStatusLed>,
+        Route<SET_GPS_INTERVAL_COMMAND_ID, &TrackingDevice::setGpsInterval>,
+        Route<FLUSH_UPLINK_COMMAND_ID, &TrackingDevice::flushUplink>,
+        Route<ALLOW_RFID_CODE_COMMAND_ID, &TrackingDevice::forwardToIngest>,
+        Route<REVOKE_RFID_CODE_COMMAND_ID, &TrackingDevice::forwardToIngest>>;
+
+    CommandRoutes::dispatch(*this, command);
+}
+
+void TrackingDevice::onGpsData(const Event &event)
+{
+    LOG_DEBUG("GPS data event received");
+
+    // GPS fix travels with the event; it waits behind any access scans
+    GpsData gpsData;
+    if (event.getPayload(gpsData) && gpsData.isValid)
     {
-        Serial.println("GPS data event received");
+        commHandler.enqueue(event, OutboundClass::ROUTINE);
+    }
+}
 
-        // Get GPS data and send it
-        GpsData gpsData = gpsSensor->getLastData();
-        if (gpsData.isValid && commHandler->isWiFiConnected())
-        {
-            commHandler->sendGpsData(gpsData);
+void TrackingDevice::onRfidDetected(const Event &event)
+{
+    LOG_INFO("RFID detection event received");
 
-            // Blink LED to indicate GPS data sent
-            statusLed->handle(Led::TOGGLE_LED_COMMAND);
-            delay(100);
-            statusLed->handle(Led::TOGGLE_LED_COMMAND);
-        }
+    // RFID detection travels with the event; gate access goes ahead of queued fixes
+    RfidData rfidData;
+    if (event.getPayload(rfidData) && rfidData.isValid)
+    {
+        commHandler.enqueue(event, OutboundClass::ACCESS);
+    }
+}
+
+void TrackingDevice::pulseStatusLed(unsigned long durationMs)
+{
+    if (deadlines.isShedding())
+    {
+        return;
     }
-    else if (event == RfidSensor::RFID_DETECTED_EVENT)
+    statusLed.handle(Led::TURN_ON_COMMAND);
+    ledPulsing = true;
+    ledPulseUntil = clock.nowMs() + durationMs;
+}
+
+void TrackingDevice::forwardToCommunication(const Command &command)
+{
+    commHandler.handle(command);
+}
+
+void TrackingDevice::forwardToStatusLed(const Command &command)
+{
+    statusLed.handle(command);
+}
+
+void TrackingDevice::forwardToIngest(const Command &command)
+{
+    if (!ingestCommands.push(command))
     {
-        Serial.println("RFID detection event received");
+        LOG_WARN("Ingest command queue full");
+    }
+}
 
-        // Get RFID data and send it
-        RfidData rfidData = rfidSensor->getLastDetection();
-        if (rfidData.isValid && commHandler->isWiFiConnected())
-        {
-            commHandler->sendRfidData(rfidData);
+void TrackingDevice::flushUplink(const Command &)
+{
+    flushing = true;
+}
 
-            // Quick double blink to indicate RFID scan sent
-            for (int i = 0; i < 2; i++)
-            {
-                statusLed->handle(Led::TURN_ON_COMMAND);
-                delay(150);
-                statusLed->handle(Led::TURN_OFF_COMMAND);
-                delay(150);
-            }
-        }
+void TrackingDevice::setGpsInterval(const Command &command)
+{
+    if (command.value >= MIN_GPS_INTERVAL_MS)
+    {
+        governor.setBaseInterval(static_cast<unsigned long>(command.value));
     }
 }
 
-void TrackingDevice::handle(Command command)
+void TrackingDevice::applyGpsInterval(const Command &command)
 {
-    // Forward commands to appropriate handlers
-    if (command == CommunicationHandler::CONNECT_WIFI_COMMAND)
+    if (command.value >= MIN_GPS_INTERVAL_MS)
     {
-        commHandler->handle(command);
+        gpsSensor.setUpdateInterval(static_cast<unsigned long>(command.value));
     }
-    else if (command == Led::TOGGLE_LED_COMMAND ||
-             command == Led::TURN_ON_COMMAND ||
-             command == Led::TURN_OFF_COMMAND)
+}
+
+void TrackingDevice::allowRfidCode(const Command &command)
+{
+    if (!rfidSensor.addRfidCode(command.text))
     {
-        statusLed->handle(command);
+        LOG_WARN("RFID code %s not allowed: duplicate, invalid or allowlist full", command.text);
+        commHandler.rejectDownlinkCommand();
+    }
+}
+
+void TrackingDevice::revokeRfidCode(const Command &command)
+{
+    if (!rfidSensor.removeRfidCode(command.text))
+    {
+        LOG_WARN("RFID code %s not revoked: not in the allowlist", command.text);
+        commHandler.rejectDownlinkCommand();
     }
 }
 
@@ -99,10 +197,10 @@ void TrackingDevice::initialize()
 {
     Serial.println("Initializing Tracking Device...");
 
-    // Add RFID codes for simulation
-    rfidSensor->addRfidCode("XX01X");
-    rfidSensor->addRfidCode("YY02Y");
-    rfidSensor->addRfidCode("ZZ03Z");
+    // Allowlist the demo RFID codes (the simulation scans them too)
+    rfidSensor.addRfidCode("XX01X");
+    rfidSensor.addRfidCode("YY02Y");
+    rfidSensor.addRfidCode("ZZ03Z");
 
     // Connect to WiFi
     handle(CommunicationHandler::CONNECT_WIFI_COMMAND);
@@ -110,49 +208,208 @@ void TrackingDevice::initialize()
     // Indicate initialization complete
     for (int i = 0; i < 3; i++)
     {
-        statusLed->handle(Led::TURN_ON_COMMAND);
-        delay(200);
-        statusLed->handle(Led::TURN_OFF_COMMAND);
-        delay(200);
+        statusLed.handle(Led::TURN_ON_COMMAND);
+        clock.sleepMs(200);
+        statusLed.handle(Led::TURN_OFF_COMMAND);
+        clock.sleepMs(200);
     }
 
     Serial.println("Tracking Device initialized successfully!");
+
+    // Overruns recorded before the last watchdog reset, if any
+    deadlines.printPostMortem(Serial);
+
+    // Steady state from here on must not allocate
+    HeapGuard::arm();
 }
 
 void TrackingDevice::update()
 {
-    if (millis() - lastUpdate >= updateInterval)
+    if (clock.nowMs() - lastUpdate >= updateInterval)
     {
-        // Update sensors
-        gpsSensor->update();
-        rfidSensor->update();
+        deadlines.beginPass(UPDATE_PASS);
+        runOnce();
+        deadlines.endPass(UPDATE_PASS);
+        lastUpdate = clock.nowMs();
+    }
+}
+
+void TrackingDevice::runOnce()
+{
+    TRACE_SCOPE("device.update");
+    unsigned long startedAt = micros();
+    ingest(UPDATE_PASS);
+    serviceUplink(UPDATE_PASS);
+    updateDuration.record(micros() - startedAt);
+}
 
-        // Check communication status
-        commHandler->checkConnection();
+void TrackingDevice::ingest(PassActivity pass)
+{
+    TRACE_SCOPE("device.ingest");
+    unsigned long startedAt = micros();
+    deadlines.enterPhase(pass, SENSORS_PHASE);
 
-        lastUpdate = millis();
+    // Apply sensor commands here, so the sensors are only ever touched by this task
+    using IngestRoutes = StaticRouter<
+        Route<SET_GPS_INTERVAL_COMMAND_ID, &TrackingDevice::applyGpsInterval>,
+        Route<ALLOW_RFID_CODE_COMMAND_ID, &TrackingDevice::allowRfidCode>,
+        Route<REVOKE_RFID_CODE_COMMAND_ID, &TrackingDevice::revokeRfidCode>>;
+    Command command;
+    while (ingestCommands.pop(command))
+    {
+        IngestRoutes::dispatch(*this, command);
+    }
+
+    // Update sensors
+    gpsSensor.update();
+    rfidSensor.update();
+
+    ingestDuration.record(micros() - startedAt);
+}
+
+void TrackingDevice::serviceUplink(PassActivity pass)
+{
+    TRACE_SCOPE("device.uplink");
+    unsigned long startedAt = micros();
+    uplinkDepth.set(uplinkQueue.size());
+    uplinkDrops.set(uplinkQueue.dropped());
+    heapAllocations.set(HeapGuard::allocationsSinceArm());
+
+    // Queue what the sensors produced since the last pass, then upload by priority.
+    // While passes run late, GPS fixes wait so scans still go out on time,
+    // unless the server asked for a flush.
+    deadlines.enterPhase(pass, UPLOAD_PHASE);
+    eventBus.drain(this);
+    OutboundClass lowest =
+        deadlines.isShedding() && !flushing ? OutboundClass::ACCESS : OutboundClass::ROUTINE;
+    OutboundClass sent;
+    int uploaded = 0;
+    while (uploaded < UPLINK_RECORDS_PER_PASS && commHandler.sendNext(&sent, lowest))
+    {
+        uploaded++;
+        pulseStatusLed(sent == OutboundClass::ROUTINE ? GPS_LED_PULSE_MS : RFID_LED_PULSE_MS);
+
+        // Scans that arrived during the upload go ahead of the fixes still queued
+        eventBus.drain(this);
     }
+    if (uploaded < UPLINK_RECORDS_PER_PASS)
+    {
+        // The queue is empty or the uplink failed: either way the flush is over
+        flushing = false;
+    }
+
+    // Apply what the server sent back with those uploads
+    deadlines.enterPhase(pass, DOWNLINK_PHASE);
+    Command command;
+    while (commHandler.nextDownlinkCommand(command))
+    {
+        handle(command);
+    }
+
+    // Report less often while uploads fall behind, and more often again as they recover
+    if (governor.update(commHandler.getOutboundQueue().size(OutboundClass::ROUTINE),
+                        commHandler.roundTripMs(), commHandler.uploadErrors()))
+    {
+        commHandler.getOutboundQueue().setConflation(OutboundClass::ROUTINE, governor.isConflating());
+        forwardToIngest(Command(SET_GPS_INTERVAL_COMMAND_ID, static_cast<long>(governor.getInterval())));
+    }
+
+    if (ledPulsing && static_cast<long>(clock.nowMs() - ledPulseUntil) >= 0)
+    {
+        statusLed.handle(Led::TURN_OFF_COMMAND);
+        ledPulsing = false;
+    }
+
+    // Check communication status
+    deadlines.enterPhase(pass, WIFI_PHASE);
+    commHandler.checkConnection();
+
+    uplinkDuration.record(micros() - startedAt);
+}
+
+bool TrackingDevice::start()
+{
+    lastTaskReport = clock.nowMs();
+    bool started = ingestTask.start("ingest", ingestStep, this, INGEST_TASK_PERIOD_MS,
+                                    INGEST_TASK_CORE, 2);
+    started = networkTask.start("network", networkStep, this, NETWORK_TASK_PERIOD_MS,
+                                NETWORK_TASK_CORE, 1) && started;
+    return started;
+}
+
+void TrackingDevice::ingestStep(void *device)
+{
+    TrackingDevice *self = static_cast<TrackingDevice *>(device);
+    self->deadlines.beginPass(INGEST_PASS);
+    self->ingest(INGEST_PASS);
+    self->deadlines.endPass(INGEST_PASS);
+}
+
+void TrackingDevice::networkStep(void *device)
+{
+    TrackingDevice *self = static_cast<TrackingDevice *>(device);
+    self->deadlines.beginPass(NETWORK_PASS);
+    self->serviceUplink(NETWORK_PASS);
+
+    if (self->clock.nowMs() - self->lastTaskReport >= TASK_REPORT_INTERVAL_MS)
+    {
+        self->deadlines.enterPhase(NETWORK_PASS, REPORT_PHASE);
+        self->printTaskStats();
+        self->printMetrics();
+        self->lastTaskReport = self->clock.nowMs();
+    }
+    self->deadlines.endPass(NETWORK_PASS);
+}
+
+void TrackingDevice::printTaskStats()
+{
+    Serial.print("Stack high-water (bytes) ingest: ");
+    Serial.print(ingestTask.stackHighWaterMark());
+    Serial.print(" network: ");
+    Serial.println(networkTask.stackHighWaterMark());
+}
+
+MetricsRegistry &TrackingDevice::getMetrics()
+{
+    return metrics;
+}
+
+void TrackingDevice::printMetrics()
+{
+    metrics.print(Serial);
+}
+
+UplinkGovernor &TrackingDevice::getUplinkGovernor()
+{
+    return governor;
+}
+
+DeadlineMonitor &TrackingDevice::getDeadlineMonitor()
+{
+    return deadlines;
+}
+
+TrackingDevice::Bus &TrackingDevice::getEventBus()
+{
+    return eventBus;
 }
 
-GpsSensor *TrackingDevice::getGpsSensor() const
+GpsSensor *TrackingDevice::getGpsSensor()
 {
-    return gpsSensor;
+    return &gpsSensor;
 }
 
-RfidSensor *TrackingDevice::getRfidSensor() const
+RfidSensor *TrackingDevice::getRfidSensor()
 {
-    return rfidSensor;
+    return &rfidSensor;
 }
 
-CommunicationHandler *TrackingDevice::getCommunicationHandler() const
+CommunicationHandler *TrackingDevice::getCommunicationHandler()
 {
-    return commHandler;
+    return &commHandler;
 }
 
-TrackingDevice::~TrackingDevice()
+Clock &TrackingDevice::getClock()
 {
-    delete gpsSensor;
-    delete rfidSensor;
-    delete commHandler;
-    delete statusLed;
+    return clock;
 }
@@ -31,21 +31,163 @@
 #include "RfidSensor.h"
 #include "CommunicationHandler.h"
 #include "Led.h"
+#include "EventBus.h"
+#include "PinnedTask.h"
+#include "Metrics.h"
+#include "Clock.h"
+#include "DeadlineMonitor.h"
+#include "UplinkGovernor.h"
+
+#define TRACKING_DEVICE_BUS_SUBSCRIBERS 4 ///< Subscriber slots on the device's event bus.
+#define INGEST_TASK_STACK_SIZE 4096       ///< Stack bytes for the sensor ingest task.
+#define NETWORK_TASK_STACK_SIZE 8192      ///< Stack bytes for the network upload task.
+#define INGEST_TASK_PERIOD_MS 50          ///< Sensor polling period of the ingest task.
+#define NETWORK_TASK_PERIOD_MS 100        ///< Uplink service period of the network task.
+#define INGEST_TASK_CORE 1                ///< Core running sensor ingestion (APP CPU).
+#define NETWORK_TASK_CORE 0               ///< Core running networking (PRO CPU, with the WiFi stack).
+#define TASK_REPORT_INTERVAL_MS 60000     ///< Interval between stack and metrics reports.
+#define METRICS_PIGGYBACK_INTERVAL_MS 60000 ///< Interval between metrics snapshots sent to the server.
+#define UPLINK_RECORDS_PER_PASS 4         ///< Records uploaded per uplink pass before yielding.
+#define GPS_LED_PULSE_MS 100              ///< Status LED pulse after a GPS upload.
+#define RFID_LED_PULSE_MS 300             ///< Status LED pulse after an RFID upload.
+#define INGEST_COMMAND_QUEUE_DEPTH 8      ///< Sensor commands waiting for the ingest task (power of two).
+#define MIN_GPS_INTERVAL_MS 1000          ///< Shortest GPS interval a SET_GPS_INTERVAL command may set.
+#define UPDATE_SLIP_SLO_MS 1000           ///< Largest acceptable update() slip (one missed interval).
+#define INGEST_SLIP_SLO_MS 100            ///< Largest acceptable ingest task slip.
+#define NETWORK_SLIP_SLO_MS 1000          ///< Largest acceptable network task slip.
 
 class TrackingDevice : public Device
 {
+public:
+    using Bus = EventBus<TRACKING_DEVICE_BUS_SUBSCRIBERS>; ///< Event bus type shared by the device's sensors.
+
 private:
-    GpsSensor *gpsSensor;
-    RfidSensor *rfidSensor;
-    CommunicationHandler *commHandler;
-    Led *statusLed;
+    /// Activities watched by the deadline monitor, registered in this order.
+    enum PassActivity : uint8_t { UPDATE_PASS, INGEST_PASS, NETWORK_PASS };
+
+    /// Phases a late pass can be blamed on, registered in this order.
+    enum PassPhase : uint8_t { SENSORS_PHASE, UPLOAD_PHASE, DOWNLINK_PHASE, WIFI_PHASE, REPORT_PHASE };
+
+    Clock &clock;
+    Bus eventBus;
+    Bus::SubscriberQueue uplinkQueue;
+    BoundedQueue<Command, INGEST_COMMAND_QUEUE_DEPTH> ingestCommands; ///< Sensor commands for the ingest task.
+    GpsSensor gpsSensor;
+    RfidSensor rfidSensor;
+    CommunicationHandler commHandler;
+    Led statusLed;
+    DeadlineMonitor deadlines;
+    UplinkGovernor governor; ///< Adapts the GPS interval to the uplink; owned by the network task.
 
     unsigned long lastUpdate;
     unsigned long updateInterval;
 
+    PinnedTask<INGEST_TASK_STACK_SIZE> ingestTask;
+    PinnedTask<NETWORK_TASK_STACK_SIZE> networkTask;
+    unsigned long lastTaskReport;
+    bool ledPulsing;             ///< True while a status LED pulse is running.
+    unsigned long ledPulseUntil; ///< Time the running status LED pulse ends.
+    bool flushing;               ///< True from FLUSH_UPLINK until the uplink queue drains.
+
+    MetricsRegistry metrics;
+    Histogram updateDuration; ///< Duration of update() passes in microseconds.
+    Histogram ingestDuration; ///< Duration of ingest passes in microseconds.
+    Histogram uplinkDuration; ///< Duration of uplink passes in microseconds.
+    Gauge uplinkDepth;        ///< Events waiting in the uplink queue.
+    Gauge uplinkDrops;        ///< Events dropped because the uplink queue was full.
+    Gauge heapAllocations;    ///< Heap allocations since initialize() (MODESTIOT_HEAP_GUARD builds).
+
+    /**
+     * @brief Polls the sensors; their events are queued for the uplink.
+     * @param pass Activity whose phases the pass reports to the deadline monitor.
+     */
+    void ingest(PassActivity pass);
+
+    /**
+     * @brief Uploads queued sensor events and maintains the WiFi connection.
+     * While the deadline monitor sheds load, GPS fixes stay queued and the LED is not pulsed.
+     * The uplink governor then adapts the GPS interval to how well the uploads kept up.
+     * @param pass Activity whose phases the pass reports to the deadline monitor.
+     */
+    void serviceUplink(PassActivity pass);
+
+    /**
+     * @brief Handles commands for device control, local or returned by the server.
+     * Private because the routes touch the uplink governor and the flush flag, which the
+     * network task owns: commands reach it through the downlink queue that task drains.
+     * Sensor commands are applied by the ingest task on its next pass.
+     * @param command The command to execute.
+     */
+    void handle(Command command) override;
+
+    static void ingestStep(void *device);  ///< Ingest task body.
+    static void networkStep(void *device); ///< Network task body.
+
+    /**
+     * @brief Queues a GPS fix carried by GPS_DATA_EVENT as routine traffic.
+     * @param event The GPS data event.
+     */
+    void onGpsData(const Event &event);
+
+    /**
+     * @brief Queues an RFID detection carried by RFID_DETECTED_EVENT as access traffic,
+     * ahead of any queued GPS fixes.
+     * @param event The RFID detection event.
+     */
+    void onRfidDetected(const Event &event);
+
+    /**
+     * @brief Turns the status LED on until `durationMs` from now, without blocking the uplink.
+     * Skipped while the deadline monitor sheds load.
+     * @param durationMs Pulse length in milliseconds.
+     */
+    void pulseStatusLed(unsigned long durationMs);
+
+    /**
+     * @brief Forwards a command to the communication handler.
+     * @param command The command to forward.
+     */
+    void forwardToCommunication(const Command &command);
+
+    /**
+     * @brief Forwards a command to the status LED.
+     * @param command The command to forward.
+     */
+    void forwardToStatusLed(const Command &command);
+
+    /**
+     * @brief Hands a sensor command to the ingest task, which owns the sensors.
+     * @param command The command to forward.
+     */
+    void forwardToIngest(const Command &command);
+
+    /**
+     * @brief Uploads every queued record, deferred GPS fixes included, over the next uplink
+     * passes. Each pass still uploads at most UPLINK_RECORDS_PER_PASS records, so the network
+     * task keeps its period; the flush ends once a pass empties the queue or an upload fails.
+     */
+    void flushUplink(const Command &command);
+
+    /**
+     * @brief Makes a SET_GPS_INTERVAL command the governor's base interval; the interval in
+     * effect reaches the ingest task on the next uplink pass.
+     * @param command The SET_GPS_INTERVAL command.
+     */
+    void setGpsInterval(const Command &command);
+
+    void applyGpsInterval(const Command &command); ///< Applies SET_GPS_INTERVAL in the ingest task.
+    void allowRfidCode(const Command &command);    ///< Applies ALLOW_RFID_CODE in the ingest task.
+    void revokeRfidCode(const Command &command);   ///< Applies REVOKE_RFID_CODE in the ingest task.
+
 public:
+    static const int SET_GPS_INTERVAL_COMMAND_ID = 30; ///< Sets the GPS interval to `value` milliseconds.
+    static const int FLUSH_UPLINK_COMMAND_ID = 31;     ///< Uploads every queued record, a pass at a time.
+    static const int ALLOW_RFID_CODE_COMMAND_ID = 32;  ///< Adds the RFID code in `text`.
+    static const int REVOKE_RFID_CODE_COMMAND_ID = 33; ///< Removes the RFID code in `text`.
+
     /**
      * @brief Constructs a TrackingDevice with all necessary components.
+     * Components are composed as members, so a device in static storage never touches the heap.
      * @param gpsRxPin GPS RX pin.
      * @param gpsTxPin GPS TX pin.
      * @param rfidPin RFID sensor pin.
@@ -55,54 +197,108 @@ public:
      * @param trackingUrl GPS tracking endpoint URL.
      * @param rfidUrl RFID scan endpoint URL.
      * @param deviceId Device identifier.
+     * @param clock Time source shared by the device and its components (default: the system
+     *              clock; pass a VirtualClock to simulate faster than real time).
+     * @param uplink Transport for uploads (default: HTTP POST).
      */
     TrackingDevice(int gpsRxPin, int gpsTxPin, int rfidPin, int ledPin,
-                   const String &wifiSSID, const String &wifiPassword,
-                   const String &trackingUrl, const String &rfidUrl,
-                   const String &deviceId);
+                   const char *wifiSSID, const char *wifiPassword,
+                   const char *trackingUrl, const char *rfidUrl,
+                   const char *deviceId, Clock &clock = SystemClock::instance(),
+                   Transport *uplink = nullptr);
 
     /**
      * @brief Handles events from sensors (GPS data, RFID detection).
+     * Events are routed to their handlers through a compile-time StaticRouter.
      * @param event The event to process.
      */
     void on(Event event) override;
 
-    /**
-     * @brief Handles commands for device control.
-     * @param command The command to execute.
-     */
-    void handle(Command command) override;
-
     /**
      * @brief Initializes the device and all its components.
+     * Arms the HeapGuard once initialization is complete.
      */
     void initialize();
 
     /**
      * @brief Updates all sensors and handles communication.
-     * Should be called regularly in the main loop.
+     * Should be called regularly in the main loop when the device runs single-threaded.
      */
     void update();
 
+    /**
+     * @brief Runs one ingest and uplink pass immediately, ignoring the update interval.
+     * Used by update() and by drivers that step the device themselves (e.g. SessionReplay).
+     */
+    void runOnce();
+
+    /**
+     * @brief Splits the device into a sensor ingest task and a network upload task.
+     * Each task is pinned to its own core and the two communicate only through the bounded
+     * uplink queue. Call once after initialize() instead of calling update() from the loop.
+     * @return True if both tasks were started.
+     */
+    bool start();
+
+    /**
+     * @brief Prints the stack high-water marks of the ingest and network tasks.
+     */
+    void printTaskStats();
+
+    /**
+     * @brief Gets the device's metrics registry.
+     * @return Reference to the registry (add application metrics during setup).
+     */
+    MetricsRegistry &getMetrics();
+
+    /**
+     * @brief Prints a snapshot of all registered metrics.
+     */
+    void printMetrics();
+
+    /**
+     * @brief Gets the monitor watching the update, ingest and network cadences.
+     * Its DEADLINE_MISSED_EVENT is published on the device's event bus.
+     * @return Reference to the monitor (enable load shedding here).
+     */
+    DeadlineMonitor &getDeadlineMonitor();
+
+    /**
+     * @brief Gets the controller that slows GPS reporting while the uplink falls behind.
+     * @return Reference to the governor (disable it here to keep a fixed interval).
+     */
+    UplinkGovernor &getUplinkGovernor();
+
+    /**
+     * @brief Gets the event bus the device's sensors publish on.
+     * Subscribe additional handlers (loggers, geofences, ...) here during setup.
+     * @return Reference to the event bus.
+     */
+    Bus &getEventBus();
+
     /**
      * @brief Gets the GPS sensor instance.
      * @return Pointer to the GPS sensor.
      */
-    GpsSensor *getGpsSensor() const;
+    GpsSensor *getGpsSensor();
 
     /**
      * @brief Gets the RFID sensor instance.
      * @return Pointer to the RFID sensor.
      */
-    RfidSensor *getRfidSensor() const;
+    RfidSensor *getRfidSensor();
 
     /**
      * @brief Gets the communication handler instance.
      * @return Pointer to the communication handler.
      */
-    CommunicationHandler *getCommunicationHandler() const;
+    CommunicationHandler *getCommunicationHandler();
 
-    virtual ~TrackingDevice();
+    /**
+     * @brief Gets the device's time source.
+     * @return Reference to the clock.
+     */
+    Clock &getClock();
 };
 
 #endif // TRACKING_DEVICE_H
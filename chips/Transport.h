@@ -0,0 +1,113 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+/**
+ * @file Transport.h
+ * @brief Declares the TransportRequest struct and the Transport interface.
+ *
+ * Abstract uplink for the Modest IoT Nano-framework. CommunicationHandler builds payloads and
+ * hands them to a Transport, which owns the link (WiFi) and the wire protocol. Swapping the
+ * transport lets the same device code upload over HTTP, record its output for replay, or use
+ * another protocol without touching the sensors or the device.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRANSPORT_MAX_HEADERS 4 ///< Extra headers a request can carry.
+
+/**
+ * @brief One outbound upload. Points at caller-owned buffers; nothing is copied.
+ */
+struct TransportRequest {
+    const char* url; ///< Destination endpoint.
+    const char* contentType; ///< MIME type of the body.
+    const uint8_t* body; ///< Payload bytes.
+    size_t length; ///< Payload length in bytes.
+    const char* headerNames[TRANSPORT_MAX_HEADERS]; ///< Extra header names.
+    const char* headerValues[TRANSPORT_MAX_HEADERS]; ///< Extra header values.
+    uint8_t headerCount; ///< Number of extra headers in use.
+
+    TransportRequest(const char* requestUrl, const char* type, const void* data, size_t size)
+        : url(requestUrl), contentType(type), body(static_cast<const uint8_t*>(data)),
+          length(size), headerCount(0) {}
+
+    /**
+     * @brief Adds an extra header.
+     * @param name Header name.
+     * @param value Header value (must outlive the request).
+     * @return True if added, false if TRANSPORT_MAX_HEADERS are already in use.
+     */
+    bool addHeader(const char* name, const char* value) {
+        if (headerCount >= TRANSPORT_MAX_HEADERS) {
+            return false;
+        }
+        headerNames[headerCount] = name;
+        headerValues[headerCount] = value;
+        headerCount++;
+        return true;
+    }
+};
+
+/**
+ * @brief Abstract interface for the device uplink.
+ *
+ * Implement this interface to carry uploads over a new link or protocol. `post` returns a
+ * positive status code (HTTP semantics: 2xx is success) or a negative value if no status was
+ * received.
+ */
+class Transport {
+public:
+    /**
+     * @brief Brings the link up.
+     * @param ssid Network name.
+     * @param password Network password.
+     * @return True if connected.
+     */
+    virtual bool connect(const char* ssid, const char* password) = 0;
+
+    virtual void disconnect() = 0; ///< Drops the link.
+    virtual bool isConnected() = 0; ///< True while the link is up.
+
+    /**
+     * @brief Uploads one request.
+     * @param request The request to send.
+     * @param response Destination for the start of the response body (always null-terminated).
+     * @param responseSize Size of the response buffer.
+     * @return Status code, or a negative value on transport failure.
+     */
+    virtual int post(const TransportRequest& request, char* response, size_t responseSize) = 0;
+
+    /**
+     * @brief Services the link between uploads (acknowledgements, keepalives).
+     * Called from the connection check; request/response transports need nothing here.
+     */
+    virtual void poll() {}
+
+    /**
+     * @brief Gets the largest body one post() can carry.
+     * Callers that group records into one upload (GPS batches) must stay within it.
+     * @return Size limit in bytes (SIZE_MAX if the transport has none).
+     */
+    virtual size_t maxPayload() const { return SIZE_MAX; }
+
+    virtual ~Transport() = default; ///< Virtual destructor for safe inheritance.
+};
+
+#endif // TRANSPORT_H
@@ -0,0 +1,179 @@
+/**
+ * @file UltrasoundSensor.cpp
+ * @brief Implements the UltrasoundSensor class.
+ *
+ * Pings are pipelined with sampling: the interrupt timestamps the echo's edges in the background
+ * and the next sample picks up the width, so the only busy wait is the 10 us trigger pulse
+ * (pulseIn() would block for up to 38 ms on a missing echo).
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "UltrasoundSensor.h"
+#include <Arduino.h>
+
+const Event UltrasoundSensor::DISTANCE_MEASURED_EVENT = Event(DISTANCE_MEASURED_EVENT_ID);
+const Event UltrasoundSensor::OBJECT_NEAR_EVENT = Event(OBJECT_NEAR_EVENT_ID);
+const Event UltrasoundSensor::OBJECT_FAR_EVENT = Event(OBJECT_FAR_EVENT_ID);
+
+UltrasoundSensor::UltrasoundSensor(int triggerPin, int echoPin, unsigned long samplePeriodMs,
+                                   EventHandler *eventHandler, Clock &clock)
+    : SampledSensor(echoPin, samplePeriodMs, DISTANCE_MEASURED_EVENT_ID, ULTRASOUND_WINDOW_SAMPLES, eventHandler,
+                    clock),
+      triggerPin(triggerPin), echoing(false), echoStartUs(0), echoWidthUs(0), echoes(0), echoesSeen(0),
+      lastPingUs(0), capturing(false), simulatedDistance(-1), recent(), recentCount(0), recentNext(0),
+      threshold(-1), hysteresis(0), near(false), rawNear(false), approachUs(0)
+{
+    pinMode(triggerPin, OUTPUT);
+    digitalWrite(triggerPin, LOW);
+    pinMode(echoPin, INPUT);
+}
+
+bool UltrasoundSensor::begin()
+{
+    if (!capturing)
+    {
+        attachInterruptArg(digitalPinToInterrupt(pin), echoInterrupt, this, CHANGE);
+        capturing = true;
+    }
+    return true;
+}
+
+void IRAM_ATTR UltrasoundSensor::echoInterrupt(void *sensor)
+{
+    UltrasoundSensor *self = static_cast<UltrasoundSensor *>(sensor);
+    // Only the pulse width matters, so any microsecond timebase will do: use the IRAM-safe one
+    uint32_t now = static_cast<uint32_t>(SystemClock::isrNowUs());
+    if (digitalRead(self->pin) == HIGH)
+    {
+        self->echoStartUs.store(now, std::memory_order_relaxed);
+        self->echoing.store(true, std::memory_order_release);
+    }
+    else if (self->echoing.load(std::memory_order_relaxed))
+    {
+        self->echoing.store(false, std::memory_order_relaxed);
+        self->injectEcho(now - self->echoStartUs.load(std::memory_order_relaxed));
+    }
+}
+
+void IRAM_ATTR UltrasoundSensor::injectEcho(uint32_t widthUs)
+{
+    echoWidthUs.store(widthUs, std::memory_order_relaxed);
+    echoes.fetch_add(1, std::memory_order_release);
+}
+
+void UltrasoundSensor::setSimulatedDistance(float distanceCm)
+{
+    simulatedDistance = distanceCm;
+}
+
+void UltrasoundSensor::setThreshold(float distanceCm, float hysteresisCm)
+{
+    threshold = distanceCm;
+    hysteresis = hysteresisCm > 0 ? hysteresisCm : 0;
+}
+
+float UltrasoundSensor::maxRange() const
+{
+    return static_cast<float>(getSamplePeriod()) * 1000.0f / ULTRASOUND_US_PER_CM;
+}
+
+void UltrasoundSensor::ping()
+{
+    if (simulatedDistance >= 0)
+    {
+        injectEcho(static_cast<uint32_t>(simulatedDistance * ULTRASOUND_US_PER_CM));
+        return;
+    }
+    digitalWrite(triggerPin, HIGH);
+    delayMicroseconds(ULTRASOUND_TRIGGER_PULSE_US);
+    digitalWrite(triggerPin, LOW);
+}
+
+float UltrasoundSensor::median(float reading)
+{
+    recent[recentNext] = reading;
+    recentNext = (recentNext + 1) % ULTRASOUND_MEDIAN_SIZE;
+    if (recentCount < ULTRASOUND_MEDIAN_SIZE)
+    {
+        recentCount++;
+    }
+
+    // Insertion sort of a handful of values
+    float sorted[ULTRASOUND_MEDIAN_SIZE];
+    for (uint8_t i = 0; i < recentCount; i++)
+    {
+        float value = recent[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value)
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    return sorted[recentCount / 2];
+}
+
+bool UltrasoundSensor::sample(float &value)
+{
+    float reading = -1;
+    uint32_t completed = echoes.load(std::memory_order_acquire);
+    bool inFlight = echoing.load(std::memory_order_acquire);
+    if (completed != echoesSeen)
+    {
+        echoesSeen = completed;
+        reading = static_cast<float>(echoWidthUs.load(std::memory_order_relaxed)) / ULTRASOUND_US_PER_CM;
+    }
+    else if (inFlight)
+    {
+        // Still echoing when the next ping is due: the object is beyond the range of this rate
+        reading = maxRange();
+    }
+
+    uint32_t readingPingUs = lastPingUs;
+
+    // A module still sending its echo would ignore the trigger
+    if (!inFlight)
+    {
+        lastPingUs = static_cast<uint32_t>(getClock().nowUs());
+        ping();
+    }
+    if (reading < 0)
+    {
+        return false;
+    }
+
+    value = median(reading);
+    if (threshold >= 0)
+    {
+        bool readingNear = reading <= threshold;
+        if (readingNear && !rawNear)
+        {
+            approachUs = readingPingUs;
+        }
+        rawNear = readingNear;
+
+        bool nowNear = near ? value <= threshold + hysteresis : value <= threshold;
+        if (nowNear != near)
+        {
+            near = nowNear;
+            on(Event(near ? OBJECT_NEAR_EVENT_ID : OBJECT_FAR_EVENT_ID, value, getClock().nowMs()));
+        }
+    }
+    return true;
+}
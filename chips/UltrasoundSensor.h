@@ -0,0 +1,141 @@
+#ifndef ULTRASOUND_SENSOR_H
+#define ULTRASOUND_SENSOR_H
+
+/**
+ * @file UltrasoundSensor.h
+ * @brief Declares the UltrasoundSensor class.
+ *
+ * Distance sensor for HC-SR04 style modules in the Modest IoT Nano-framework. The echo pulse is
+ * timed by a pin-change interrupt (stamped with SystemClock::isrNowUs(), which is IRAM-safe)
+ * instead of a blocking pulseIn(), so a reading never stalls the caller: each sample collects the echo of the previous ping and fires the next one (a 10 us
+ * trigger pulse). Readings pass through a median filter that rejects single spurious echoes,
+ * feed the SampledSensor window, and are compared with a threshold with hysteresis to raise
+ * OBJECT_NEAR_EVENT and OBJECT_FAR_EVENT as soon as a crossing is seen. Window summaries are
+ * published as DISTANCE_MEASURED_EVENT.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "SampledSensor.h"
+#include <atomic>
+
+#define ULTRASOUND_SAMPLE_PERIOD_MS 20    ///< Default time between pings (50 Hz).
+#define ULTRASOUND_WINDOW_SAMPLES 25      ///< Samples per DISTANCE_MEASURED_EVENT summary.
+#define ULTRASOUND_MEDIAN_SIZE 3          ///< Raw readings the median filter looks at (odd).
+#define ULTRASOUND_US_PER_CM 58           ///< Echo microseconds per centimetre (out and back).
+#define ULTRASOUND_TRIGGER_PULSE_US 10    ///< Width of the trigger pulse.
+
+static_assert(ULTRASOUND_MEDIAN_SIZE % 2 == 1, "ULTRASOUND_MEDIAN_SIZE must be odd");
+
+class UltrasoundSensor : public SampledSensor<float, ULTRASOUND_WINDOW_SAMPLES>
+{
+private:
+    int triggerPin;
+    std::atomic<bool> echoing;          ///< True between the echo's rising and falling edges.
+    std::atomic<uint32_t> echoStartUs;  ///< Rising edge of the current echo.
+    std::atomic<uint32_t> echoWidthUs;  ///< Width of the last complete echo.
+    std::atomic<uint32_t> echoes;       ///< Complete echoes so far.
+    uint32_t echoesSeen;                ///< Value of `echoes` at the last sample.
+    uint32_t lastPingUs;                ///< When the last ping was fired.
+    bool capturing;                     ///< True once begin() attached the interrupt.
+
+    float simulatedDistance;            ///< Distance echoed back to every ping, or negative if off.
+
+    float recent[ULTRASOUND_MEDIAN_SIZE]; ///< Newest raw readings, oldest overwritten first.
+    uint8_t recentCount;
+    uint8_t recentNext;
+
+    float threshold;                    ///< Distance at or below which an object is near.
+    float hysteresis;                   ///< Extra distance needed before it is far again.
+    bool near;                          ///< True while an object is near.
+    bool rawNear;                       ///< True while unfiltered readings are within the threshold.
+    uint32_t approachUs;                ///< Ping of the first unfiltered near reading of the approach.
+
+    static void echoInterrupt(void *sensor); ///< Pin-change interrupt on the echo pin.
+
+    void ping();
+    float median(float reading);
+
+protected:
+    /**
+     * @brief Collects the previous ping's echo, fires the next ping and filters the reading.
+     * @param value Median-filtered distance in centimetres.
+     * @return False if no echo came back since the previous sample.
+     */
+    bool sample(float &value) override;
+
+public:
+    static const int DISTANCE_MEASURED_EVENT_ID = 16; ///< SampleSummary of the last window, in cm.
+    static const int OBJECT_NEAR_EVENT_ID = 17;       ///< Distance fell to the threshold.
+    static const int OBJECT_FAR_EVENT_ID = 18;        ///< Distance rose above threshold plus hysteresis.
+    static const Event DISTANCE_MEASURED_EVENT;       ///< Predefined event for distance summaries.
+    static const Event OBJECT_NEAR_EVENT;             ///< Predefined event for near crossings.
+    static const Event OBJECT_FAR_EVENT;              ///< Predefined event for far crossings.
+
+    /**
+     * @brief Constructs an ultrasonic sensor.
+     * @param triggerPin The pin driving the module's TRIG input.
+     * @param echoPin The pin reading the module's ECHO output.
+     * @param samplePeriodMs Time between pings (bounds the range to about samplePeriodMs * 17 cm).
+     * @param eventHandler Optional handler to receive distance events (default: nullptr).
+     * @param clock Time source (default: the system clock).
+     */
+    UltrasoundSensor(int triggerPin, int echoPin, unsigned long samplePeriodMs = ULTRASOUND_SAMPLE_PERIOD_MS,
+                     EventHandler *eventHandler = nullptr, Clock &clock = SystemClock::instance());
+
+    /**
+     * @brief Attaches the echo interrupt.
+     * @return True if echoes are being timed.
+     */
+    bool begin();
+
+    /**
+     * @brief Sets the near/far threshold; crossings are published with the distance as payload.
+     * @param distanceCm Distance at or below which an object is near.
+     * @param hysteresisCm Extra distance an object must move away before it is far again.
+     */
+    void setThreshold(float distanceCm, float hysteresisCm);
+
+    /**
+     * @brief Feeds a complete echo from another source (a test or a recorded session).
+     * @param widthUs Echo pulse width in microseconds.
+     */
+    void injectEcho(uint32_t widthUs);
+
+    /**
+     * @brief Answers every ping with a simulated object instead of the hardware echo.
+     * @param distanceCm Distance of the object, or a negative value to stop simulating.
+     */
+    void setSimulatedDistance(float distanceCm);
+
+    float getDistance() const { return latest(); } ///< Newest filtered distance in centimetres.
+    bool isNear() const { return near; }           ///< True while an object is within the threshold.
+
+    /**
+     * @brief Gets when the current approach was first seen, before filtering.
+     * @return Time of the ping whose echo first read at or below the threshold (Clock::nowUs()).
+     */
+    uint32_t approachStartUs() const { return approachUs; }
+
+    /**
+     * @brief Longest distance an echo can report before the next ping is due.
+     * @return Range in centimetres; echoes still in flight at the next sample read as this.
+     */
+    float maxRange() const;
+};
+
+#endif // ULTRASOUND_SENSOR_H
@@ -0,0 +1,96 @@
+/**
+ * @file UplinkGovernor.cpp
+ * @brief Implements the UplinkGovernor class.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "UplinkGovernor.h"
+
+UplinkGovernor::UplinkGovernor(unsigned long baseIntervalMs, Clock &clock)
+    : clock(clock), enabled(true), baseInterval(baseIntervalMs), interval(baseIntervalMs),
+      conflating(false), changed(false), lastEvaluation(clock.nowMs()), lastErrors(0)
+{
+    intervalGauge.set(static_cast<int32_t>(interval));
+}
+
+bool UplinkGovernor::update(size_t queuedFixes, uint32_t roundTripMs, uint32_t uploadErrors)
+{
+    unsigned long now = clock.nowMs();
+    if (enabled && now - lastEvaluation >= GOVERNOR_EVALUATION_MS)
+    {
+        lastEvaluation = now;
+        bool failing = uploadErrors != lastErrors;
+        lastErrors = uploadErrors;
+
+        bool congested = failing || queuedFixes >= GOVERNOR_DEPTH_HIGH || roundTripMs >= GOVERNOR_RTT_HIGH_MS;
+        bool healthy = !failing && queuedFixes <= GOVERNOR_DEPTH_LOW && roundTripMs <= GOVERNOR_RTT_LOW_MS;
+        unsigned long longest = baseInterval * GOVERNOR_MAX_BACKOFF;
+
+        if (congested)
+        {
+            if (interval >= longest)
+            {
+                // Backed off as far as allowed: stop queueing fixes that will be stale anyway
+                changed = changed || !conflating;
+                conflating = true;
+            }
+            else
+            {
+                interval = interval * 2 < longest ? interval * 2 : longest;
+                changed = true;
+            }
+        }
+        else if (healthy && (conflating || interval > baseInterval))
+        {
+            unsigned long step = baseInterval / GOVERNOR_RECOVERY_STEPS;
+            interval = interval > baseInterval + step ? interval - step : baseInterval;
+            conflating = false;
+            changed = true;
+        }
+        intervalGauge.set(static_cast<int32_t>(interval));
+    }
+
+    bool report = changed;
+    changed = false;
+    return report;
+}
+
+void UplinkGovernor::setBaseInterval(unsigned long intervalMs)
+{
+    baseInterval = intervalMs;
+    interval = intervalMs;
+    changed = true;
+    intervalGauge.set(static_cast<int32_t>(interval));
+}
+
+void UplinkGovernor::setEnabled(bool isEnabled)
+{
+    enabled = isEnabled;
+    if (!enabled && (interval != baseInterval || conflating))
+    {
+        interval = baseInterval;
+        conflating = false;
+        changed = true;
+        intervalGauge.set(static_cast<int32_t>(interval));
+    }
+}
+
+void UplinkGovernor::registerMetrics(MetricsRegistry &registry)
+{
+    registry.add("governor.gps_interval_ms", intervalGauge);
+}
@@ -0,0 +1,100 @@
+#ifndef UPLINK_GOVERNOR_H
+#define UPLINK_GOVERNOR_H
+
+/**
+ * @file UplinkGovernor.h
+ * @brief Declares the UplinkGovernor class.
+ *
+ * Feedback controller that matches the GPS reporting rate to what the uplink can carry. Every
+ * GOVERNOR_EVALUATION_MS it looks at the fixes waiting in the outbound queue, the smoothed upload
+ * round trip and new upload errors. A congested uplink doubles the GPS interval, up to
+ * GOVERNOR_MAX_BACKOFF times the base interval; if that is still not enough, queued fixes are
+ * conflated so only the latest one waits. A healthy uplink ends conflation and shortens the
+ * interval by a fraction of the base interval per evaluation (additive increase, multiplicative
+ * decrease), so a recovering link is not flooded again at once.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Metrics.h"
+#include "Clock.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define GOVERNOR_EVALUATION_MS 2000 ///< Time between controller decisions.
+#define GOVERNOR_DEPTH_HIGH 8       ///< Queued fixes that mean the uplink is falling behind.
+#define GOVERNOR_DEPTH_LOW 2        ///< Queued fixes at or below which the uplink keeps up.
+#define GOVERNOR_RTT_HIGH_MS 2000   ///< Smoothed round trip that means the uplink is congested.
+#define GOVERNOR_RTT_LOW_MS 1000    ///< Smoothed round trip at or below which the uplink is healthy.
+#define GOVERNOR_MAX_BACKOFF 8      ///< Longest interval, as a multiple of the base interval.
+#define GOVERNOR_RECOVERY_STEPS 4   ///< Evaluations to win back one base interval when healthy.
+
+class UplinkGovernor
+{
+private:
+    Clock &clock;
+    bool enabled;
+    unsigned long baseInterval;    ///< Interval asked for by the application or the server.
+    unsigned long interval;        ///< Interval in effect.
+    bool conflating;               ///< True while only the latest queued fix is kept.
+    bool changed;                  ///< True until the caller has seen the last change.
+    unsigned long lastEvaluation;  ///< Time of the last decision.
+    uint32_t lastErrors;           ///< Upload error count at the last decision.
+
+    Gauge intervalGauge; ///< Interval in effect, in milliseconds.
+
+public:
+    /**
+     * @brief Constructs a governor.
+     * @param baseIntervalMs GPS interval when the uplink is healthy.
+     * @param clock Time source (default: the system clock).
+     */
+    explicit UplinkGovernor(unsigned long baseIntervalMs, Clock &clock = SystemClock::instance());
+
+    /**
+     * @brief Feeds the controller the uplink's state; decides at most every GOVERNOR_EVALUATION_MS.
+     * @param queuedFixes GPS fixes waiting in the outbound queue.
+     * @param roundTripMs Smoothed upload round trip in milliseconds.
+     * @param uploadErrors Total uploads that failed so far.
+     * @return True if the interval or conflation changed since the last true return.
+     */
+    bool update(size_t queuedFixes, uint32_t roundTripMs, uint32_t uploadErrors);
+
+    /**
+     * @brief Changes the interval used while the uplink is healthy, and starts from it again.
+     * @param intervalMs Base GPS interval in milliseconds.
+     */
+    void setBaseInterval(unsigned long intervalMs);
+
+    /**
+     * @brief Enables or disables the controller; disabling restores the base interval.
+     * @param isEnabled True to adapt the GPS rate.
+     */
+    void setEnabled(bool isEnabled);
+
+    unsigned long getInterval() const { return interval; }         ///< GPS interval in effect.
+    unsigned long getBaseInterval() const { return baseInterval; } ///< Healthy GPS interval.
+    bool isConflating() const { return conflating; }               ///< True while keeping only the latest fix.
+
+    /**
+     * @brief Registers `governor.gps_interval_ms`.
+     * @param registry The registry to add it to.
+     */
+    void registerMetrics(MetricsRegistry &registry);
+};
+
+#endif // UPLINK_GOVERNOR_H
@@ -1,129 +1,471 @@
 #include "wokwi-api.h"
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define SECOND 500000
-
-const char *nmea_sentences[] = {
-    "$GPGGA,172914.049,2327.985,S,05150.410,W,1,12,1.0,0.0,M,0.0,M,,*60\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172914.049,A,2327.985,S,05150.410,W,009.7,025.9,060622,000.0,W*74\r\n",
-    "$GPGGA,172915.049,2327.982,S,05150.409,W,1,12,1.0,0.0,M,0.0,M,,*6E\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172915.049,A,2327.982,S,05150.409,W,009.7,025.9,060622,000.0,W*7A\r\n",
-    "$GPGGA,172916.049,2327.980,S,05150.408,W,1,12,1.0,0.0,M,0.0,M,,*6E\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172916.049,A,2327.980,S,05150.408,W,009.7,025.9,060622,000.0,W*7A\r\n",
-    "$GPGGA,172917.049,2327.977,S,05150.406,W,1,12,1.0,0.0,M,0.0,M,,*69\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172917.049,A,2327.977,S,05150.406,W,009.7,025.9,060622,000.0,W*7D\r\n",
-    "$GPGGA,172918.049,2327.975,S,05150.405,W,1,12,1.0,0.0,M,0.0,M,,*67\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172918.049,A,2327.975,S,05150.405,W,009.7,025.9,060622,000.0,W*73\r\n",
-    "$GPGGA,172919.049,2327.973,S,05150.404,W,1,12,1.0,0.0,M,0.0,M,,*61\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172919.049,A,2327.973,S,05150.404,W,009.7,025.9,060622,000.0,W*75\r\n",
-    "$GPGGA,172920.049,2327.970,S,05150.403,W,1,12,1.0,0.0,M,0.0,M,,*6F\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172920.049,A,2327.970,S,05150.403,W,009.7,025.9,060622,000.0,W*7B\r\n",
-    "$GPGGA,172921.049,2327.968,S,05150.402,W,1,12,1.0,0.0,M,0.0,M,,*66\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172921.049,A,2327.968,S,05150.402,W,009.7,025.9,060622,000.0,W*72\r\n",
-    "$GPGGA,172922.049,2327.965,S,05150.401,W,1,12,1.0,0.0,M,0.0,M,,*6B\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172922.049,A,2327.965,S,05150.401,W,009.7,025.9,060622,000.0,W*7F\r\n",
-    "$GPGGA,172923.049,2327.963,S,05150.399,W,1,12,1.0,0.0,M,0.0,M,,*6A\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172923.049,A,2327.963,S,05150.399,W,009.7,025.9,060622,000.0,W*7E\r\n",
-    "$GPGGA,172924.049,2327.960,S,05150.398,W,1,12,1.0,0.0,M,0.0,M,,*6F\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172924.049,A,2327.960,S,05150.398,W,009.7,294.1,060622,000.0,W*7B\r\n",
-    "$GPGGA,172925.049,2327.959,S,05150.401,W,1,12,1.0,0.0,M,0.0,M,,*63\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172925.049,A,2327.959,S,05150.401,W,009.7,294.1,060622,000.0,W*77\r\n",
-    "$GPGGA,172926.049,2327.958,S,05150.403,W,1,12,1.0,0.0,M,0.0,M,,*63\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172926.049,A,2327.958,S,05150.403,W,009.7,294.1,060622,000.0,W*77\r\n",
-    "$GPGGA,172927.049,2327.957,S,05150.406,W,1,12,1.0,0.0,M,0.0,M,,*68\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172927.049,A,2327.957,S,05150.406,W,009.7,205.5,060622,000.0,W*70\r\n",
-    "$GPGGA,172928.049,2327.959,S,05150.407,W,1,12,1.0,0.0,M,0.0,M,,*68\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172928.049,A,2327.959,S,05150.407,W,009.7,205.5,060622,000.0,W*70\r\n",
-    "$GPGGA,172929.049,2327.962,S,05150.408,W,1,12,1.0,0.0,M,0.0,M,,*6E\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172929.049,A,2327.962,S,05150.408,W,009.7,205.5,060622,000.0,W*76\r\n",
-    "$GPGGA,172930.049,2327.964,S,05150.410,W,1,12,1.0,0.0,M,0.0,M,,*69\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172930.049,A,2327.964,S,05150.410,W,009.7,205.5,060622,000.0,W*71\r\n",
-    "$GPGGA,172931.049,2327.967,S,05150.411,W,1,12,1.0,0.0,M,0.0,M,,*6A\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172931.049,A,2327.967,S,05150.411,W,009.7,205.5,060622,000.0,W*72\r\n",
-    "$GPGGA,172932.049,2327.969,S,05150.412,W,1,12,1.0,0.0,M,0.0,M,,*64\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172932.049,A,2327.969,S,05150.412,W,009.7,205.5,060622,000.0,W*7C\r\n",
-    "$GPGGA,172933.049,2327.971,S,05150.413,W,1,12,1.0,0.0,M,0.0,M,,*6D\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172933.049,A,2327.971,S,05150.413,W,009.7,205.5,060622,000.0,W*75\r\n",
-    "$GPGGA,172934.049,2327.974,S,05150.414,W,1,12,1.0,0.0,M,0.0,M,,*68\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172934.049,A,2327.974,S,05150.414,W,009.7,205.5,060622,000.0,W*70\r\n",
-    "$GPGGA,172935.049,2327.976,S,05150.415,W,1,12,1.0,0.0,M,0.0,M,,*6A\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172935.049,A,2327.976,S,05150.415,W,009.7,205.5,060622,000.0,W*72\r\n",
-    "$GPGGA,172936.049,2327.979,S,05150.417,W,1,12,1.0,0.0,M,0.0,M,,*64\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172936.049,A,2327.979,S,05150.417,W,009.7,205.5,060622,000.0,W*7C\r\n",
-    "$GPGGA,172937.049,2327.981,S,05150.418,W,1,12,1.0,0.0,M,0.0,M,,*6D\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172937.049,A,2327.981,S,05150.418,W,009.7,117.1,060622,000.0,W*71\r\n",
-    "$GPGGA,172938.049,2327.983,S,05150.415,W,1,12,1.0,0.0,M,0.0,M,,*6D\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172938.049,A,2327.983,S,05150.415,W,009.7,117.1,060622,000.0,W*71\r\n",
-    "$GPGGA,172939.049,2327.984,S,05150.413,W,1,12,1.0,0.0,M,0.0,M,,*6D\r\n",
-    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n",
-    "$GPRMC,172939.049,A,2327.984,S,05150.413,W,009.7,117.1,060622,000.0,W*71\r\n",
-};
-#define NMEA_COUNT (sizeof(nmea_sentences) / sizeof(nmea_sentences[0]))
+/*
+ * NEO-6M simulator. Replays an NMEA log over the UART, one epoch (the sentences that share a
+ * fix, starting at each GGA) per tick. Output rate, baud rate and time acceleration are chip
+ * attributes, as are fault injectors for bursts, bad checksums and fix loss, so the firmware's
+ * GPS ingestion can be stressed well beyond 1 Hz.
+ *
+ * Attributes (diagram.json "attrs" or the chip controls):
+ *   baud               UART baud rate (default 9600, read once at start)
+ *   rate               Epochs per simulated second (default 1)
+ *   timeScale          Time acceleration factor (default 1.0)
+ *   burstEvery         Every N ticks send burstSize epochs back to back (0 = off)
+ *   burstSize          Epochs per burst (default 4, max GPS_MAX_BURST)
+ *   badChecksumPercent Percentage of sentences sent with a corrupted checksum (default 0)
+ *   fixLossEvery       Lose the fix after N epochs with one (0 = off)
+ *   fixLossLength      Epochs without fix per loss (default 5)
+ *   seed               Seed for the fault injectors, so runs are reproducible (default 1)
+ *
+ * To replay another log, generate a header with tools/nmea2chip.py and build with
+ * -DGPS_NMEA_LOG='"route.h"'.
+ */
+
+#define MICROS_PER_SECOND 1000000
+#define MIN_TICK_MICROS 100
+#define NMEA_MAX_SENTENCE 83 // NMEA 0183 limit, including "\r\n"
+#define GPS_MAX_BURST 16
+#define STATS_INTERVAL_EPOCHS 600
+
+#ifdef GPS_NMEA_LOG
+#include GPS_NMEA_LOG // Defines: static const char nmea_log[]
+#else
+static const char nmea_log[] =
+    "$GPGGA,172914.049,2327.985,S,05150.410,W,1,12,1.0,0.0,M,0.0,M,,*60\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172914.049,A,2327.985,S,05150.410,W,009.7,025.9,060622,000.0,W*74\r\n"
+    "$GPGGA,172915.049,2327.982,S,05150.409,W,1,12,1.0,0.0,M,0.0,M,,*6E\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172915.049,A,2327.982,S,05150.409,W,009.7,025.9,060622,000.0,W*7A\r\n"
+    "$GPGGA,172916.049,2327.980,S,05150.408,W,1,12,1.0,0.0,M,0.0,M,,*6E\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172916.049,A,2327.980,S,05150.408,W,009.7,025.9,060622,000.0,W*7A\r\n"
+    "$GPGGA,172917.049,2327.977,S,05150.406,W,1,12,1.0,0.0,M,0.0,M,,*69\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172917.049,A,2327.977,S,05150.406,W,009.7,025.9,060622,000.0,W*7D\r\n"
+    "$GPGGA,172918.049,2327.975,S,05150.405,W,1,12,1.0,0.0,M,0.0,M,,*67\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172918.049,A,2327.975,S,05150.405,W,009.7,025.9,060622,000.0,W*73\r\n"
+    "$GPGGA,172919.049,2327.973,S,05150.404,W,1,12,1.0,0.0,M,0.0,M,,*61\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172919.049,A,2327.973,S,05150.404,W,009.7,025.9,060622,000.0,W*75\r\n"
+    "$GPGGA,172920.049,2327.970,S,05150.403,W,1,12,1.0,0.0,M,0.0,M,,*6F\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172920.049,A,2327.970,S,05150.403,W,009.7,025.9,060622,000.0,W*7B\r\n"
+    "$GPGGA,172921.049,2327.968,S,05150.402,W,1,12,1.0,0.0,M,0.0,M,,*66\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172921.049,A,2327.968,S,05150.402,W,009.7,025.9,060622,000.0,W*72\r\n"
+    "$GPGGA,172922.049,2327.965,S,05150.401,W,1,12,1.0,0.0,M,0.0,M,,*6B\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172922.049,A,2327.965,S,05150.401,W,009.7,025.9,060622,000.0,W*7F\r\n"
+    "$GPGGA,172923.049,2327.963,S,05150.399,W,1,12,1.0,0.0,M,0.0,M,,*6A\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172923.049,A,2327.963,S,05150.399,W,009.7,025.9,060622,000.0,W*7E\r\n"
+    "$GPGGA,172924.049,2327.960,S,05150.398,W,1,12,1.0,0.0,M,0.0,M,,*6F\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172924.049,A,2327.960,S,05150.398,W,009.7,294.1,060622,000.0,W*7B\r\n"
+    "$GPGGA,172925.049,2327.959,S,05150.401,W,1,12,1.0,0.0,M,0.0,M,,*63\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172925.049,A,2327.959,S,05150.401,W,009.7,294.1,060622,000.0,W*77\r\n"
+    "$GPGGA,172926.049,2327.958,S,05150.403,W,1,12,1.0,0.0,M,0.0,M,,*63\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172926.049,A,2327.958,S,05150.403,W,009.7,294.1,060622,000.0,W*77\r\n"
+    "$GPGGA,172927.049,2327.957,S,05150.406,W,1,12,1.0,0.0,M,0.0,M,,*68\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172927.049,A,2327.957,S,05150.406,W,009.7,205.5,060622,000.0,W*70\r\n"
+    "$GPGGA,172928.049,2327.959,S,05150.407,W,1,12,1.0,0.0,M,0.0,M,,*68\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172928.049,A,2327.959,S,05150.407,W,009.7,205.5,060622,000.0,W*70\r\n"
+    "$GPGGA,172929.049,2327.962,S,05150.408,W,1,12,1.0,0.0,M,0.0,M,,*6E\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172929.049,A,2327.962,S,05150.408,W,009.7,205.5,060622,000.0,W*76\r\n"
+    "$GPGGA,172930.049,2327.964,S,05150.410,W,1,12,1.0,0.0,M,0.0,M,,*69\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172930.049,A,2327.964,S,05150.410,W,009.7,205.5,060622,000.0,W*71\r\n"
+    "$GPGGA,172931.049,2327.967,S,05150.411,W,1,12,1.0,0.0,M,0.0,M,,*6A\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172931.049,A,2327.967,S,05150.411,W,009.7,205.5,060622,000.0,W*72\r\n"
+    "$GPGGA,172932.049,2327.969,S,05150.412,W,1,12,1.0,0.0,M,0.0,M,,*64\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172932.049,A,2327.969,S,05150.412,W,009.7,205.5,060622,000.0,W*7C\r\n"
+    "$GPGGA,172933.049,2327.971,S,05150.413,W,1,12,1.0,0.0,M,0.0,M,,*6D\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172933.049,A,2327.971,S,05150.413,W,009.7,205.5,060622,000.0,W*75\r\n"
+    "$GPGGA,172934.049,2327.974,S,05150.414,W,1,12,1.0,0.0,M,0.0,M,,*68\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172934.049,A,2327.974,S,05150.414,W,009.7,205.5,060622,000.0,W*70\r\n"
+    "$GPGGA,172935.049,2327.976,S,05150.415,W,1,12,1.0,0.0,M,0.0,M,,*6A\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172935.049,A,2327.976,S,05150.415,W,009.7,205.5,060622,000.0,W*72\r\n"
+    "$GPGGA,172936.049,2327.979,S,05150.417,W,1,12,1.0,0.0,M,0.0,M,,*64\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172936.049,A,2327.979,S,05150.417,W,009.7,205.5,060622,000.0,W*7C\r\n"
+    "$GPGGA,172937.049,2327.981,S,05150.418,W,1,12,1.0,0.0,M,0.0,M,,*6D\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172937.049,A,2327.981,S,05150.418,W,009.7,117.1,060622,000.0,W*71\r\n"
+    "$GPGGA,172938.049,2327.983,S,05150.415,W,1,12,1.0,0.0,M,0.0,M,,*6D\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172938.049,A,2327.983,S,05150.415,W,009.7,117.1,060622,000.0,W*71\r\n"
+    "$GPGGA,172939.049,2327.984,S,05150.413,W,1,12,1.0,0.0,M,0.0,M,,*6D\r\n"
+    "$GPGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.0,1.0,1.0*30\r\n"
+    "$GPRMC,172939.049,A,2327.984,S,05150.413,W,009.7,117.1,060622,000.0,W*71\r\n";
+#endif
+
+typedef struct
+{
+  uint32_t offset;
+  uint16_t length;
+} sentence_t;
 
 typedef struct
 {
   uart_dev_t uart0;
-  uint32_t idx;
+  timer_t timer;
+
+  // Log, indexed once at start so ticks never scan it
+  sentence_t *sentences;
+  uint32_t sentence_count;
+  uint32_t *epochs; // First sentence of each epoch, plus a sentinel
+  uint32_t epoch_count;
+  uint32_t next_epoch;
+
+  // Transmit buffer; the UART keeps reading it until write_done
+  uint8_t *tx;
+  uint32_t tx_capacity;
+  uint32_t tx_length;
+  bool tx_busy;
+
+  uint32_t baud;
+  uint32_t rate_attr;
+  uint32_t time_scale_attr;
+  uint32_t burst_every_attr;
+  uint32_t burst_size_attr;
+  uint32_t bad_checksum_attr;
+  uint32_t fix_loss_every_attr;
+  uint32_t fix_loss_length_attr;
+
+  uint32_t tick;
+  uint32_t epochs_with_fix;
+  uint32_t fix_loss_remaining;
+  uint32_t random_state;
+
+  // Statistics
+  uint32_t sent_epochs;
+  uint32_t overruns;
+  uint32_t corrupted;
+  uint32_t lost_fixes;
 } chip_state_t;
 
 static void chip_timer_event(void *user_data);
+static void chip_write_done(void *user_data);
+
+static uint32_t next_random(chip_state_t *chip)
+{
+  // xorshift32: cheap and reproducible for a given seed
+  uint32_t x = chip->random_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  chip->random_state = x;
+  return x;
+}
+
+static bool is_sentence_type(const char *sentence, const char *type)
+{
+  // "$GPGGA" / "$GNGGA": skip '$' and the two-letter talker id
+  return strncmp(sentence + 3, type, 3) == 0;
+}
+
+static uint32_t index_log(chip_state_t *chip, bool fill)
+{
+  uint32_t count = 0;
+  uint32_t epochs = 0;
+  const char *start = NULL;
+  for (const char *c = nmea_log; *c != '\0'; c++)
+  {
+    if (*c == '$')
+    {
+      start = c;
+    }
+    else if (*c == '\n' && start != NULL)
+    {
+      uint32_t length = (uint32_t)(c - start + 1);
+      bool new_epoch = count == 0 || is_sentence_type(start, "GGA");
+      if (fill)
+      {
+        chip->sentences[count].offset = (uint32_t)(start - nmea_log);
+        chip->sentences[count].length = (uint16_t)length;
+        if (new_epoch)
+        {
+          chip->epochs[epochs] = count;
+        }
+      }
+      if (new_epoch)
+      {
+        epochs++;
+      }
+      count++;
+      start = NULL;
+    }
+  }
+  chip->sentence_count = count;
+  chip->epoch_count = epochs;
+  return count;
+}
+
+static uint8_t nmea_checksum(const char *body, uint32_t length)
+{
+  uint8_t checksum = 0;
+  for (uint32_t i = 0; i < length && body[i] != '*'; i++)
+  {
+    checksum ^= (uint8_t)body[i];
+  }
+  return checksum;
+}
+
+// Copies field `index` (0 = sentence type) of a sentence; returns false if it is missing
+static bool nmea_field(const char *sentence, uint32_t length, int index, char *out, size_t size)
+{
+  int field = 0;
+  size_t used = 0;
+  for (uint32_t i = 1; i < length; i++)
+  {
+    char c = sentence[i];
+    if (c == ',' || c == '*' || c == '\r')
+    {
+      if (field == index)
+      {
+        break;
+      }
+      field++;
+      continue;
+    }
+    if (field == index && used + 1 < size)
+    {
+      out[used++] = c;
+    }
+  }
+  out[used] = '\0';
+  return field == index;
+}
+
+// Appends "$<body>*CS\r\n" to the transmit buffer
+static void append_sentence(chip_state_t *chip, const char *body)
+{
+  uint32_t free_space = chip->tx_capacity - chip->tx_length;
+  uint32_t body_length = (uint32_t)strlen(body);
+  int written = snprintf((char *)chip->tx + chip->tx_length, free_space, "$%s*%02X\r\n",
+                         body, nmea_checksum(body, body_length));
+  if (written > 0 && (uint32_t)written < free_space)
+  {
+    chip->tx_length += (uint32_t)written;
+  }
+}
+
+// Rewrites a sentence as a receiver without a fix would send it; other types pass through
+static void append_without_fix(chip_state_t *chip, const char *sentence, uint32_t length)
+{
+  char talker[3] = {sentence[1], sentence[2], '\0'};
+  char time[16];
+  char date[8];
+  char body[NMEA_MAX_SENTENCE];
+  nmea_field(sentence, length, 1, time, sizeof(time));
+  if (is_sentence_type(sentence, "GGA"))
+  {
+    snprintf(body, sizeof(body), "%sGGA,%s,,,,,0,00,99.99,,,,,,", talker, time);
+  }
+  else if (is_sentence_type(sentence, "RMC"))
+  {
+    nmea_field(sentence, length, 9, date, sizeof(date));
+    snprintf(body, sizeof(body), "%sRMC,%s,V,,,,,,,%s,,,N", talker, time, date);
+  }
+  else if (is_sentence_type(sentence, "GSA"))
+  {
+    snprintf(body, sizeof(body), "%sGSA,A,1,,,,,,,,,,,,,99.99,99.99,99.99", talker);
+  }
+  else
+  {
+    memcpy(chip->tx + chip->tx_length, sentence, length);
+    chip->tx_length += length;
+    return;
+  }
+  append_sentence(chip, body);
+}
+
+static void append_epoch(chip_state_t *chip)
+{
+  uint32_t epoch = chip->next_epoch;
+  uint32_t first = chip->epochs[epoch];
+  uint32_t last = chip->epochs[epoch + 1];
+  uint32_t bad_checksum_percent = attr_read(chip->bad_checksum_attr);
+
+  uint32_t fix_loss_every = attr_read(chip->fix_loss_every_attr);
+  if (chip->fix_loss_remaining == 0 && fix_loss_every > 0 && chip->epochs_with_fix >= fix_loss_every)
+  {
+    chip->fix_loss_remaining = attr_read(chip->fix_loss_length_attr);
+    chip->epochs_with_fix = 0;
+  }
+  bool without_fix = chip->fix_loss_remaining > 0;
+  if (without_fix)
+  {
+    chip->fix_loss_remaining--;
+    chip->lost_fixes++;
+  }
+  else
+  {
+    chip->epochs_with_fix++;
+  }
+
+  for (uint32_t i = first; i < last; i++)
+  {
+    const char *sentence = nmea_log + chip->sentences[i].offset;
+    uint32_t length = chip->sentences[i].length;
+    uint32_t start = chip->tx_length;
+    if (without_fix)
+    {
+      append_without_fix(chip, sentence, length);
+    }
+    else
+    {
+      memcpy(chip->tx + chip->tx_length, sentence, length);
+      chip->tx_length += length;
+    }
+
+    if (bad_checksum_percent > 0 && next_random(chip) % 100 < bad_checksum_percent)
+    {
+      char *star = memchr(chip->tx + start, '*', chip->tx_length - start);
+      if (star != NULL && star + 2 < (char *)chip->tx + chip->tx_length)
+      {
+        star[2] = star[2] == '0' ? '1' : '0';
+        chip->corrupted++;
+      }
+    }
+  }
+
+  chip->next_epoch = (epoch + 1) % chip->epoch_count;
+  chip->sent_epochs++;
+  if (chip->sent_epochs % STATS_INTERVAL_EPOCHS == 0)
+  {
+    printf("NEO-6M: %u epochs, %u overruns, %u corrupted sentences, %u epochs without fix\n",
+           chip->sent_epochs, chip->overruns, chip->corrupted, chip->lost_fixes);
+  }
+}
+
+static uint32_t tick_micros(chip_state_t *chip)
+{
+  uint32_t rate = attr_read(chip->rate_attr);
+  float time_scale = attr_read_float(chip->time_scale_attr);
+  float ticks_per_second = (rate > 0 ? rate : 1) * (time_scale > 0 ? time_scale : 1.0f);
+  uint32_t period = (uint32_t)(MICROS_PER_SECOND / ticks_per_second);
+  return period < MIN_TICK_MICROS ? MIN_TICK_MICROS : period;
+}
 
 void chip_init()
 {
   chip_state_t *chip = malloc(sizeof(chip_state_t));
   memset(chip, 0, sizeof(chip_state_t));
 
+  chip->baud = attr_init("baud", 9600);
+  chip->rate_attr = attr_init("rate", 1);
+  chip->time_scale_attr = attr_init_float("timeScale", 1.0f);
+  chip->burst_every_attr = attr_init("burstEvery", 0);
+  chip->burst_size_attr = attr_init("burstSize", 4);
+  chip->bad_checksum_attr = attr_init("badChecksumPercent", 0);
+  chip->fix_loss_every_attr = attr_init("fixLossEvery", 0);
+  chip->fix_loss_length_attr = attr_init("fixLossLength", 5);
+  chip->random_state = attr_read(attr_init("seed", 1));
+  if (chip->random_state == 0)
+  {
+    chip->random_state = 1;
+  }
+
+  // Index the log: sentence offsets/lengths and epoch boundaries
+  index_log(chip, false);
+  chip->sentences = malloc(chip->sentence_count * sizeof(sentence_t));
+  chip->epochs = malloc((chip->epoch_count + 1) * sizeof(uint32_t));
+  index_log(chip, true);
+  chip->epochs[chip->epoch_count] = chip->sentence_count;
+
+  // Size the transmit buffer for the largest epoch, a full burst of them
+  uint32_t largest_epoch = 0;
+  for (uint32_t e = 0; e < chip->epoch_count; e++)
+  {
+    uint32_t bytes = 0;
+    for (uint32_t i = chip->epochs[e]; i < chip->epochs[e + 1]; i++)
+    {
+      uint32_t length = chip->sentences[i].length;
+      bytes += length > NMEA_MAX_SENTENCE ? length : NMEA_MAX_SENTENCE;
+    }
+    largest_epoch = bytes > largest_epoch ? bytes : largest_epoch;
+  }
+  chip->tx_capacity = largest_epoch * GPS_MAX_BURST;
+  chip->tx = malloc(chip->tx_capacity);
+
   // Setup UART
   const uart_config_t uart_config = {
       .tx = pin_init("TX", INPUT_PULLUP),
       .rx = pin_init("RX", INPUT),
-      .baud_rate = 9600,
+      .baud_rate = attr_read(chip->baud),
+      .write_done = chip_write_done,
       .user_data = chip,
   };
   chip->uart0 = uart_init(&uart_config);
 
-  // Setup timer to send NMEA every second
+  // One-shot timer, re-armed every tick so rate changes apply immediately
   const timer_config_t timer_config = {
       .callback = chip_timer_event,
       .user_data = chip};
-  timer_t timer = timer_init(&timer_config);
-  timer_start(timer, SECOND, true);
+  chip->timer = timer_init(&timer_config);
+  timer_start(chip->timer, tick_micros(chip), false);
 
-  chip->idx = 0;
-  printf("NEO-6M simulation started.\n");
+  printf("NEO-6M simulation started: %u sentences in %u epochs, %u baud.\n",
+         chip->sentence_count, chip->epoch_count, attr_read(chip->baud));
+}
+
+static void chip_write_done(void *user_data)
+{
+  chip_state_t *chip = (chip_state_t *)user_data;
+  chip->tx_busy = false;
 }
 
 static void chip_timer_event(void *user_data)
 {
   chip_state_t *chip = (chip_state_t *)user_data;
-  const char *nmea = nmea_sentences[chip->idx];
-  uart_write(chip->uart0, (uint8_t *)nmea, strlen(nmea));
-  chip->idx = (chip->idx + 1) % NMEA_COUNT;
-}
\ No newline at end of file
+  timer_start(chip->timer, tick_micros(chip), false);
+  chip->tick++;
+
+  if (chip->epoch_count == 0)
+  {
+    return;
+  }
+  if (chip->tx_busy)
+  {
+    // The previous output has not left the UART yet: the rate exceeds the baud rate
+    chip->overruns++;
+    chip->next_epoch = (chip->next_epoch + 1) % chip->epoch_count;
+    return;
+  }
+
+  uint32_t epochs = 1;
+  uint32_t burst_every = attr_read(chip->burst_every_attr);
+  if (burst_every > 0 && chip->tick % burst_every == 0)
+  {
+    epochs = attr_read(chip->burst_size_attr);
+    epochs = epochs < 1 ? 1 : (epochs > GPS_MAX_BURST ? GPS_MAX_BURST : epochs);
+  }
+
+  chip->tx_length = 0;
+  for (uint32_t i = 0; i < epochs; i++)
+  {
+    append_epoch(chip);
+  }
+  chip->tx_busy = uart_write(chip->uart0, chip->tx, chip->tx_length);
+  if (!chip->tx_busy)
+  {
+    chip->overruns++;
+  }
+}
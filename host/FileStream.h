@@ -0,0 +1,56 @@
+#ifndef HOST_FILE_STREAM_H
+#define HOST_FILE_STREAM_H
+
+/**
+ * @file FileStream.h
+ * @brief Declares the FileStream class: an Arduino Stream over a stdio FILE for host tools.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <Arduino.h>
+
+class FileStream : public Stream
+{
+private:
+    FILE *file;
+
+public:
+    explicit FileStream(FILE *file) : file(file) {}
+
+    int available() override
+    {
+        int c = peek();
+        return c >= 0 ? 1 : 0;
+    }
+
+    int read() override { return fgetc(file); }
+
+    int peek() override
+    {
+        int c = fgetc(file);
+        if (c != EOF)
+        {
+            ungetc(c, file);
+        }
+        return c;
+    }
+
+    size_t write(uint8_t byte) override { return fputc(byte, file) != EOF ? 1 : 0; }
+};
+
+#endif // HOST_FILE_STREAM_H
@@ -0,0 +1,39 @@
+/**
+ * @file bench.cpp
+ * @brief Host benchmark runner.
+ *
+ * Usage: `bench` runs FrameworkBenchmark::runAll(); `bench <tracking-url> <broker-host>
+ * <broker-port> [records]` also compares the HTTP and MQTT uplinks (see Benchmark.h). Results are
+ * JSON lines on stdout, the same format the device prints over serial.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ModestIoT.h"
+#include <stdlib.h>
+
+int main(int argc, char **argv)
+{
+    FrameworkBenchmark::runAll(Serial);
+    if (argc >= 4)
+    {
+        uint32_t records = argc >= 5 ? strtoul(argv[4], nullptr, 10) : 2000;
+        FrameworkBenchmark::compareUplinks(Serial, argv[1], argv[2], static_cast<uint16_t>(atoi(argv[3])), records);
+    }
+    Serial.flush();
+    return 0;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file faucet.cpp
+ * @brief Measures CiaSteelFaucet hand-to-valve latency in simulation.
+ *
+ * Usage: `faucet [trials]` (default 1000). Exits with status 1 if any approach missed
+ * FAUCET_LATENCY_BUDGET_MS, so ctest runs it as a regression check.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ModestIoT.h"
+#include <stdlib.h>
+
+int main(int argc, char **argv)
+{
+    uint32_t trials = argc >= 2 ? strtoul(argv[1], nullptr, 10) : 1000;
+    bool withinBudget = FrameworkBenchmark::measureFaucetLatency(Serial, trials);
+    Serial.flush();
+    return withinBudget ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file fleet.cpp
+ * @brief Runs a simulated fleet (see FleetSimulator.h) and prints its JSON summary.
+ *
+ * Usage: `fleet [devices] [workers] [duration-ms] [tracking-url rfid-url]`. Defaults: 200 devices,
+ * one worker per hardware thread, ten simulated minutes, uploads recorded offline. With URLs the
+ * devices POST through SocketTransport, e.g. to tools/mock_server.py. Up to 20000 devices; the
+ * static fleet only occupies memory for the devices actually populated.
+ * Exits with status 1 if no upload was made or, offline, if the latency percentiles do not
+ * reflect the modeled uplink latency (FleetConfig::uplinkLatencyMs and uplinkJitterMs).
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ModestIoT.h"
+#include "FleetSimulator.h"
+#include <stdlib.h>
+
+#define FLEET_HOST_MAX_DEVICES 20000
+#define FLEET_HOST_STEP_MS 100
+
+static FleetSimulator<FLEET_HOST_MAX_DEVICES> fleet;
+
+int main(int argc, char **argv)
+{
+    size_t devices = argc >= 2 ? strtoul(argv[1], nullptr, 10) : 200;
+    unsigned workers = argc >= 3 ? static_cast<unsigned>(atoi(argv[2])) : 0;
+    unsigned long durationMs = argc >= 4 ? strtoul(argv[3], nullptr, 10) : 600000;
+
+    FleetConfig config;
+    if (argc >= 6)
+    {
+        config.useSockets = true;
+        config.trackingUrl = argv[4];
+        config.rfidUrl = argv[5];
+    }
+
+    fleet.populate(devices, config);
+    fleet.run(durationMs, FLEET_HOST_STEP_MS, workers, Serial);
+    Serial.flush();
+
+    const TransportMetrics &metrics = fleet.getMetrics();
+    if (metrics.requests.get() == 0)
+    {
+        return 1;
+    }
+    if (!config.useSockets)
+    {
+        // Percentiles are bucket upper bounds, so they may read up to twice the real latency
+        uint64_t floorUs = static_cast<uint64_t>(config.uplinkLatencyMs) * 1000;
+        uint64_t ceilingUs = static_cast<uint64_t>(config.uplinkLatencyMs + config.uplinkJitterMs) * 2000;
+        uint64_t p50 = metrics.latency.percentile(50);
+        uint64_t p99 = metrics.latency.percentile(99);
+        if (p50 == 0 || p50 < floorUs || p99 < p50 || p99 > ceilingUs)
+        {
+            Serial.println("fleet: latency percentiles do not match the uplink latency model");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file replay.cpp
+ * @brief Replays a recorded session trace (see SessionReplay.h) on a virtual clock.
+ *
+ * Usage: `replay [trace-file] [--record]`. Reads the trace from the file, or from stdin if none
+ * is given, and prints the JSON summary. With --record every upload is also printed as a
+ * `<ms> P <body>` line; merged into the trace (`sort -s -n -k1,1`), they become the reference
+ * payloads for the next run.
+ * Exits with status 1 if the device diverged from the reference payloads.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "ModestIoT.h"
+#include "FileStream.h"
+#include "HeapGuard.h"
+#include <string.h>
+
+static VirtualClock replayClock;
+static TrackingDevice device(16, 17, 21, 2, "replay", "", "http://localhost:5000/api/v1/tracking",
+                             "http://localhost:5000/api/v1/sensor-scans/create", "HC2956", replayClock);
+static RecordingTransport transport(replayClock);
+
+/**
+ * @brief Prefixes every line the recording sink writes with the session time it was written at.
+ */
+class SessionTimePrint : public Print
+{
+private:
+    Print &output;
+    unsigned long startedAt = 0;
+    bool lineStart = true;
+
+public:
+    explicit SessionTimePrint(Print &output) : output(output) {}
+
+    void start() { startedAt = replayClock.nowMs(); }
+
+    size_t write(uint8_t byte) override
+    {
+        if (lineStart)
+        {
+            output.print(replayClock.nowMs() - startedAt);
+            output.print(' ');
+        }
+        lineStart = byte == '\n';
+        return output.write(byte);
+    }
+};
+
+static SessionTimePrint recording(Serial);
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0)
+        {
+            transport.setSink(&recording);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+    FILE *file = path != nullptr ? fopen(path, "r") : stdin;
+    if (file == nullptr)
+    {
+        perror(path);
+        return 2;
+    }
+
+    static SessionReplay replay(device, transport, &replayClock);
+    device.initialize();
+    FileStream trace(file);
+    recording.start();
+    bool reproduced = replay.run(trace, Serial);
+
+    // Built with MODESTIOT_HEAP_GUARD (replay_heap_guard), the session must not touch the heap
+    if (HeapGuard::isArmed() && HeapGuard::allocationsSinceArm() > 0)
+    {
+        Serial.printf("{\"heap_guard\":\"fail\",\"allocations\":%lu}\n",
+                      static_cast<unsigned long>(HeapGuard::allocationsSinceArm()));
+        reproduced = false;
+    }
+    Serial.flush();
+    return reproduced ? 0 : 1;
+}
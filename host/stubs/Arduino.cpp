@@ -0,0 +1,208 @@
+/**
+ * @file Arduino.cpp
+ * @brief Implements the host stand-ins for the Arduino core, WiFi and SPI globals.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "WiFi.h"
+#include <stdarg.h>
+#include <chrono>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial(stdout);
+HardwareSerial Serial2(nullptr);
+EspClass ESP;
+WiFiClass WiFi;
+SPIClass SPI;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+static std::minstd_rand randomSource;
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    while (written < size && write(buffer[written]) == 1)
+    {
+        written++;
+    }
+    return written;
+}
+
+size_t Print::print(long value, int base)
+{
+    if (base == DEC)
+    {
+        char text[24];
+        snprintf(text, sizeof(text), "%ld", value);
+        return write(text);
+    }
+    return print(static_cast<unsigned long>(value), base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    char text[24];
+    snprintf(text, sizeof(text), base == HEX ? "%lX" : "%lu", value);
+    return write(text);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char text[256];
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vsnprintf(text, sizeof(text), format, arguments);
+    va_end(arguments);
+    if (length < 0)
+    {
+        return 0;
+    }
+    return write(reinterpret_cast<const uint8_t *>(text),
+                 static_cast<size_t>(length) < sizeof(text) ? length : sizeof(text) - 1);
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t count = 0;
+    int c;
+    while (count < length && (c = read()) >= 0)
+    {
+        buffer[count++] = static_cast<char>(c);
+    }
+    return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length)
+{
+    size_t count = 0;
+    int c;
+    while (count < length && (c = read()) >= 0 && c != terminator)
+    {
+        buffer[count++] = static_cast<char>(c);
+    }
+    return count;
+}
+
+size_t HardwareSerial::write(uint8_t byte)
+{
+    return output != nullptr ? fwrite(&byte, 1, 1, output) : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    return output != nullptr ? fwrite(buffer, 1, size, output) : size;
+}
+
+void HardwareSerial::flush()
+{
+    if (output != nullptr)
+    {
+        fflush(output);
+    }
+}
+
+unsigned long millis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+void pinMode(uint8_t, uint8_t)
+{
+}
+
+void digitalWrite(uint8_t, uint8_t)
+{
+}
+
+int digitalRead(uint8_t)
+{
+    return HIGH;
+}
+
+int analogRead(uint8_t)
+{
+    return 0;
+}
+
+int digitalPinToInterrupt(int pin)
+{
+    return pin;
+}
+
+void attachInterruptArg(uint8_t, void (*)(void *), void *, int)
+{
+}
+
+void attachInterrupt(uint8_t, void (*)(), int)
+{
+}
+
+void detachInterrupt(uint8_t)
+{
+}
+
+long random(long howBig)
+{
+    return howBig > 0 ? static_cast<long>(randomSource() % static_cast<unsigned long>(howBig)) : 0;
+}
+
+long random(long howSmall, long howBig)
+{
+    return howBig > howSmall ? howSmall + random(howBig - howSmall) : howSmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+    randomSource.seed(seed != 0 ? seed : 1);
+}
+
+uint32_t EspClass::getCycleCount()
+{
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - bootTime).count());
+}
@@ -0,0 +1,182 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the subset of the Arduino core the framework uses.
+ *
+ * Lets the Modest IoT Nano-framework build and run on a workstation (see host/CMakeLists.txt).
+ * Time comes from std::chrono, `Serial` writes to stdout, `Serial2` never has input (simulations
+ * feed the GPS sensor through GpsSensor::setInput), and GPIO calls do nothing. Only what the
+ * framework calls is provided; this is not a general Arduino emulation.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define LOW 0x0
+#define HIGH 0x1
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define SERIAL_8N1 0x800001c
+#define DEC 10
+#define HEX 16
+
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+
+/**
+ * @brief Minimal heap-backed string; the framework itself avoids it in steady state.
+ */
+class String
+{
+private:
+    std::string text;
+
+public:
+    String() {}
+    String(const char *value) : text(value != nullptr ? value : "") {}
+    String(int value) : text(std::to_string(value)) {}
+    String(unsigned long value) : text(std::to_string(value)) {}
+
+    const char *c_str() const { return text.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(text.size()); }
+    String operator+(const String &other) const { return String((text + other.text).c_str()); }
+    bool operator==(const String &other) const { return text == other.text; }
+};
+
+/**
+ * @brief Byte sink with the Arduino print/println overloads.
+ */
+class Print
+{
+public:
+    virtual size_t write(uint8_t byte) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *text) { return text != nullptr ? write(reinterpret_cast<const uint8_t *>(text), strlen(text)) : 0; }
+
+    size_t print(const char *text) { return write(text); }
+    size_t print(const String &text) { return write(text.c_str()); }
+    size_t print(char value) { return write(static_cast<uint8_t>(value)); }
+    size_t print(int value, int base = DEC) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned int value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(long long value, int base = DEC) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned long long value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(double value, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T &value) { return print(value) + println(); }
+    template <typename T>
+    size_t println(const T &value, int format) { return print(value, format) + println(); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    virtual void flush() {}
+    virtual ~Print() = default;
+};
+
+/**
+ * @brief Readable byte source.
+ */
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes(reinterpret_cast<char *>(buffer), length); }
+    size_t readBytesUntil(char terminator, char *buffer, size_t length);
+    void setTimeout(unsigned long) {}
+};
+
+/**
+ * @brief UART stand-in: `Serial` writes to stdout, `Serial2` has no input.
+ */
+class HardwareSerial : public Stream
+{
+private:
+    FILE *output;
+
+public:
+    explicit HardwareSerial(FILE *output) : output(output) {}
+
+    void begin(unsigned long, uint32_t = SERIAL_8N1, int = -1, int = -1) {}
+    size_t setRxBufferSize(size_t size) { return size; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t byte) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+int digitalPinToInterrupt(int pin);
+void attachInterruptArg(uint8_t pin, void (*handler)(void *), void *argument, int mode);
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(uint8_t pin);
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+/**
+ * @brief Chip queries; the host has no cycle counter, so cycles are steady_clock nanoseconds.
+ */
+class EspClass
+{
+public:
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 1000; }
+    uint32_t getFreeHeap() { return 0; }
+    uint32_t getMinFreeHeap() { return 0; }
+    void restart() { exit(0); }
+};
+
+extern EspClass ESP;
+
+#endif // HOST_ARDUINO_H
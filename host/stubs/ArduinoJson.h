@@ -0,0 +1,139 @@
+#ifndef HOST_ARDUINO_JSON_H
+#define HOST_ARDUINO_JSON_H
+
+/**
+ * @file ArduinoJson.h
+ * @brief Host stand-in for the part of ArduinoJson the framework uses.
+ *
+ * A flat StaticJsonDocument whose members are assigned once and serialized in insertion order,
+ * which is all the payload builders need. Values are rendered as they are assigned into the
+ * document's own storage, so, as with the real library, nothing is allocated.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define JSON_HOST_MAX_MEMBERS 16 ///< Members one document can hold.
+#define JSON_HOST_VALUE_SIZE 64  ///< Longest rendered value (strings are truncated to fit).
+
+/**
+ * @brief One member of a document; assigning to it renders the value as JSON text.
+ */
+class JsonMember
+{
+private:
+    char text[JSON_HOST_VALUE_SIZE];
+
+    JsonMember &quote(const char *value)
+    {
+        size_t length = 0;
+        text[length++] = '"';
+        for (const char *c = value != nullptr ? value : ""; *c != '\0' && length < sizeof(text) - 3; c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                text[length++] = '\\';
+            }
+            text[length++] = static_cast<unsigned char>(*c) < 0x20 ? ' ' : *c;
+        }
+        text[length++] = '"';
+        text[length] = '\0';
+        return *this;
+    }
+
+public:
+    const char *key = nullptr;
+
+    const char *c_str() const { return text; }
+
+    JsonMember &operator=(const char *value) { return quote(value); }
+    JsonMember &operator=(bool value) { snprintf(text, sizeof(text), "%s", value ? "true" : "false"); return *this; }
+    JsonMember &operator=(int value) { snprintf(text, sizeof(text), "%d", value); return *this; }
+    JsonMember &operator=(long value) { snprintf(text, sizeof(text), "%ld", value); return *this; }
+    JsonMember &operator=(unsigned int value) { snprintf(text, sizeof(text), "%u", value); return *this; }
+    JsonMember &operator=(unsigned long value) { snprintf(text, sizeof(text), "%lu", value); return *this; }
+    JsonMember &operator=(float value) { return *this = static_cast<double>(value); }
+    JsonMember &operator=(double value) { snprintf(text, sizeof(text), "%.9g", value); return *this; }
+};
+
+template <size_t Capacity>
+class StaticJsonDocument
+{
+private:
+    JsonMember members[JSON_HOST_MAX_MEMBERS];
+    size_t count = 0;
+
+public:
+    /**
+     * @brief Gets a member by key, adding it if it is new (keys must outlive the document).
+     */
+    JsonMember &operator[](const char *key)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (strcmp(members[i].key, key) == 0)
+            {
+                return members[i];
+            }
+        }
+        JsonMember &member = members[count < JSON_HOST_MAX_MEMBERS ? count++ : JSON_HOST_MAX_MEMBERS - 1];
+        member.key = key;
+        member = static_cast<const char *>(nullptr);
+        return member;
+    }
+
+    /**
+     * @brief Writes the document as compact JSON.
+     * @return Characters written, excluding the terminator; output that does not fit is cut off.
+     */
+    size_t serialize(char *buffer, size_t size) const
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+        size_t length = 0;
+        auto append = [&](const char *text) {
+            while (*text != '\0' && length < size - 1)
+            {
+                buffer[length++] = *text++;
+            }
+        };
+        append("{");
+        for (size_t i = 0; i < count; i++)
+        {
+            append(i > 0 ? ",\"" : "\"");
+            append(members[i].key);
+            append("\":");
+            append(members[i].c_str());
+        }
+        append("}");
+        buffer[length] = '\0';
+        return length;
+    }
+};
+
+template <size_t Capacity>
+size_t serializeJson(const StaticJsonDocument<Capacity> &document, char *buffer, size_t size)
+{
+    return document.serialize(buffer, size);
+}
+
+#endif // HOST_ARDUINO_JSON_H
@@ -0,0 +1,43 @@
+#ifndef HOST_CLIENT_H
+#define HOST_CLIENT_H
+
+/**
+ * @file Client.h
+ * @brief Host stand-in for the Arduino `Client` interface (implemented by SocketClient).
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Arduino.h"
+
+class Client : public Stream
+{
+public:
+    virtual int connect(const char *host, uint16_t port) = 0;
+    size_t write(uint8_t byte) override = 0;
+    size_t write(const uint8_t *buffer, size_t size) override = 0;
+    using Print::write;
+    int available() override = 0;
+    int read() override = 0;
+    virtual int read(uint8_t *buffer, size_t size) = 0;
+    int peek() override = 0;
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+    virtual operator bool() { return connected() != 0; }
+};
+
+#endif // HOST_CLIENT_H
@@ -0,0 +1,52 @@
+#ifndef HOST_HTTP_CLIENT_H
+#define HOST_HTTP_CLIENT_H
+
+/**
+ * @file HTTPClient.h
+ * @brief Host stand-in for the ESP32 HTTPClient.
+ *
+ * Every POST fails with HTTPC_ERROR_CONNECTION_REFUSED, so HttpTransport builds but never reaches
+ * a server on a host. Use SocketTransport (e.g. FleetConfig::useSockets) to POST for real.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "WiFi.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+class WiFiClient : public Stream
+{
+public:
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t) override { return 0; }
+};
+
+class HTTPClient
+{
+public:
+    bool begin(const char *) { return true; }
+    void addHeader(const char *, const char *) {}
+    int POST(uint8_t *, size_t) { return HTTPC_ERROR_CONNECTION_REFUSED; }
+    int getSize() { return 0; }
+    WiFiClient *getStreamPtr() { return nullptr; }
+    void end() {}
+};
+
+#endif // HOST_HTTP_CLIENT_H
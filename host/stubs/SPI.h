@@ -0,0 +1,47 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+/**
+ * @file SPI.h
+ * @brief Host stand-in for the Arduino SPI library: no device ever answers (reads return 0).
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Arduino.h"
+
+#define MSBFIRST 1
+#define SPI_MODE0 0x00
+
+class SPISettings
+{
+public:
+    SPISettings(uint32_t = 1000000, uint8_t = MSBFIRST, uint8_t = SPI_MODE0) {}
+};
+
+class SPIClass
+{
+public:
+    void begin(int8_t = -1, int8_t = -1, int8_t = -1, int8_t = -1) {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t) { return 0; }
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
@@ -0,0 +1,146 @@
+/**
+ * @file TinyGPSPlus.cpp
+ * @brief Implements the host stand-in for TinyGPSPlus.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "TinyGPSPlus.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TINY_GPS_MAX_FIELDS 20
+
+/**
+ * @brief Converts an NMEA ddmm.mmmm (or dddmm.mmmm) field and its hemisphere to degrees.
+ */
+static double toDegrees(const char *field, const char *hemisphere)
+{
+    double value = atof(field);
+    int degrees = static_cast<int>(value / 100);
+    double result = degrees + (value - degrees * 100) / 60.0;
+    return *hemisphere == 'S' || *hemisphere == 'W' ? -result : result;
+}
+
+static int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+bool TinyGPSPlus::encode(char c)
+{
+    processed++;
+    if (c == '$')
+    {
+        length = 0;
+        overflow = false;
+    }
+    if (c == '\r' || c == '\n')
+    {
+        bool complete = length > 0 && !overflow && commit();
+        length = 0;
+        return complete;
+    }
+    if (length < sizeof(sentence) - 1)
+    {
+        sentence[length++] = c;
+    }
+    else
+    {
+        overflow = true;
+    }
+    return false;
+}
+
+bool TinyGPSPlus::commit()
+{
+    sentence[length] = '\0';
+    char *star = strchr(sentence, '*');
+    if (sentence[0] != '$' || star == nullptr || hexDigit(star[1]) < 0 || hexDigit(star[2]) < 0)
+    {
+        return false;
+    }
+    uint8_t checksum = 0;
+    for (const char *p = sentence + 1; p < star; p++)
+    {
+        checksum ^= static_cast<uint8_t>(*p);
+    }
+    if (checksum != hexDigit(star[1]) * 16 + hexDigit(star[2]))
+    {
+        failed++;
+        return false;
+    }
+    passed++;
+    *star = '\0';
+
+    // Split in place; empty fields stay as empty strings
+    const char *fields[TINY_GPS_MAX_FIELDS];
+    size_t count = 0;
+    char *cursor = sentence + 1;
+    while (count < TINY_GPS_MAX_FIELDS)
+    {
+        fields[count++] = cursor;
+        char *comma = strchr(cursor, ',');
+        if (comma == nullptr)
+        {
+            break;
+        }
+        *comma = '\0';
+        cursor = comma + 1;
+    }
+
+    size_t typeLength = strlen(fields[0]);
+    const char *type = typeLength >= 3 ? fields[0] + typeLength - 3 : "";
+    size_t at; // Index of the latitude field; hemisphere, longitude and hemisphere follow it
+    bool hasFix;
+    if (strcmp(type, "GGA") == 0 && count > 6)
+    {
+        at = 2;
+        hasFix = atoi(fields[6]) > 0;
+    }
+    else if (strcmp(type, "RMC") == 0 && count > 6)
+    {
+        at = 3;
+        hasFix = fields[2][0] == 'A';
+    }
+    else
+    {
+        return false;
+    }
+    if (!hasFix || fields[at][0] == '\0' || fields[at + 2][0] == '\0')
+    {
+        return false;
+    }
+
+    location.latitude = toDegrees(fields[at], fields[at + 1]);
+    location.longitude = toDegrees(fields[at + 2], fields[at + 3]);
+    location.valid = true;
+    location.updated = true;
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef HOST_TINY_GPS_PLUS_H
+#define HOST_TINY_GPS_PLUS_H
+
+/**
+ * @file TinyGPSPlus.h
+ * @brief Host stand-in for TinyGPSPlus: decodes the position of GGA and RMC sentences.
+ *
+ * Follows the library's semantics where the framework depends on them: sentences are
+ * checksum-verified, a position is committed only by a sentence that carries a fix, and
+ * `location.isUpdated()` stays set until the position is read.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Arduino.h"
+
+#define TINY_GPS_SENTENCE_SIZE 96 ///< Longest sentence kept; longer ones are discarded.
+
+class TinyGPSLocation
+{
+    friend class TinyGPSPlus;
+
+private:
+    bool valid = false;
+    bool updated = false;
+    double latitude = 0;
+    double longitude = 0;
+
+public:
+    bool isValid() const { return valid; }
+    bool isUpdated() const { return updated; }
+    double lat() { updated = false; return latitude; }
+    double lng() { updated = false; return longitude; }
+};
+
+class TinyGPSPlus
+{
+private:
+    char sentence[TINY_GPS_SENTENCE_SIZE];
+    uint8_t length = 0;
+    bool overflow = false;
+    uint32_t processed = 0;
+    uint32_t passed = 0;
+    uint32_t failed = 0;
+
+    bool commit();
+
+public:
+    TinyGPSLocation location;
+
+    /**
+     * @brief Feeds one character.
+     * @return True if it completed a valid sentence that carried a position fix.
+     */
+    bool encode(char c);
+
+    uint32_t charsProcessed() const { return processed; }
+    uint32_t passedChecksum() const { return passed; }
+    uint32_t failedChecksum() const { return failed; }
+};
+
+#endif // HOST_TINY_GPS_PLUS_H
@@ -0,0 +1,44 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+/**
+ * @file WiFi.h
+ * @brief Host stand-in for the ESP32 WiFi library.
+ *
+ * The workstation's own network is always up, so `WiFi.status()` reports WL_CONNECTED. There is
+ * no WiFiClient: host builds reach servers through SocketClient and SocketTransport.
+ *
+ * @author Angel Velasquez
+ * @date March 22, 2025
+ * @version 0.1
+ */
+
+/*
+ * This file is part of the Modest IoT Nano-framework (C++ Edition).
+ * Copyright (c) 2025 Angel Velasquez
+ *
+ * Licensed under the Creative Commons Attribution-NoDerivatives 4.0 International (CC BY-ND 4.0).
+ * You may use, copy, and distribute this software in its original, unmodified form, provided
+ * you give appropriate credit to the original author (Angel Velasquez) and include this notice.
+ * Modifications, adaptations, or derivative works are not permitted.
+ *
+ * Full license text: https://creativecommons.org/licenses/by-nd/4.0/legalcode
+ */
+
+#include "Arduino.h"
+
+#define WL_IDLE_STATUS 0
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+class WiFiClass
+{
+public:
+    int begin(const char *, const char *) { return WL_CONNECTED; }
+    int status() { return WL_CONNECTED; }
+    bool disconnect() { return true; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
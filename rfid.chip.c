@@ -1,79 +1,706 @@
 #include "wokwi-api.h"
+#include <stdbool.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define RFID_UID_COUNT 5
+/*
+ * MFRC522 (RC522) simulator. Emulates the reader's SPI register interface closely enough for a
+ * stock RC522 driver: register reads and writes (including FIFO bursts), the Idle, Mem, CalcCRC,
+ * Transmit, Receive, Transceive and SoftReset commands, interrupt flags and the IRQ pin, CRC_A,
+ * and the reader's timer timeout when no card answers. Frames sent with Transceive reach a
+ * simulated ISO 14443-A card: REQA/WUPA, cascade level 1 anticollision, SELECT and HLTA.
+ *
+ * Cards come from a population of `tags` UIDs and enter the field one at a time, with
+ * exponentially distributed gaps (mean `arrivalMs`), staying for `dwellMs`. Air time follows the
+ * 106 kbit/s bit rate, so the latency from a card entering the field to its SELECT is what the
+ * firmware's polling loop really achieves. Stats are printed every STATS_INTERVAL_ARRIVALS cards.
+ *
+ * Attributes (diagram.json "attrs" or the chip controls):
+ *   tags       Distinct cards in the population (default 5, max RFID_MAX_TAGS)
+ *   arrivalMs  Mean gap between a card leaving and the next one arriving (default 2000)
+ *   dwellMs    Time a card stays in the field (default 500)
+ *   seed       Seed for arrivals and generated UIDs, so runs are reproducible (default 1)
+ *
+ * Wiring (VSPI): SDA = chip select, SCK, MOSI, MISO, IRQ (active low by default), RST.
+ * Not emulated: MIFARE authentication and memory access, collisions between several cards in
+ * the field, 7- and 10-byte UIDs.
+ */
+
+#define RFID_MAX_TAGS 64
 #define RFID_UID_LENGTH 4
+#define RFID_FIFO_SIZE 64
+#define STATS_INTERVAL_ARRIVALS 50
+
+// Registers (address bits 6..1 of the SPI address byte)
+#define REG_COMMAND 0x01
+#define REG_COM_IEN 0x02
+#define REG_DIV_IEN 0x03
+#define REG_COM_IRQ 0x04
+#define REG_DIV_IRQ 0x05
+#define REG_ERROR 0x06
+#define REG_STATUS1 0x07
+#define REG_STATUS2 0x08
+#define REG_FIFO_DATA 0x09
+#define REG_FIFO_LEVEL 0x0A
+#define REG_CONTROL 0x0C
+#define REG_BIT_FRAMING 0x0D
+#define REG_COLL 0x0E
+#define REG_MODE 0x11
+#define REG_TX_MODE 0x12
+#define REG_RX_MODE 0x13
+#define REG_TX_CONTROL 0x14
+#define REG_CRC_RESULT_H 0x21
+#define REG_CRC_RESULT_L 0x22
+#define REG_T_MODE 0x2A
+#define REG_T_PRESCALER 0x2B
+#define REG_T_RELOAD_H 0x2C
+#define REG_T_RELOAD_L 0x2D
+#define REG_VERSION 0x37
+#define REG_COUNT 0x40
+
+// Reader commands
+#define CMD_IDLE 0x00
+#define CMD_MEM 0x01
+#define CMD_CALC_CRC 0x03
+#define CMD_TRANSMIT 0x04
+#define CMD_RECEIVE 0x08
+#define CMD_TRANSCEIVE 0x0C
+#define CMD_SOFT_RESET 0x0F
+
+// ComIrqReg / DivIrqReg bits
+#define IRQ_TX 0x40
+#define IRQ_RX 0x20
+#define IRQ_IDLE 0x10
+#define IRQ_ERR 0x02
+#define IRQ_TIMER 0x01
+#define DIV_IRQ_CRC 0x04
+
+#define ERR_PROTOCOL 0x01
+#define ERR_CRC 0x04
+#define BIT_FRAMING_START_SEND 0x80
+#define CRC_EN 0x80
+#define VERSION_2_0 0x92
+
+// Card commands
+#define PICC_REQA 0x26
+#define PICC_WUPA 0x52
+#define PICC_SEL_CL1 0x93
+#define PICC_HLTA 0x50
+#define PICC_SAK_MIFARE_1K 0x08
+
+typedef enum
+{
+  TAG_IDLE,
+  TAG_READY,
+  TAG_ACTIVE,
+  TAG_HALT
+} tag_state_t;
+
+typedef struct
+{
+  pin_t cs_pin;
+  pin_t rst_pin;
+  pin_t irq_pin;
+  spi_dev_t spi;
+  uint8_t spi_buffer[1];
+  bool spi_writing;  // An address byte with the write bit was received; the rest are data
+  uint8_t spi_register;
 
-const uint8_t rfid_uids[RFID_UID_COUNT][RFID_UID_LENGTH] = {
+  uint8_t regs[REG_COUNT];
+  uint8_t fifo[RFID_FIFO_SIZE];
+  uint32_t fifo_length;
+  bool busy;         // A frame is on air
+  uint8_t response[RFID_FIFO_SIZE];
+  uint32_t response_length;
+  uint8_t response_last_bits;
+  uint8_t response_error;
+
+  uint8_t uids[RFID_MAX_TAGS][RFID_UID_LENGTH];
+  uint32_t tag_count;
+  uint32_t arrival_ms_attr;
+  uint32_t dwell_ms_attr;
+  uint32_t random_state;
+  int32_t present;   // Card in the field, or -1
+  tag_state_t tag_state;
+  bool selected;     // The present card has been read
+  uint64_t arrived_ns;
+
+  timer_t air_timer;
+  timer_t field_timer;
+
+  uint32_t arrivals;
+  uint32_t reads;
+  uint32_t misses;
+  uint32_t frames;
+  uint64_t latency_sum_us;
+  uint64_t latency_max_us;
+} chip_state_t;
+
+// Legacy UIDs, kept as the first cards of the population
+static const uint8_t default_uids[][RFID_UID_LENGTH] = {
     {0x12, 0x34, 0x56, 0x78},
     {0xAB, 0xCD, 0xEF, 0x01},
     {0x23, 0x45, 0x67, 0x89},
     {0x9A, 0xBC, 0xDE, 0xF0},
     {0x11, 0x22, 0x33, 0x44}};
 
-typedef struct
+static void chip_cs_change(void *user_data, pin_t pin, uint32_t value);
+static void chip_rst_change(void *user_data, pin_t pin, uint32_t value);
+static void chip_spi_done(void *user_data, uint8_t *buffer, uint32_t count);
+static void chip_air_done(void *user_data);
+static void chip_field_event(void *user_data);
+
+static uint32_t next_random(chip_state_t *chip)
 {
-  uint32_t uid_index;
-  pin_t miso_pin; // Almacena el identificador del pin MISO
-  pin_t sck_pin;  // Pin SCK para detectar comunicación SPI
-  pin_t mosi_pin; // Pin MOSI para recibir comandos
-  pin_t sda_pin;  // Pin SDA para selección de chip
-} chip_state_t;
+  uint32_t x = chip->random_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  chip->random_state = x;
+  return x;
+}
 
-static void chip_timer_event(void *user_data);
+// CRC_A (ISO/IEC 14443-3): CRC-16/CCITT reflected, initial value 0x6363
+static uint16_t crc_a(const uint8_t *data, uint32_t length)
+{
+  uint16_t crc = 0x6363;
+  for (uint32_t i = 0; i < length; i++)
+  {
+    uint8_t byte = data[i] ^ (uint8_t)(crc & 0xFF);
+    byte ^= byte << 4;
+    crc = (crc >> 8) ^ ((uint16_t)byte << 8) ^ ((uint16_t)byte << 3) ^ (byte >> 4);
+  }
+  return crc;
+}
 
-void chip_init()
+static void update_irq_pin(chip_state_t *chip)
 {
-  chip_state_t *chip = malloc(sizeof(chip_state_t));
-  memset(chip, 0, sizeof(chip_state_t));
+  bool pending = (chip->regs[REG_COM_IRQ] & chip->regs[REG_COM_IEN] & 0x7F) != 0 ||
+                 (chip->regs[REG_DIV_IRQ] & chip->regs[REG_DIV_IEN] & 0x14) != 0;
+  bool inverted = (chip->regs[REG_COM_IEN] & 0x80) != 0;
+  pin_write(chip->irq_pin, pending != inverted ? HIGH : LOW);
+}
 
-  // Setup SPI pins
-  chip->mosi_pin = pin_init("MOSI", INPUT);
-  chip->miso_pin = pin_init("MISO", OUTPUT); // Inicializa el pin MISO y almacena su identificador
-  chip->sck_pin = pin_init("SCK", INPUT);
-  chip->sda_pin = pin_init("SDA", INPUT_PULLUP);
+static void raise_irq(chip_state_t *chip, uint8_t com_bits, uint8_t div_bits)
+{
+  chip->regs[REG_COM_IRQ] |= com_bits;
+  chip->regs[REG_DIV_IRQ] |= div_bits;
+  update_irq_pin(chip);
+}
 
-  // Setup timer to simulate RFID detection
-  const timer_config_t timer_config = {
-      .callback = chip_timer_event,
-      .user_data = chip};
-  timer_t timer = timer_init(&timer_config);
-  timer_start(timer, 2000000, true); // Trigger every 2 seconds
+static void reset_registers(chip_state_t *chip)
+{
+  timer_stop(chip->air_timer);
+  memset(chip->regs, 0, sizeof(chip->regs));
+  chip->regs[REG_COMMAND] = 0x20;
+  chip->regs[REG_COM_IEN] = 0x80;
+  chip->regs[REG_DIV_IRQ] = 0x00;
+  chip->regs[REG_COM_IRQ] = 0x14;
+  chip->regs[REG_STATUS1] = 0x21;
+  chip->regs[REG_CONTROL] = 0x10;
+  chip->regs[REG_MODE] = 0x3F;
+  chip->regs[REG_TX_CONTROL] = 0x80;
+  chip->regs[REG_CRC_RESULT_H] = 0xFF;
+  chip->regs[REG_CRC_RESULT_L] = 0xFF;
+  chip->regs[REG_VERSION] = VERSION_2_0;
+  chip->fifo_length = 0;
+  chip->busy = false;
+  update_irq_pin(chip);
+}
 
-  chip->uid_index = 0;
-  printf("RFID simulation started.\n");
+static void fifo_push(chip_state_t *chip, uint8_t value)
+{
+  if (chip->fifo_length < RFID_FIFO_SIZE)
+  {
+    chip->fifo[chip->fifo_length++] = value;
+  }
+  else
+  {
+    chip->regs[REG_ERROR] |= 0x10; // BufferOvfl
+  }
 }
 
-static void chip_timer_event(void *user_data)
+static uint8_t fifo_pop(chip_state_t *chip)
 {
-  chip_state_t *chip = (chip_state_t *)user_data;
+  if (chip->fifo_length == 0)
+  {
+    return 0;
+  }
+  uint8_t value = chip->fifo[0];
+  chip->fifo_length--;
+  memmove(chip->fifo, chip->fifo + 1, chip->fifo_length);
+  return value;
+}
 
-  // Simulate SPI communication: Check if SDA is active (chip selected)
-  if (pin_read(chip->sda_pin) == 0)
-  { // SDA active low
-    printf("SPI communication detected.\n");
+// Reader timer period in microseconds: (TReload + 1) * (2 * TPrescaler + 1) / 13.56 MHz
+static uint32_t reader_timeout_us(chip_state_t *chip)
+{
+  uint32_t prescaler = ((chip->regs[REG_T_MODE] & 0x0F) << 8) | chip->regs[REG_T_PRESCALER];
+  uint32_t reload = (chip->regs[REG_T_RELOAD_H] << 8) | chip->regs[REG_T_RELOAD_L];
+  return (uint32_t)(((uint64_t)(reload + 1) * (2 * prescaler + 1) * 100) / 1356);
+}
 
-    // Read command from MOSI
-    uint8_t command = pin_read(chip->mosi_pin);
-    printf("Received command: %02X\n", command);
+// 106 kbit/s: each bit lasts 128 carrier cycles (~9.44 us); a full byte carries a parity bit
+static uint32_t air_time_us(uint32_t bytes, uint8_t last_bits)
+{
+  uint32_t bits = last_bits != 0 ? (bytes - 1) * 9 + last_bits + 1 : bytes * 9;
+  return (bits * 944) / 100;
+}
 
-    // Respond with UID if the command matches
-    if (command == 0x30)
-    { // Example command to request UID
-      const uint8_t *uid = rfid_uids[chip->uid_index];
-      for (int i = 0; i < RFID_UID_LENGTH; i++)
+static void card_answer(chip_state_t *chip, const uint8_t *data, uint32_t length, bool with_crc)
+{
+  memcpy(chip->response, data, length);
+  if (with_crc)
+  {
+    uint16_t crc = crc_a(data, length);
+    chip->response[length++] = crc & 0xFF;
+    chip->response[length++] = crc >> 8;
+  }
+  chip->response_length = length;
+  chip->response_last_bits = 0;
+}
+
+// The simulated card's side of one frame; leaves response_length 0 when the card stays silent
+static void card_exchange(chip_state_t *chip, const uint8_t *frame, uint32_t length, uint8_t last_bits)
+{
+  chip->response_length = 0;
+  if (chip->present < 0 || length == 0)
+  {
+    return;
+  }
+  const uint8_t *uid = chip->uids[chip->present];
+
+  if (length == 1 && last_bits == 7 && (frame[0] == PICC_REQA || frame[0] == PICC_WUPA))
+  {
+    bool wakes = chip->tag_state == TAG_IDLE || (frame[0] == PICC_WUPA && chip->tag_state == TAG_HALT);
+    if (wakes || chip->tag_state == TAG_READY)
+    {
+      static const uint8_t atqa[] = {0x04, 0x00};
+      card_answer(chip, atqa, sizeof(atqa), false);
+      chip->tag_state = TAG_READY;
+    }
+    return;
+  }
+  if (last_bits != 0)
+  {
+    chip->tag_state = chip->tag_state == TAG_HALT ? TAG_HALT : TAG_IDLE;
+    return;
+  }
+
+  if (frame[0] == PICC_SEL_CL1 && length == 2 && frame[1] == 0x20 && chip->tag_state == TAG_READY)
+  {
+    uint8_t answer[RFID_UID_LENGTH + 1];
+    memcpy(answer, uid, RFID_UID_LENGTH);
+    answer[RFID_UID_LENGTH] = uid[0] ^ uid[1] ^ uid[2] ^ uid[3];
+    card_answer(chip, answer, sizeof(answer), false);
+    return;
+  }
+
+  bool crc_ok = length >= 3 && crc_a(frame, length - 2) == (frame[length - 2] | (frame[length - 1] << 8));
+  if (frame[0] == PICC_SEL_CL1 && length == 9 && frame[1] == 0x70 && chip->tag_state == TAG_READY)
+  {
+    if (crc_ok && memcmp(frame + 2, uid, RFID_UID_LENGTH) == 0)
+    {
+      uint8_t sak = PICC_SAK_MIFARE_1K;
+      card_answer(chip, &sak, 1, true);
+      chip->tag_state = TAG_ACTIVE;
+      if (!chip->selected)
       {
-        pin_write(chip->miso_pin, uid[i]); // Send UID byte-by-byte
-        printf("Sent byte %02X to MISO\n", uid[i]);
+        uint64_t latency_us = (get_sim_nanos() - chip->arrived_ns) / 1000;
+        chip->selected = true;
+        chip->reads++;
+        chip->latency_sum_us += latency_us;
+        if (latency_us > chip->latency_max_us)
+        {
+          chip->latency_max_us = latency_us;
+        }
       }
-      chip->uid_index = (chip->uid_index + 1) % RFID_UID_COUNT; // Cycle through UIDs
-      printf("RFID UID sent: %02X %02X %02X %02X\n", uid[0], uid[1], uid[2], uid[3]);
+    }
+    return;
+  }
+  if (frame[0] == PICC_HLTA && length == 4 && frame[1] == 0x00 && crc_ok && chip->tag_state == TAG_ACTIVE)
+  {
+    chip->tag_state = TAG_HALT;
+    return;
+  }
+
+  // Anything else (MIFARE authentication, block access, malformed frames) is not answered
+  if (chip->tag_state != TAG_HALT)
+  {
+    chip->tag_state = TAG_IDLE;
+  }
+}
+
+static void start_transceive(chip_state_t *chip)
+{
+  uint8_t frame[RFID_FIFO_SIZE + 2];
+  uint32_t length = chip->fifo_length;
+  uint8_t last_bits = chip->regs[REG_BIT_FRAMING] & 0x07;
+  memcpy(frame, chip->fifo, length);
+  chip->fifo_length = 0;
+  if ((chip->regs[REG_TX_MODE] & CRC_EN) != 0 && last_bits == 0)
+  {
+    uint16_t crc = crc_a(frame, length);
+    frame[length++] = crc & 0xFF;
+    frame[length++] = crc >> 8;
+  }
+  chip->frames++;
+
+  // The card only hears the reader when the antenna drivers (TX1, TX2) are on
+  if ((chip->regs[REG_TX_CONTROL] & 0x03) != 0)
+  {
+    card_exchange(chip, frame, length, last_bits);
+  }
+  else
+  {
+    chip->response_length = 0;
+  }
+
+  chip->response_error = 0;
+  if (chip->response_length > 0 && (chip->regs[REG_RX_MODE] & CRC_EN) != 0)
+  {
+    if (chip->response_length < 3 ||
+        crc_a(chip->response, chip->response_length - 2) !=
+            (chip->response[chip->response_length - 2] | (chip->response[chip->response_length - 1] << 8)))
+    {
+      chip->response_error = ERR_CRC;
+    }
+    else
+    {
+      chip->response_length -= 2;
+    }
+  }
+
+  uint32_t duration_us = air_time_us(length, last_bits);
+  if (chip->response_length > 0)
+  {
+    duration_us += 86 + air_time_us(chip->response_length, chip->response_last_bits); // FDT + reply
+  }
+  else
+  {
+    duration_us += reader_timeout_us(chip);
+  }
+  chip->busy = true;
+  raise_irq(chip, IRQ_TX, 0);
+  timer_start(chip->air_timer, duration_us > 0 ? duration_us : 1, false);
+}
+
+static void chip_air_done(void *user_data)
+{
+  chip_state_t *chip = (chip_state_t *)user_data;
+  chip->busy = false;
+  chip->regs[REG_BIT_FRAMING] &= ~BIT_FRAMING_START_SEND;
+  if (chip->response_length == 0)
+  {
+    raise_irq(chip, IRQ_TIMER, 0);
+    return;
+  }
+  for (uint32_t i = 0; i < chip->response_length; i++)
+  {
+    fifo_push(chip, chip->response[i]);
+  }
+  chip->regs[REG_CONTROL] = (chip->regs[REG_CONTROL] & ~0x07) | chip->response_last_bits;
+  chip->regs[REG_ERROR] |= chip->response_error;
+  raise_irq(chip, IRQ_RX | (chip->response_error != 0 ? IRQ_ERR : 0), 0);
+}
+
+static void execute_command(chip_state_t *chip, uint8_t value)
+{
+  uint8_t command = value & 0x0F;
+  chip->regs[REG_COMMAND] = value & 0x3F;
+  switch (command)
+  {
+  case CMD_IDLE:
+    timer_stop(chip->air_timer);
+    chip->busy = false;
+    break;
+  case CMD_SOFT_RESET:
+    reset_registers(chip);
+    return;
+  case CMD_CALC_CRC:
+  {
+    uint16_t crc = crc_a(chip->fifo, chip->fifo_length);
+    chip->fifo_length = 0;
+    chip->regs[REG_CRC_RESULT_L] = crc & 0xFF;
+    chip->regs[REG_CRC_RESULT_H] = crc >> 8;
+    raise_irq(chip, 0, DIV_IRQ_CRC);
+    break;
+  }
+  case CMD_TRANSMIT:
+    chip->fifo_length = 0;
+    chip->regs[REG_COMMAND] &= ~0x0F;
+    raise_irq(chip, IRQ_TX | IRQ_IDLE, 0);
+    break;
+  case CMD_TRANSCEIVE:
+    if ((chip->regs[REG_BIT_FRAMING] & BIT_FRAMING_START_SEND) != 0 && !chip->busy)
+    {
+      start_transceive(chip);
+    }
+    break;
+  case CMD_MEM:
+  case CMD_RECEIVE:
+    // Nothing to receive without a preceding frame; finish at once
+    chip->regs[REG_COMMAND] &= ~0x0F;
+    raise_irq(chip, IRQ_IDLE, 0);
+    break;
+  default:
+    // MFAuthent and the rest are not emulated
+    chip->regs[REG_ERROR] |= ERR_PROTOCOL;
+    chip->regs[REG_COMMAND] &= ~0x0F;
+    raise_irq(chip, IRQ_ERR | IRQ_IDLE, 0);
+    break;
+  }
+}
+
+static uint8_t read_register(chip_state_t *chip, uint8_t reg)
+{
+  switch (reg)
+  {
+  case REG_FIFO_DATA:
+    return fifo_pop(chip);
+  case REG_FIFO_LEVEL:
+    return (uint8_t)chip->fifo_length;
+  case REG_STATUS1:
+  {
+    bool irq = (chip->regs[REG_COM_IRQ] & chip->regs[REG_COM_IEN] & 0x7F) != 0 ||
+               (chip->regs[REG_DIV_IRQ] & chip->regs[REG_DIV_IEN] & 0x14) != 0;
+    return 0x21 | (irq ? 0x10 : 0x00) | (chip->busy ? 0x08 : 0x00); // CRCReady, CRCOk
+  }
+  case REG_COLL:
+    return chip->regs[REG_COLL] | 0x20; // CollPosNotValid: there are never collisions
+  default:
+    return chip->regs[reg];
+  }
+}
+
+static void write_register(chip_state_t *chip, uint8_t reg, uint8_t value)
+{
+  switch (reg)
+  {
+  case REG_COMMAND:
+    execute_command(chip, value);
+    break;
+  case REG_COM_IRQ:
+  case REG_DIV_IRQ:
+    // Bit 7 (Set1/Set2) selects whether the marked bits are set or cleared
+    if ((value & 0x80) != 0)
+    {
+      chip->regs[reg] |= value & 0x7F;
     }
     else
     {
-      printf("Unknown command received: %02X\n", command);
+      chip->regs[reg] &= ~value;
+    }
+    update_irq_pin(chip);
+    break;
+  case REG_COM_IEN:
+  case REG_DIV_IEN:
+    chip->regs[reg] = value;
+    update_irq_pin(chip);
+    break;
+  case REG_FIFO_DATA:
+    fifo_push(chip, value);
+    break;
+  case REG_FIFO_LEVEL:
+    if ((value & 0x80) != 0)
+    {
+      chip->fifo_length = 0;
+      chip->regs[REG_ERROR] &= ~0x10;
+    }
+    break;
+  case REG_BIT_FRAMING:
+    chip->regs[reg] = value;
+    if ((value & BIT_FRAMING_START_SEND) != 0 && (chip->regs[REG_COMMAND] & 0x0F) == CMD_TRANSCEIVE &&
+        !chip->busy)
+    {
+      chip->regs[REG_ERROR] = 0;
+      start_transceive(chip);
     }
+    break;
+  case REG_ERROR:
+  case REG_STATUS1:
+  case REG_VERSION:
+  case REG_CRC_RESULT_H:
+  case REG_CRC_RESULT_L:
+    break; // Read-only
+  default:
+    chip->regs[reg] = value;
+    break;
+  }
+}
+
+// One SPI byte: the address byte's bit 7 selects read (1) or write (0), bits 6..1 the register.
+// A read's value is shifted out during the following byte; a write's data bytes follow its address.
+static void chip_spi_done(void *user_data, uint8_t *buffer, uint32_t count)
+{
+  chip_state_t *chip = (chip_state_t *)user_data;
+  if (count == 0)
+  {
+    return;
+  }
+  uint8_t received = buffer[0];
+  uint8_t reply = 0x00;
+  if (chip->spi_writing)
+  {
+    write_register(chip, chip->spi_register, received);
+  }
+  else if ((received & 0x80) != 0)
+  {
+    reply = read_register(chip, (received >> 1) & 0x3F);
+  }
+  else
+  {
+    chip->spi_writing = true;
+    chip->spi_register = (received >> 1) & 0x3F;
+  }
+  buffer[0] = reply;
+  if (pin_read(chip->cs_pin) == LOW)
+  {
+    spi_start(chip->spi, chip->spi_buffer, 1);
+  }
+}
+
+static void chip_cs_change(void *user_data, pin_t pin, uint32_t value)
+{
+  chip_state_t *chip = (chip_state_t *)user_data;
+  if (value == LOW)
+  {
+    chip->spi_writing = false;
+    chip->spi_buffer[0] = 0x00;
+    spi_start(chip->spi, chip->spi_buffer, 1);
+  }
+  else
+  {
+    spi_stop(chip->spi);
+  }
+}
+
+static void chip_rst_change(void *user_data, pin_t pin, uint32_t value)
+{
+  chip_state_t *chip = (chip_state_t *)user_data;
+  if (value == HIGH)
+  {
+    reset_registers(chip); // Leaving hard power-down
   }
-}
\ No newline at end of file
+}
+
+static void print_stats(chip_state_t *chip)
+{
+  printf("RC522: %u cards, %u read, %u missed, %u frames, read latency avg %u us max %u us\n",
+         chip->arrivals, chip->reads, chip->misses, chip->frames,
+         chip->reads > 0 ? (uint32_t)(chip->latency_sum_us / chip->reads) : 0,
+         (uint32_t)chip->latency_max_us);
+}
+
+// Alternates between a card entering the field and leaving it
+static void chip_field_event(void *user_data)
+{
+  chip_state_t *chip = (chip_state_t *)user_data;
+  if (chip->present >= 0)
+  {
+    if (!chip->selected)
+    {
+      chip->misses++;
+    }
+    chip->present = -1;
+    if (chip->arrivals % STATS_INTERVAL_ARRIVALS == 0)
+    {
+      print_stats(chip);
+    }
+    // Exponential gap: -mean * ln(U), U in (0, 1]
+    double uniform = (next_random(chip) % 1000000 + 1) / 1000000.0;
+    double gap_ms = -log(uniform) * attr_read(chip->arrival_ms_attr);
+    timer_start(chip->field_timer, (uint32_t)(gap_ms * 1000) + 1, false);
+    return;
+  }
+
+  chip->present = (int32_t)(next_random(chip) % chip->tag_count);
+  chip->tag_state = TAG_IDLE;
+  chip->selected = false;
+  chip->arrived_ns = get_sim_nanos();
+  chip->arrivals++;
+  uint32_t dwell_ms = attr_read(chip->dwell_ms_attr);
+  timer_start(chip->field_timer, (dwell_ms > 0 ? dwell_ms : 1) * 1000, false);
+}
+
+void chip_init()
+{
+  chip_state_t *chip = malloc(sizeof(chip_state_t));
+  memset(chip, 0, sizeof(chip_state_t));
+  chip->present = -1;
+
+  chip->tag_count = attr_read(attr_init("tags", 5));
+  chip->arrival_ms_attr = attr_init("arrivalMs", 2000);
+  chip->dwell_ms_attr = attr_init("dwellMs", 500);
+  chip->random_state = attr_read(attr_init("seed", 1));
+  if (chip->random_state == 0)
+  {
+    chip->random_state = 1;
+  }
+  if (chip->tag_count == 0)
+  {
+    chip->tag_count = 1;
+  }
+  if (chip->tag_count > RFID_MAX_TAGS)
+  {
+    chip->tag_count = RFID_MAX_TAGS;
+  }
+  uint32_t default_count = sizeof(default_uids) / sizeof(default_uids[0]);
+  for (uint32_t i = 0; i < chip->tag_count; i++)
+  {
+    if (i < default_count)
+    {
+      memcpy(chip->uids[i], default_uids[i], RFID_UID_LENGTH);
+      continue;
+    }
+    uint32_t value = next_random(chip);
+    for (int b = 0; b < RFID_UID_LENGTH; b++)
+    {
+      chip->uids[i][b] = (uint8_t)(value >> (8 * b));
+    }
+    if (chip->uids[i][0] == 0x88)
+    {
+      chip->uids[i][0] = 0x08; // 0x88 is the cascade tag, never a UID's first byte
+    }
+  }
+
+  chip->cs_pin = pin_init("SDA", INPUT_PULLUP);
+  chip->rst_pin = pin_init("RST", INPUT_PULLUP);
+  chip->irq_pin = pin_init("IRQ", OUTPUT_HIGH);
+
+  const spi_config_t spi_config = {
+      .sck = pin_init("SCK", INPUT),
+      .mosi = pin_init("MOSI", INPUT),
+      .miso = pin_init("MISO", OUTPUT),
+      .mode = 0,
+      .done = chip_spi_done,
+      .user_data = chip};
+  chip->spi = spi_init(&spi_config);
+
+  const pin_watch_config_t cs_watch = {
+      .edge = BOTH,
+      .pin_change = chip_cs_change,
+      .user_data = chip};
+  pin_watch(chip->cs_pin, &cs_watch);
+  const pin_watch_config_t rst_watch = {
+      .edge = RISING,
+      .pin_change = chip_rst_change,
+      .user_data = chip};
+  pin_watch(chip->rst_pin, &rst_watch);
+
+  const timer_config_t air_config = {
+      .callback = chip_air_done,
+      .user_data = chip};
+  chip->air_timer = timer_init(&air_config);
+  const timer_config_t field_config = {
+      .callback = chip_field_event,
+      .user_data = chip};
+  chip->field_timer = timer_init(&field_config);
+
+  reset_registers(chip);
+  timer_start(chip->field_timer, attr_read(chip->arrival_ms_attr) * 1000 + 1, false);
+  printf("RC522 simulation started: %u cards, mean arrival gap %u ms, dwell %u ms.\n",
+         chip->tag_count, attr_read(chip->arrival_ms_attr), attr_read(chip->dwell_ms_attr));
+}
@@ -12,12 +12,18 @@
  */
 
 #include "chips/ModestIoT.h"
+#ifdef MODESTIOT_MQTT
+#include <WiFi.h>
+#endif
 
 // Pin definitions
 #define GPS_RX_PIN 16
 #define GPS_TX_PIN 17
 #define RFID_PIN 21
+#define RFID_SS_PIN 5   // RC522 SDA (chip select) on VSPI
+#define RFID_RST_PIN 22 // RC522 RST
 #define STATUS_LED_PIN 2
+#define BUTTON_PIN 4
 
 // Network configuration
 #define WIFI_SSID "Wokwi-GUEST"
@@ -28,19 +34,67 @@
 #define TRACKING_ENDPOINT "http://host.wokwi.internal:5000/api/v1/tracking"
 #define RFID_ENDPOINT "http://host.wokwi.internal:5000/api/v1/sensor-scans/create"
 
+// MQTT broker, used instead of HTTP POST when MODESTIOT_MQTT is defined
+#define MQTT_BROKER_HOST "host.wokwi.internal"
+#define MQTT_BROKER_PORT 1883
+
 // Global tracking device instance
 TrackingDevice *trackingDevice;
 
+/**
+ * @brief Console actions on the push button: a press prints the metrics, a double press dumps the
+ * phase trace and a long press prints the deadline overruns kept across resets.
+ */
+class ConsoleButtonHandler : public EventHandler
+{
+public:
+  void on(Event event) override
+  {
+    if (event.id == Button::BUTTON_PRESSED_EVENT_ID)
+    {
+      trackingDevice->printMetrics();
+    }
+    else if (event.id == Button::BUTTON_DOUBLE_PRESS_EVENT_ID)
+    {
+      Tracer::dumpChromeTrace(Serial);
+    }
+    else if (event.id == Button::BUTTON_LONG_PRESS_EVENT_ID)
+    {
+      trackingDevice->getDeadlineMonitor().printPostMortem(Serial);
+    }
+  }
+};
+
+ConsoleButtonHandler consoleButtonHandler;
+Button *consoleButton;
+
 void setup()
 {
   Serial.begin(115200);
   Serial.println("=== ModestIoT Tracking Device ===");
 
+  // Print log records from a low-priority task instead of blocking the callers on the UART
+  Logger::start(Serial);
+
   // Initialize random seed
   randomSeed(analogRead(0));
 
-  // Create tracking device with all configuration
-  trackingDevice = new TrackingDevice(
+#ifdef MODESTIOT_BENCHMARK
+  // Measure framework hot paths before the device starts
+  FrameworkBenchmark::runAll(Serial);
+#endif
+
+#ifdef MODESTIOT_MQTT
+  // Publish over one persistent MQTT session with pipelined QoS 1 acknowledgements
+  static WiFiClient mqttClient;
+  static MqttTransport uplink(mqttClient, MQTT_BROKER_HOST, MQTT_BROKER_PORT, DEVICE_ID);
+  Transport *uplinkTransport = &uplink;
+#else
+  Transport *uplinkTransport = nullptr; // HTTP POST
+#endif
+
+  // Create tracking device with all configuration (static storage, no heap)
+  static TrackingDevice device(
       GPS_RX_PIN, GPS_TX_PIN, // GPS pins
       RFID_PIN,               // RFID pin
       STATUS_LED_PIN,         // Status LED pin
@@ -48,20 +102,59 @@ void setup()
       WIFI_PASSWORD,
       TRACKING_ENDPOINT, // Server endpoints
       RFID_ENDPOINT,
-      DEVICE_ID // Device identifier
+      DEVICE_ID,                    // Device identifier
+      SystemClock::instance(),      // Time source
+      uplinkTransport               // Uplink (nullptr: HTTP POST)
   );
+  trackingDevice = &device;
+
+  // Defer GPS uploads and skip LED pulses while the tasks run behind schedule
+  trackingDevice->getDeadlineMonitor().setLoadShedding(true);
 
   // Initialize the device
   trackingDevice->initialize();
 
+#ifdef MODESTIOT_MQTT
+  uplink.registerMetrics(trackingDevice->getMetrics());
+#endif
+
+  // Read cards from the RC522 when one answers; otherwise keep the simulated scans.
+  // Cards missing from the allowlist are uploaded flagged as denied (see ALLOW_RFID_CODE)
+  static Rc522Reader rfidReader(RFID_SS_PIN, RFID_RST_PIN);
+  if (rfidReader.begin())
+  {
+    rfidReader.registerMetrics(trackingDevice->getMetrics());
+    trackingDevice->getRfidSensor()->setReader(&rfidReader);
+  }
+
+  // Capture button edges in an interrupt; gestures are recognized one debounce window later
+  static Button button(BUTTON_PIN, &consoleButtonHandler);
+  consoleButton = &button;
+  consoleButton->begin();
+  consoleButton->registerMetrics(trackingDevice->getMetrics());
+
+  // Run sensor ingestion and networking as separate tasks on the two cores
+  trackingDevice->start();
+
   Serial.println("=== Setup Complete ===");
 }
 
 void loop()
 {
-  // Update the tracking device (handles all sensors and communication)
-  trackingDevice->update();
+  // All work happens in the device's ingest and network tasks.
+  // Send 't' over the serial console to dump the phase trace as Chrome trace_event JSON,
+  // or 'p' to print the deadline overruns kept across resets (the push button does the same).
+  int request = Serial.available() > 0 ? Serial.read() : -1;
+  if (request == 't')
+  {
+    Tracer::dumpChromeTrace(Serial);
+  }
+  else if (request == 'p')
+  {
+    trackingDevice->getDeadlineMonitor().printPostMortem(Serial);
+  }
 
-  // Small delay to prevent overwhelming the system
-  delay(100);
+  // Sleep until a button gesture is recognized instead of a fixed delay
+  consoleButton->wait(100);
+  consoleButton->update();
 }
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Turns a binary log capture from the device back into text lines.
+
+Usage: log_decode.py [capture.bin]    (reads standard input without a file)
+
+With Logger::setBinary(true) the drain task writes each record as a frame instead of a rendered
+line (see chips/Log.h). Every frame starts with 0xA5, which never appears in ASCII, so anything
+else in the capture (boot messages, metrics reports) is passed through unchanged:
+
+  0xA5 'F' id len text             announces format `id`, sent once before its first record
+  0xA5 'R' id level time(u32) argc kinds arg...
+                                   a record; kinds holds two bits per argument (0 int, 1 unsigned,
+                                   2 float, 3 string); numbers are 4 bytes little-endian, strings
+                                   a length byte and the characters
+
+Output lines match the text mode: "<millis> <level letter> <message>".
+"""
+
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+LEVELS = "-EWID"
+SPEC = re.compile(r"%([-+ #0-9.]*)[lhz]*([diuxXcsfeg%])")
+
+
+def render(fmt, args):
+    """Applies the printf conversions of a device format to the captured arguments."""
+    values = iter(args)
+
+    def convert(match):
+        flags, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        value = next(values, None)
+        if value is None:
+            return "?"
+        if conversion in "di":
+            return ("%" + flags + "d") % (value if isinstance(value, (int, float)) else 0)
+        if conversion == "c":
+            return chr(value) if isinstance(value, int) else "?"
+        if conversion == "s":
+            return ("%" + flags + "s") % value
+        if conversion in "feg":
+            return ("%" + flags + conversion) % float(value) if not isinstance(value, str) else "?"
+        return ("%" + flags + ("u" if conversion == "u" else conversion)) % (value if isinstance(value, int) else 0)
+
+    return SPEC.sub(convert, fmt)
+
+
+def decode(data, out):
+    formats = {}
+    text = bytearray()
+    i = 0
+    while i < len(data):
+        if data[i] != SYNC:
+            text.append(data[i])
+            i += 1
+            continue
+        out.write(text.decode("utf-8", "replace"))
+        text.clear()
+        try:
+            kind = data[i + 1]
+            if kind == ord("F"):
+                fid, length = data[i + 2], data[i + 3]
+                formats[fid] = data[i + 4:i + 4 + length].decode("utf-8", "replace")
+                i += 4 + length
+            elif kind == ord("R"):
+                fid, level = data[i + 2], data[i + 3]
+                (millis,) = struct.unpack_from("<I", data, i + 4)
+                argc, kinds = data[i + 8], data[i + 9]
+                i += 10
+                args = []
+                for n in range(argc):
+                    arg_kind = (kinds >> (2 * n)) & 0x3
+                    if arg_kind == 3:
+                        length = data[i]
+                        args.append(data[i + 1:i + 1 + length].decode("utf-8", "replace"))
+                        i += 1 + length
+                    else:
+                        fmt = {0: "<i", 1: "<I", 2: "<f"}[arg_kind]
+                        (value,) = struct.unpack_from(fmt, data, i)
+                        args.append(value)
+                        i += 4
+                message = render(formats.get(fid, "<format %d?>" % fid), args)
+                letter = LEVELS[level] if level < len(LEVELS) else "?"
+                out.write("%d %s %s\n" % (millis, letter, message))
+            else:
+                i += 1
+        except (IndexError, struct.error):
+            break  # capture ends inside a frame
+    out.write(text.decode("utf-8", "replace"))
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], "rb") as capture:
+            data = capture.read()
+    else:
+        data = sys.stdin.buffer.read()
+    decode(data, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,280 @@
+#!/usr/bin/env python3
+"""Local stand-in for the tracking and sensor-scan ingestion endpoints.
+
+Usage: mock_server.py [--port 5000] [--latency exp:40] [--error-rate 0.05] ...
+
+Serves POST /api/v1/tracking and POST /api/v1/sensor-scans/create like the staging server, and
+GET /stats with the counters collected so far. Every accepted payload can be appended to a JSON
+lines file (--record), together with the X-Device-Metrics header the device piggybacks.
+
+Faults are drawn per request from a seeded generator, so a run is reproducible:
+  --latency SPEC       delay before answering: const:MS, uniform:LO:HI, normal:MEAN:SD, exp:MEAN
+  --error-rate P       answer with --error-status (default 503) instead of 201
+  --reset-rate P       drop the connection with a TCP reset instead of answering
+  --slow-read-rate P   read the request body at --slow-read-bps bytes per second
+
+Downlink commands ride on the 201 replies as a "cmd" member ("30=5000;31" sets the GPS
+interval and flushes the device's queue). Start with --command TEXT, or change them while devices
+are running with PUT /command (an empty body stops sending commands):
+  curl -X PUT --data '30=30000' http://localhost:5000/command
+
+Bodies sent with Content-Encoding: deflate (zlib) are inflated before parsing; GPS batches arrive
+as JSON arrays and count one accepted request each.
+
+Point the sketch (or a FleetSimulator with useSockets) at http://<host>:<port>/api/v1/...; from
+Wokwi the host is reachable as host.wokwi.internal.
+"""
+
+import argparse
+import json
+import random
+import socket
+import struct
+import sys
+import threading
+import time
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ENDPOINTS = {
+    "/api/v1/tracking": "tracking",
+    "/api/v1/sensor-scans/create": "sensor-scans",
+}
+
+
+def parse_latency(spec):
+    """Turns a latency spec into a function returning milliseconds."""
+    kind, _, args = spec.partition(":")
+    values = [float(value) for value in args.split(":")] if args else []
+    shapes = {
+        "const": (1, lambda rng, ms: ms),
+        "uniform": (2, lambda rng, lo, hi: rng.uniform(lo, hi)),
+        "normal": (2, lambda rng, mean, sd: max(0.0, rng.gauss(mean, sd))),
+        "exp": (1, lambda rng, mean: rng.expovariate(1.0 / mean) if mean > 0 else 0.0),
+    }
+    if kind not in shapes or len(values) != shapes[kind][0]:
+        raise argparse.ArgumentTypeError(
+            "latency must be const:MS, uniform:LO:HI, normal:MEAN:SD or exp:MEAN")
+    draw = shapes[kind][1]
+    return lambda rng: draw(rng, *values)
+
+
+def parse_rate(text):
+    rate = float(text)
+    if not 0.0 <= rate <= 1.0:
+        raise argparse.ArgumentTypeError("rates are probabilities between 0 and 1")
+    return rate
+
+
+class Stats:
+    """Counters shared by the handler threads."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.started = time.time()
+        self.counts = {"requests": 0, "accepted": 0, "errors": 0, "resets": 0,
+                       "slow_reads": 0, "bytes": 0, "not_found": 0, "commands": 0,
+                       "records": 0, "compressed": 0, "inflated_bytes": 0}
+        self.per_endpoint = {name: 0 for name in ENDPOINTS.values()}
+
+    def add(self, key, amount=1):
+        with self.lock:
+            self.counts[key] += amount
+
+    def accepted(self, endpoint, size, records):
+        with self.lock:
+            self.counts["accepted"] += 1
+            self.counts["bytes"] += size
+            self.counts["records"] += records
+            self.per_endpoint[endpoint] += 1
+
+    def snapshot(self):
+        with self.lock:
+            uptime = time.time() - self.started
+            return dict(self.counts, endpoints=dict(self.per_endpoint),
+                        uptime_s=round(uptime, 1),
+                        accepted_per_s=round(self.counts["accepted"] / uptime, 1) if uptime else 0.0)
+
+
+class IngestServer(ThreadingHTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+    def __init__(self, address, options):
+        super().__init__(address, IngestHandler)
+        self.options = options
+        self.stats = Stats()
+        self.rng = random.Random(options.seed)
+        self.rng_lock = threading.Lock()
+        self.record_lock = threading.Lock()
+        self.record = open(options.record, "a", encoding="utf-8") if options.record else None
+        self.command = options.command
+
+    def draw_faults(self):
+        """Draws every fault decision for one request under one lock, keeping runs reproducible."""
+        options = self.options
+        with self.rng_lock:
+            return {
+                "reset": self.rng.random() < options.reset_rate,
+                "slow": self.rng.random() < options.slow_read_rate,
+                "error": self.rng.random() < options.error_rate,
+                "latency_ms": options.latency(self.rng) if options.latency else 0.0,
+            }
+
+    def write_record(self, entry):
+        if self.record is None:
+            return
+        with self.record_lock:
+            self.record.write(json.dumps(entry, separators=(",", ":")) + "\n")
+            self.record.flush()
+
+
+class IngestHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    server_version = "ModestIoTMock/0.1"
+
+    def log_message(self, format, *args):
+        if self.server.options.verbose:
+            super().log_message(format, *args)
+
+    def send_json(self, status, body):
+        data = json.dumps(body).encode("utf-8")
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def read_body(self, length, slow):
+        if not slow:
+            return self.rfile.read(length)
+        # Drain the socket at a fixed rate so the client's send path backs up
+        bps = max(1, self.server.options.slow_read_bps)
+        chunk = max(1, bps // 10)
+        body = b""
+        while len(body) < length:
+            part = self.rfile.read(min(chunk, length - len(body)))
+            if not part:
+                break
+            body += part
+            time.sleep(len(part) / bps)
+        return body
+
+    def reset_connection(self):
+        # SO_LINGER with a zero timeout makes close() send RST instead of FIN
+        self.connection.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+        self.close_connection = True
+        self.connection.close()
+
+    def do_GET(self):
+        if self.path == "/stats":
+            self.send_json(200, self.server.stats.snapshot())
+        else:
+            self.server.stats.add("not_found")
+            self.send_json(404, {"error": "not found"})
+
+    def do_PUT(self):
+        if self.path != "/command":
+            self.send_json(404, {"error": "not found"})
+            return
+        length = int(self.headers.get("Content-Length", 0))
+        self.server.command = self.rfile.read(length).decode("utf-8").strip()
+        self.send_json(200, {"command": self.server.command})
+
+    def do_POST(self):
+        server = self.server
+        server.stats.add("requests")
+        endpoint = ENDPOINTS.get(self.path.split("?", 1)[0])
+        length = int(self.headers.get("Content-Length", 0))
+        faults = server.draw_faults()
+
+        if faults["reset"]:
+            server.stats.add("resets")
+            self.reset_connection()
+            return
+        if faults["slow"]:
+            server.stats.add("slow_reads")
+        body = self.read_body(length, faults["slow"])
+        if faults["latency_ms"] > 0:
+            time.sleep(faults["latency_ms"] / 1000.0)
+
+        if endpoint is None:
+            server.stats.add("not_found")
+            self.send_json(404, {"error": "not found"})
+            return
+        if faults["error"]:
+            server.stats.add("errors")
+            self.send_json(server.options.error_status, {"error": "injected"})
+            return
+
+        size = len(body)
+        try:
+            if self.headers.get("Content-Encoding", "").lower() == "deflate":
+                body = zlib.decompress(body)
+                server.stats.add("compressed")
+                server.stats.add("inflated_bytes", len(body))
+            payload = json.loads(body.decode("utf-8"))
+        except (zlib.error, UnicodeDecodeError, ValueError):
+            payload = None
+        if payload is None:
+            server.stats.add("errors")
+            self.send_json(400, {"error": "invalid JSON"})
+            return
+
+        server.stats.accepted(endpoint, size, len(payload) if isinstance(payload, list) else 1)
+        server.write_record({
+            "t": round(time.time(), 3),
+            "endpoint": endpoint,
+            "client": self.client_address[0],
+            "metrics": self.headers.get("X-Device-Metrics"),
+            "payload": payload,
+        })
+        reply = {"status": "created", "endpoint": endpoint}
+        if server.command:
+            reply["cmd"] = server.command
+            server.stats.add("commands")
+        self.send_json(201, reply)
+
+
+def report_periodically(server, interval):
+    while True:
+        time.sleep(interval)
+        print(json.dumps({"mock": server.stats.snapshot()}), flush=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=5000)
+    parser.add_argument("--latency", type=parse_latency, default=None)
+    parser.add_argument("--error-rate", type=parse_rate, default=0.0)
+    parser.add_argument("--error-status", type=int, default=503)
+    parser.add_argument("--reset-rate", type=parse_rate, default=0.0)
+    parser.add_argument("--slow-read-rate", type=parse_rate, default=0.0)
+    parser.add_argument("--slow-read-bps", type=int, default=256)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--command", default="",
+                        help="downlink commands added to every 201 reply, e.g. '30=5000;31'")
+    parser.add_argument("--record", metavar="FILE", help="append accepted payloads as JSON lines")
+    parser.add_argument("--stats-interval", type=float, default=10.0,
+                        help="seconds between stats lines (0 disables)")
+    parser.add_argument("--verbose", action="store_true", help="log every request")
+    options = parser.parse_args()
+
+    server = IngestServer((options.host, options.port), options)
+    if options.stats_interval > 0:
+        threading.Thread(target=report_periodically, args=(server, options.stats_interval),
+                         daemon=True).start()
+    print("mock ingestion server on http://%s:%d" % (options.host, options.port), file=sys.stderr)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print(json.dumps({"mock": server.stats.snapshot()}), flush=True)
+        if server.record is not None:
+            server.record.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,29 @@
+#!/usr/bin/env python3
+"""Converts an NMEA log into a header the GPS chip simulator can replay.
+
+Usage: nmea2chip.py route.nmea > route.h
+Then build gps-neo6m.chip.c with -DGPS_NMEA_LOG='"route.h"'.
+
+Lines that do not start with '$' are skipped; every sentence is emitted with a CR LF ending.
+"""
+
+import sys
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: nmea2chip.py <log.nmea>")
+    with open(sys.argv[1], encoding="ascii", errors="replace") as log:
+        sentences = [line.strip() for line in log if line.startswith("$")]
+    if not sentences:
+        sys.exit("no NMEA sentences found in " + sys.argv[1])
+    print("// Generated by tools/nmea2chip.py from " + sys.argv[1])
+    print("static const char nmea_log[] =")
+    for sentence in sentences:
+        escaped = sentence.replace("\\", "\\\\").replace('"', '\\"')
+        print('    "' + escaped + '\\r\\n"')
+    print("    ;")
+
+
+if __name__ == "__main__":
+    main()